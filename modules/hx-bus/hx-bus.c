@@ -0,0 +1,481 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/sys/slist.h>
+
+#include "hx-bus.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(hxbus, CONFIG_HXBUS_LOG_LEVEL);
+
+#define HXBUS_NODE DT_CHOSEN(loouq_hx_bus)
+
+struct syncWait                                                                 // blocking caller waiting on a queued transaction
+{
+    struct k_sem done;
+    int result;
+};
+
+static const struct device *const hxbus_i2c = DEVICE_DT_GET(HXBUS_NODE);
+static struct k_spinlock hxbus_lock;                                            // guards queues and statistics
+static sys_slist_t hxbus_queue[HXBUS_PRIO_COUNT];                               // deadline ordered, one per priority
+static K_SEM_DEFINE(hxbus_pending, 0, 1);
+static hxbus_stats_t hxbus_stats;
+static uint32_t hxbus_windowStart;                                              // cycle count at start of statistics window
+static uint8_t hxbus_txBuf[1 + CONFIG_HXBUS_WRITE_MAX];                         // register address + (merged) write data, bus thread only
+static const struct device *hxbus_segment;                                      // segment bus of the last segment transaction, bus thread only
+static uint8_t hxbus_segmentRun;                                                // consecutive transactions run ahead of the queue head
+K_THREAD_STACK_DEFINE(hxbus_stack, CONFIG_HXBUS_THREAD_STACK_SIZE);
+static struct k_thread hxbus_thread;
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static void hxbus_run(void *p1, void *p2, void *p3);                            // HX bus thread
+static void hxbus_enqueue(sys_slist_t *queue, hxbus_xfer_t *xfer);
+static bool hxbus_dequeue(sys_slist_t *batch, uint8_t *firstReg, size_t *len);
+static sys_snode_t *hxbus_take(sys_slist_t *queue);
+static bool hxbus_mergeWrite(const hxbus_xfer_t *xfer, uint8_t *firstReg, size_t *len);
+static int hxbus_execute(const hxbus_xfer_t *head, uint8_t firstReg, size_t len);
+static void hxbus_statsStart(sys_slist_t *batch, uint32_t now);
+static void syncComplete(hxbus_xfer_t *xfer, int result, void *userData);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Prepare a register write transaction
+ */
+void hxbus_initWrite(hxbus_xfer_t *xfer, uint16_t addr, uint8_t reg, const uint8_t *data, size_t len, hxbus_prio_t priority)
+{
+    xfer->bus = NULL;
+    xfer->addr = addr;
+    xfer->reg = reg;
+    xfer->op = HXBUS_OP_WRITE;
+    xfer->priority = priority;
+    xfer->buf = (uint8_t *)data;                                                // not written for HXBUS_OP_WRITE
+    xfer->len = len;
+}
+
+
+/**
+ * @brief Prepare a register read transaction
+ */
+void hxbus_initRead(hxbus_xfer_t *xfer, uint16_t addr, uint8_t reg, uint8_t *buf, size_t len, hxbus_prio_t priority)
+{
+    xfer->bus = NULL;
+    xfer->addr = addr;
+    xfer->reg = reg;
+    xfer->op = HXBUS_OP_READ;
+    xfer->priority = priority;
+    xfer->buf = buf;
+    xfer->len = len;
+}
+
+
+/**
+ * @brief Route a prepared transaction to a bus behind the HX bus
+ */
+void hxbus_setBus(hxbus_xfer_t *xfer, const struct device *bus)
+{
+    xfer->bus = bus;
+}
+
+
+/**
+ * @brief Queue a transaction for the HX bus thread
+ *
+ * @param xfer Prepared transaction
+ * @param deadline Latest acceptable start
+ * @param callback Completion callback
+ * @param userData Context for callback
+ * @return int 0=queued
+ */
+int hxbus_submit(hxbus_xfer_t *xfer, k_timeout_t deadline, hxbus_callback_t callback, void *userData)
+{
+    k_spinlock_key_t key;
+
+    if (!device_is_ready(hxbus_i2c))
+    {
+        return -ENODEV;
+    }
+    if (xfer->priority >= HXBUS_PRIO_COUNT || xfer->len == 0 ||
+        (xfer->op == HXBUS_OP_WRITE && xfer->len > CONFIG_HXBUS_WRITE_MAX))
+    {
+        return -EINVAL;
+    }
+
+    xfer->deadline = sys_timepoint_calc(deadline);
+    xfer->callback = callback;
+    xfer->userData = userData;
+    xfer->queuedCycles = k_cycle_get_32();
+
+    key = k_spin_lock(&hxbus_lock);
+    hxbus_enqueue(&hxbus_queue[xfer->priority], xfer);
+    k_spin_unlock(&hxbus_lock, key);
+
+    k_sem_give(&hxbus_pending);
+    return 0;
+}
+
+
+/**
+ * @brief Queue a transaction and wait for completion
+ *
+ * @param xfer Prepared transaction
+ * @param deadline Latest acceptable start
+ * @return int 0=success, else I2C error
+ */
+int hxbus_transfer(hxbus_xfer_t *xfer, k_timeout_t deadline)
+{
+    struct syncWait wait;
+    int ret;
+
+    k_sem_init(&wait.done, 0, 1);
+    ret = hxbus_submit(xfer, deadline, syncComplete, &wait);
+    if (ret == 0)
+    {
+        k_sem_take(&wait.done, K_FOREVER);
+        ret = wait.result;
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Get a snapshot of the bus statistics
+ *
+ * @param stats Returns statistics
+ */
+void hxbus_getStats(hxbus_stats_t *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&hxbus_lock);
+
+    *stats = hxbus_stats;
+    stats->elapsedUs = k_cyc_to_us_floor32(k_cycle_get_32() - hxbus_windowStart);
+    k_spin_unlock(&hxbus_lock, key);
+}
+
+
+/**
+ * @brief Restart the statistics window
+ */
+void hxbus_resetStats(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&hxbus_lock);
+
+    memset(&hxbus_stats, 0, sizeof(hxbus_stats));
+    for (size_t i = 0; i < HXBUS_PRIO_COUNT; i++)
+    {
+        hxbus_stats.waitMinUs[i] = UINT32_MAX;
+    }
+    hxbus_windowStart = k_cycle_get_32();
+    k_spin_unlock(&hxbus_lock, key);
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief HX bus thread, runs queued transactions in priority/deadline order
+ */
+static void hxbus_run(void *p1, void *p2, void *p3)
+{
+    sys_slist_t batch;
+    sys_snode_t *node;
+    uint8_t firstReg;
+    size_t len;
+    uint32_t start;
+    int ret;
+
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (true)
+    {
+        k_sem_take(&hxbus_pending, K_FOREVER);
+
+        while (hxbus_dequeue(&batch, &firstReg, &len))
+        {
+            hxbus_xfer_t *head = SYS_SLIST_CONTAINER(sys_slist_peek_head(&batch), head, node);
+
+            start = k_cycle_get_32();
+            hxbus_statsStart(&batch, start);
+            ret = hxbus_execute(head, firstReg, len);
+
+            k_spinlock_key_t key = k_spin_lock(&hxbus_lock);
+            hxbus_stats.busyUs += k_cyc_to_us_floor32(k_cycle_get_32() - start);
+            hxbus_stats.xfers++;
+            hxbus_stats.errors += (ret != 0) ? 1 : 0;
+            k_spin_unlock(&hxbus_lock, key);
+
+            if (ret != 0)
+            {
+                LOG_WRN("HX transaction to 0x%02x reg 0x%02x failed, err=%d", head->addr, firstReg, ret);
+            }
+            while ((node = sys_slist_get(&batch)) != NULL)                      // xfer belongs to client once callback runs
+            {
+                hxbus_xfer_t *xfer = SYS_SLIST_CONTAINER(node, xfer, node);
+
+                if (xfer->callback != NULL)
+                {
+                    xfer->callback(xfer, ret, xfer->userData);
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Insert a transaction in deadline order, FIFO among equal deadlines (hxbus_lock held)
+ *
+ * @param queue Priority queue
+ * @param xfer Transaction to insert
+ */
+static void hxbus_enqueue(sys_slist_t *queue, hxbus_xfer_t *xfer)
+{
+    sys_snode_t *prev = NULL;
+    hxbus_xfer_t *queued;
+
+    SYS_SLIST_FOR_EACH_CONTAINER(queue, queued, node)
+    {
+        if (sys_timepoint_cmp(xfer->deadline, queued->deadline) < 0)
+        {
+            break;
+        }
+        prev = &(queued->node);
+    }
+    sys_slist_insert(queue, prev, &(xfer->node));
+}
+
+
+/**
+ * @brief Take the next transaction to run, with any writes merged into its burst
+ *
+ * @param batch Returns the transactions completed by this bus transaction, head first
+ * @param firstReg Returns the first register of the (merged) transaction
+ * @param len Returns the (merged) transaction length
+ * @return true A transaction was dequeued
+ */
+static bool hxbus_dequeue(sys_slist_t *batch, uint8_t *firstReg, size_t *len)
+{
+    k_spinlock_key_t key = k_spin_lock(&hxbus_lock);
+    hxbus_xfer_t *head = NULL;
+    hxbus_xfer_t *xfer;
+    hxbus_xfer_t *next;
+    sys_snode_t *prev;
+
+    sys_slist_init(batch);
+    for (size_t i = 0; i < HXBUS_PRIO_COUNT && head == NULL; i++)
+    {
+        sys_slist_t *queue = &hxbus_queue[i];
+        sys_snode_t *node = hxbus_take(queue);
+
+        if (node == NULL)
+        {
+            continue;
+        }
+        head = SYS_SLIST_CONTAINER(node, head, node);
+        sys_slist_append(batch, node);
+        *firstReg = head->reg;
+        *len = head->len;
+
+        if (head->bus != NULL && head->bus != hxbus_segment)
+        {
+            hxbus_stats.segmentSwitches += (hxbus_segment != NULL) ? 1 : 0;
+            hxbus_segment = head->bus;
+        }
+
+        if (head->op == HXBUS_OP_WRITE)
+        {
+            memcpy(&hxbus_txBuf[1], head->buf, head->len);
+
+            prev = NULL;                                                        // merge pass, same priority only
+            SYS_SLIST_FOR_EACH_CONTAINER_SAFE(queue, xfer, next, node)
+            {
+                if (xfer->addr != head->addr || xfer->bus != head->bus)
+                {
+                    prev = &(xfer->node);                                       // other device, order between devices is free
+                    continue;
+                }
+                if (!hxbus_mergeWrite(xfer, firstReg, len))
+                {
+                    break;                                                      // device's next transaction runs next, keeps its order
+                }
+                sys_slist_remove(queue, prev, &(xfer->node));
+                sys_slist_append(batch, &(xfer->node));
+                hxbus_stats.merged++;
+            }
+        }
+    }
+    k_spin_unlock(&hxbus_lock, key);
+    return head != NULL;
+}
+
+
+/**
+ * @brief Remove the transaction to run next from a priority queue (hxbus_lock held)
+ *
+ * Normally the head (earliest deadline). When the head needs a segment switch, a transaction that
+ * doesn't (segment in use or HX bus) is taken instead, unless the head's deadline has passed or
+ * CONFIG_HXBUS_SEGMENT_RUN_MAX transactions already went ahead of it.
+ *
+ * @param queue Priority queue
+ * @return sys_snode_t* Transaction node, NULL=queue empty
+ */
+static sys_snode_t *hxbus_take(sys_slist_t *queue)
+{
+    hxbus_xfer_t *head = SYS_SLIST_PEEK_HEAD_CONTAINER(queue, head, node);
+    hxbus_xfer_t *xfer;
+    sys_snode_t *prev = NULL;
+
+    if (head == NULL)
+    {
+        return NULL;
+    }
+    if (head->bus != NULL && head->bus != hxbus_segment && hxbus_segment != NULL &&
+        hxbus_segmentRun < CONFIG_HXBUS_SEGMENT_RUN_MAX && !sys_timepoint_expired(head->deadline))
+    {
+        SYS_SLIST_FOR_EACH_CONTAINER(queue, xfer, node)
+        {
+            if (xfer->bus == NULL || xfer->bus == hxbus_segment)
+            {
+                sys_slist_remove(queue, prev, &(xfer->node));
+                hxbus_segmentRun++;
+                hxbus_stats.segmentReorders++;
+                return &(xfer->node);
+            }
+            prev = &(xfer->node);
+        }
+    }
+    hxbus_segmentRun = 0;
+    return sys_slist_get(queue);
+}
+
+
+/**
+ * @brief Merge a queued write into the burst being built in hxbus_txBuf, if adjacent
+ *
+ * Only writes that extend the burst at either end are merged. The caller offers the device's
+ * queued transactions in queue order and stops at the first one not merged, so a write is never
+ * merged ahead of an earlier read, overlapping write or command to the same device.
+ *
+ * @param xfer Next queued transaction to the burst's device
+ * @param firstReg First register of the burst, updated on merge
+ * @param len Burst length, updated on merge
+ * @return true Write merged, caller removes it from the queue
+ */
+static bool hxbus_mergeWrite(const hxbus_xfer_t *xfer, uint8_t *firstReg, size_t *len)
+{
+    if (xfer->op != HXBUS_OP_WRITE || *len + xfer->len > CONFIG_HXBUS_WRITE_MAX)
+    {
+        return false;
+    }
+    if (xfer->reg == *firstReg + *len)                                          // follows the burst
+    {
+        memcpy(&hxbus_txBuf[1 + *len], xfer->buf, xfer->len);
+    }
+    else if (xfer->reg + xfer->len == *firstReg)                                // precedes the burst
+    {
+        memmove(&hxbus_txBuf[1 + xfer->len], &hxbus_txBuf[1], *len);
+        memcpy(&hxbus_txBuf[1], xfer->buf, xfer->len);
+        *firstReg = xfer->reg;
+    }
+    else
+    {
+        return false;
+    }
+    *len += xfer->len;
+    return true;
+}
+
+
+/**
+ * @brief Run one bus transaction
+ *
+ * @param head First transaction of the batch (device, operation)
+ * @param firstReg First register
+ * @param len Bytes to transfer, write data is in hxbus_txBuf
+ * @return int 0=success, else I2C error
+ */
+static int hxbus_execute(const hxbus_xfer_t *head, uint8_t firstReg, size_t len)
+{
+    const struct device *bus = (head->bus != NULL) ? head->bus : hxbus_i2c;    // segment bus selects its segment
+
+    if (head->op == HXBUS_OP_READ)
+    {
+        return i2c_write_read(bus, head->addr, &firstReg, 1, head->buf, len);
+    }
+    hxbus_txBuf[0] = firstReg;                                                  // auto-increment burst
+    return i2c_write(bus, hxbus_txBuf, 1 + len, head->addr);
+}
+
+
+/**
+ * @brief Record queue wait and deadline misses for the transactions about to run
+ *
+ * @param batch Transactions completed by this bus transaction
+ * @param now Cycle count at start
+ */
+static void hxbus_statsStart(sys_slist_t *batch, uint32_t now)
+{
+    k_spinlock_key_t key = k_spin_lock(&hxbus_lock);
+    hxbus_xfer_t *xfer;
+
+    SYS_SLIST_FOR_EACH_CONTAINER(batch, xfer, node)
+    {
+        uint32_t waitUs = k_cyc_to_us_floor32(now - xfer->queuedCycles);
+
+        hxbus_stats.waitMaxUs[xfer->priority] = MAX(hxbus_stats.waitMaxUs[xfer->priority], waitUs);
+        hxbus_stats.waitMinUs[xfer->priority] = MIN(hxbus_stats.waitMinUs[xfer->priority], waitUs);
+        if (sys_timepoint_expired(xfer->deadline))
+        {
+            hxbus_stats.deadlineMisses++;
+        }
+    }
+    k_spin_unlock(&hxbus_lock, key);
+}
+
+
+/**
+ * @brief Completion callback used by hxbus_transfer(), wakes the waiting caller
+ */
+static void syncComplete(hxbus_xfer_t *xfer, int result, void *userData)
+{
+    struct syncWait *wait = (struct syncWait *)userData;
+
+    ARG_UNUSED(xfer);
+    wait->result = result;
+    k_sem_give(&(wait->done));
+}
+
+
+/**
+ * @brief Start the HX bus thread
+ *
+ * Started at POST_KERNEL (not K_THREAD_DEFINE) so devices initialized at POST_KERNEL, such as the
+ * LP5817 indicator, can already run blocking HX transactions.
+ */
+static int hxbus_init(void)
+{
+    hxbus_resetStats();
+    k_thread_create(&hxbus_thread, hxbus_stack, K_THREAD_STACK_SIZEOF(hxbus_stack), hxbus_run,
+                    NULL, NULL, NULL, CONFIG_HXBUS_THREAD_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&hxbus_thread, "hxbus");
+    return 0;
+}
+
+SYS_INIT(hxbus_init, POST_KERNEL, 0);
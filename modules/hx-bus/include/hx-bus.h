@@ -0,0 +1,169 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HX_BUS
+#define HX_BUS
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/slist.h>
+#include <zephyr/sys_clock.h>
+
+
+/* Host extension (HX) bus transaction scheduler
+ *
+ * The HX bus (I2C3, 100kHz) is shared by the LP5817 indicator and the ISense sensors. Clients
+ * queue register transactions, the HX bus thread runs them:
+ *  - by priority, sensor reads ahead of control and cosmetic (indicator) traffic
+ *  - earliest deadline first within a priority
+ *  - adjacent register writes to the same device queued at the same priority are merged into
+ *    a single auto-increment burst, while no other transaction to that device is queued between
+ *    them (transactions to one device keep their order)
+ *  - transactions routed to a multiplexor segment (hxbus_setBus) on the segment in use are run
+ *    ahead of earlier deadlines on other segments, while those deadlines have not passed and for
+ *    at most CONFIG_HXBUS_SEGMENT_RUN_MAX transactions in a row, to save segment switches
+ *
+ * Transactions are client owned (no heap), a transaction must not be changed or reused until
+ * its callback runs.
+ */
+
+typedef enum
+{
+    HXBUS_PRIO_SENSOR = 0,                              // sample reads, latency sensitive
+    HXBUS_PRIO_CONTROL,                                 // device configuration
+    HXBUS_PRIO_COSMETIC,                                // indicator updates
+    HXBUS_PRIO_COUNT
+} hxbus_prio_t;
+
+typedef enum
+{
+    HXBUS_OP_WRITE = 0,                                 // write len bytes starting at reg
+    HXBUS_OP_READ,                                      // read len bytes starting at reg
+} hxbus_op_t;
+
+struct _hxbus_xfer;
+
+/**
+ * @brief Transaction completion callback
+ *
+ * @param xfer The completed transaction
+ * @param result 0=success, else I2C error
+ * @param userData Caller supplied context
+ *
+ * @note Called from the HX bus thread, keep it short.
+ */
+typedef void (*hxbus_callback_t)(struct _hxbus_xfer *xfer, int result, void *userData);
+
+typedef struct _hxbus_xfer
+{
+    sys_snode_t node;                                   // queue link
+    const struct device *bus;                           // NULL=HX bus, else a bus behind it (hx-mux segment)
+    uint16_t addr;                                      // I2C device address
+    uint8_t reg;                                        // first register
+    uint8_t op;                                         // hxbus_op_t
+    uint8_t priority;                                   // hxbus_prio_t
+    uint8_t *buf;                                       // write data or read destination
+    size_t len;
+    k_timepoint_t deadline;                             // sys_timepoint_calc(), K_FOREVER=none
+    uint32_t queuedCycles;                              // submit time, queue wait statistics
+    hxbus_callback_t callback;
+    void *userData;
+} hxbus_xfer_t;
+
+/* Bus statistics since start or hxbus_resetStats()
+ */
+typedef struct _hxbus_stats
+{
+    uint32_t xfers;                                     // I2C transactions run
+    uint32_t merged;                                    // writes merged into another transaction's burst
+    uint32_t errors;
+    uint32_t deadlineMisses;                            // transactions started after their deadline
+    uint32_t segmentSwitches;                           // transactions on a different segment than the previous one
+    uint32_t segmentReorders;                           // transactions run ahead of the queue head to stay on a segment
+    uint32_t busyUs;                                    // time the bus was transferring
+    uint32_t elapsedUs;                                 // measurement window, utilization = busyUs / elapsedUs
+    uint32_t waitMaxUs[HXBUS_PRIO_COUNT];               // longest submit to start wait, per priority
+    uint32_t waitMinUs[HXBUS_PRIO_COUNT];               // shortest wait, max - min is the queueing jitter
+} hxbus_stats_t;
+
+
+/**
+ * @brief Prepare a register write transaction
+ *
+ * @param xfer Transaction to initialize
+ * @param addr I2C device address
+ * @param reg First register
+ * @param data Register values (must remain valid until completion)
+ * @param len Number of registers (max CONFIG_HXBUS_WRITE_MAX)
+ * @param priority Queue priority
+ */
+void hxbus_initWrite(hxbus_xfer_t *xfer, uint16_t addr, uint8_t reg, const uint8_t *data, size_t len, hxbus_prio_t priority);
+
+
+/**
+ * @brief Prepare a register read transaction
+ *
+ * @param xfer Transaction to initialize
+ * @param addr I2C device address
+ * @param reg First register
+ * @param buf Returns register values
+ * @param len Number of registers
+ * @param priority Queue priority
+ */
+void hxbus_initRead(hxbus_xfer_t *xfer, uint16_t addr, uint8_t reg, uint8_t *buf, size_t len, hxbus_prio_t priority);
+
+
+/**
+ * @brief Route a prepared transaction to a bus behind the HX bus
+ *
+ * @param xfer Prepared transaction (hxbus_initWrite/hxbus_initRead select the HX bus)
+ * @param bus Segment bus device, e.g. a "loouq,hx-mux-channel" node (NULL=HX bus)
+ */
+void hxbus_setBus(hxbus_xfer_t *xfer, const struct device *bus);
+
+
+/**
+ * @brief Queue a transaction, returns without waiting
+ *
+ * @param xfer Prepared transaction
+ * @param deadline Latest acceptable start (K_FOREVER=none), orders transactions within a priority
+ * @param callback Completion callback (can be NULL)
+ * @param userData Context for callback
+ * @return int 0=queued, -ENODEV HX bus not ready, -EINVAL bad transaction
+ *
+ * @note Callable from any context (including ISR).
+ */
+int hxbus_submit(hxbus_xfer_t *xfer, k_timeout_t deadline, hxbus_callback_t callback, void *userData);
+
+
+/**
+ * @brief Queue a transaction and wait for it to complete
+ *
+ * @param xfer Prepared transaction
+ * @param deadline Latest acceptable start (K_FOREVER=none)
+ * @return int 0=success, else I2C error
+ *
+ * @note Thread context only, must not be called from an HX bus completion callback.
+ */
+int hxbus_transfer(hxbus_xfer_t *xfer, k_timeout_t deadline);
+
+
+/**
+ * @brief Get a snapshot of the bus statistics
+ *
+ * @param stats Returns statistics
+ */
+void hxbus_getStats(hxbus_stats_t *stats);
+
+
+/**
+ * @brief Restart the statistics window
+ */
+void hxbus_resetStats(void);
+
+#endif
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/atomic.h>
+
+#include "hx-handshake.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(hxhs, CONFIG_HXHANDSHAKE_LOG_LEVEL);
+
+typedef enum
+{
+    HXHS_IDLE = 0,                                      // both lines released
+    HXHS_BOARD_RQST,                                    // HXRQST asserted, waiting for host acknowledge
+    HXHS_BOARD_RELEASE,                                 // acknowledged, HXRQST released, waiting for host release
+    HXHS_HOST_RQST,                                     // host request acknowledged, waiting for host release
+} hxhs_state_t;
+
+static const struct gpio_dt_spec hxhs_rqst = GPIO_DT_SPEC_GET(DT_NODELABEL(hxrqst), gpios);
+static const struct gpio_dt_spec hxhs_ctrl = GPIO_DT_SPEC_GET(DT_NODELABEL(hxctrl), gpios);
+
+static struct gpio_callback hxhs_ctrlCb;
+static atomic_t hxhs_state;                             // hxhs_state_t
+static bool hxhs_ready;
+static K_SEM_DEFINE(hxhs_boardDone, 0, 1);              // board request complete
+static K_SEM_DEFINE(hxhs_hostPending, 0, K_SEM_MAX_LIMIT);
+static struct k_spinlock hxhs_lock;                     // guards callback and statistics
+static hxhs_callback_t hxhs_hostCallback;
+static void *hxhs_hostUserData;
+static uint32_t hxhs_rqstCycles;                        // board request start, acknowledge latency
+static hxhs_stats_t hxhs_stats;
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static void hxhs_ctrlEdge(const struct device *port, struct gpio_callback *cb, gpio_port_pins_t pins);
+static void hostRequest(void);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Request the host's attention and wait for the handshake to complete
+ */
+int hxhs_request(k_timeout_t timeout)
+{
+    int ret;
+
+    if (!hxhs_ready)
+    {
+        return -ENODEV;
+    }
+    if (!atomic_cas(&hxhs_state, HXHS_IDLE, HXHS_BOARD_RQST))
+    {
+        return -EBUSY;
+    }
+
+    k_sem_reset(&hxhs_boardDone);
+    hxhs_rqstCycles = k_cycle_get_32();
+    gpio_pin_set_dt(&hxhs_rqst, 1);
+
+    ret = k_sem_take(&hxhs_boardDone, timeout);
+    if (ret != 0)
+    {
+        /* Withdraw, unless the host completed the handshake as the wait timed out */
+        if (atomic_cas(&hxhs_state, HXHS_BOARD_RQST, HXHS_IDLE) || atomic_cas(&hxhs_state, HXHS_BOARD_RELEASE, HXHS_IDLE))
+        {
+            gpio_pin_set_dt(&hxhs_rqst, 0);
+            k_spinlock_key_t key = k_spin_lock(&hxhs_lock);
+            hxhs_stats.timeouts++;
+            k_spin_unlock(&hxhs_lock, key);
+            LOG_WRN("Host did not complete handshake");
+            return -ETIMEDOUT;
+        }
+        k_sem_reset(&hxhs_boardDone);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&hxhs_lock);
+    hxhs_stats.boardRequests++;
+    k_spin_unlock(&hxhs_lock, key);
+    return 0;
+}
+
+
+/**
+ * @brief Wait for a host request (already acknowledged when this returns)
+ */
+int hxhs_waitHost(k_timeout_t timeout)
+{
+    return k_sem_take(&hxhs_hostPending, timeout);
+}
+
+
+/**
+ * @brief Register a function called from the edge interrupt on each host request
+ */
+void hxhs_setHostCallback(hxhs_callback_t callback, void *userData)
+{
+    k_spinlock_key_t key = k_spin_lock(&hxhs_lock);
+
+    hxhs_hostCallback = callback;
+    hxhs_hostUserData = userData;
+    k_spin_unlock(&hxhs_lock, key);
+}
+
+
+/**
+ * @brief Check whether the host currently asserts HXCTRL
+ */
+bool hxhs_hostAsserted(void)
+{
+    return hxhs_ready && gpio_pin_get_dt(&hxhs_ctrl) > 0;
+}
+
+
+/**
+ * @brief Get a snapshot of the handshake counters
+ */
+void hxhs_getStats(hxhs_stats_t *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&hxhs_lock);
+
+    *stats = hxhs_stats;
+    k_spin_unlock(&hxhs_lock, key);
+}
+
+
+/**
+ * @brief Clear the handshake counters
+ */
+void hxhs_resetStats(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&hxhs_lock);
+
+    memset(&hxhs_stats, 0, sizeof(hxhs_stats));
+    k_spin_unlock(&hxhs_lock, key);
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief HXCTRL edge interrupt, advances the handshake
+ */
+static void hxhs_ctrlEdge(const struct device *port, struct gpio_callback *cb, gpio_port_pins_t pins)
+{
+    int asserted = gpio_pin_get_dt(&hxhs_ctrl);
+
+    ARG_UNUSED(port);
+    ARG_UNUSED(cb);
+    ARG_UNUSED(pins);
+
+    switch (atomic_get(&hxhs_state))
+    {
+        case HXHS_IDLE:
+            if (asserted > 0)
+            {
+                hostRequest();
+            }
+            break;
+
+        case HXHS_BOARD_RQST:
+            if (asserted > 0 && atomic_cas(&hxhs_state, HXHS_BOARD_RQST, HXHS_BOARD_RELEASE))
+            {
+                uint32_t ackUs = k_cyc_to_us_floor32(k_cycle_get_32() - hxhs_rqstCycles);
+
+                gpio_pin_set_dt(&hxhs_rqst, 0);
+                k_spinlock_key_t key = k_spin_lock(&hxhs_lock);
+                hxhs_stats.ackLastUs = ackUs;
+                hxhs_stats.ackMaxUs = MAX(hxhs_stats.ackMaxUs, ackUs);
+                k_spin_unlock(&hxhs_lock, key);
+            }
+            break;
+
+        case HXHS_BOARD_RELEASE:
+            if (asserted == 0 && atomic_cas(&hxhs_state, HXHS_BOARD_RELEASE, HXHS_IDLE))
+            {
+                k_sem_give(&hxhs_boardDone);
+            }
+            break;
+
+        case HXHS_HOST_RQST:
+            if (asserted == 0)
+            {
+                gpio_pin_set_dt(&hxhs_rqst, 0);
+                atomic_set(&hxhs_state, HXHS_IDLE);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief Acknowledge a host request and wake the waiting thread (edge interrupt)
+ */
+static void hostRequest(void)
+{
+    hxhs_callback_t callback;
+    void *userData;
+
+    if (!atomic_cas(&hxhs_state, HXHS_IDLE, HXHS_HOST_RQST))
+    {
+        return;                                                             // board request started first
+    }
+    gpio_pin_set_dt(&hxhs_rqst, 1);
+
+    k_spinlock_key_t key = k_spin_lock(&hxhs_lock);
+    hxhs_stats.hostRequests++;
+    callback = hxhs_hostCallback;
+    userData = hxhs_hostUserData;
+    k_spin_unlock(&hxhs_lock, key);
+
+    k_sem_give(&hxhs_hostPending);
+    if (callback != NULL)
+    {
+        callback(userData);
+    }
+}
+
+
+/**
+ * @brief Configure the handshake lines and enable the HXCTRL edge interrupt
+ */
+static int hxhs_init(void)
+{
+    int ret;
+
+    if (!gpio_is_ready_dt(&hxhs_rqst) || !gpio_is_ready_dt(&hxhs_ctrl))
+    {
+        LOG_ERR("HX handshake GPIO not ready");
+        return -ENODEV;
+    }
+
+    ret = gpio_pin_configure_dt(&hxhs_rqst, GPIO_OUTPUT_INACTIVE);
+    if (ret == 0)
+    {
+        ret = gpio_pin_configure_dt(&hxhs_ctrl, GPIO_INPUT);
+    }
+    if (ret == 0)
+    {
+        gpio_init_callback(&hxhs_ctrlCb, hxhs_ctrlEdge, BIT(hxhs_ctrl.pin));
+        ret = gpio_add_callback_dt(&hxhs_ctrl, &hxhs_ctrlCb);
+    }
+    if (ret == 0)
+    {
+        ret = gpio_pin_interrupt_configure_dt(&hxhs_ctrl, GPIO_INT_EDGE_BOTH);
+    }
+    if (ret != 0)
+    {
+        LOG_ERR("HX handshake GPIO configuration failed, err=%d", ret);
+        return ret;
+    }
+
+    hxhs_ready = true;
+    if (gpio_pin_get_dt(&hxhs_ctrl) > 0)                                    // host request raised before boot
+    {
+        hostRequest();
+    }
+    return 0;
+}
+
+SYS_INIT(hxhs_init, POST_KERNEL, CONFIG_HXHANDSHAKE_INIT_PRIORITY);
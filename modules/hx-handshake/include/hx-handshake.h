@@ -0,0 +1,115 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HX_HANDSHAKE
+#define HX_HANDSHAKE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+
+/* Host extension (HX) request/acknowledge handshake
+ *
+ * Two lines between this board and the HX host, both active high:
+ *   HXRQST (devicetree node label hxrqst) output, driven by this board
+ *   HXCTRL (devicetree node label hxctrl) input, driven by the host, edge interrupt on both edges
+ *
+ * Either side starts a request, the exchange is a four phase handshake and the lines are never
+ * polled (the CPU idles until an edge interrupt).
+ *
+ * Board request (hxhs_request()):
+ *   1. board asserts HXRQST
+ *   2. host asserts HXCTRL (acknowledge)
+ *   3. board releases HXRQST (from the edge interrupt)
+ *   4. host releases HXCTRL, the request completes and the waiting thread is woken
+ *
+ * Host request (hxhs_waitHost()):
+ *   1. host asserts HXCTRL while HXRQST is released
+ *   2. board asserts HXRQST (acknowledge, from the edge interrupt) and wakes the waiting thread
+ *   3. host releases HXCTRL
+ *   4. board releases HXRQST (from the edge interrupt)
+ *
+ * A board request that is not acknowledged and released by the host within the timeout is
+ * withdrawn (HXRQST released) and fails with -ETIMEDOUT. If both sides request at once, HXCTRL
+ * asserted during a board request is taken as the acknowledge: the host must not start a request
+ * while HXRQST is asserted.
+ */
+
+/**
+ * @brief Host request notification
+ *
+ * @param userData Context given to hxhs_setHostCallback()
+ *
+ * @note Called from the edge interrupt after the acknowledge is driven, keep it short.
+ */
+typedef void (*hxhs_callback_t)(void *userData);
+
+/* Handshake counters since boot or hxhs_resetStats()
+ */
+typedef struct _hxhs_stats
+{
+    uint32_t boardRequests;                             // hxhs_request() calls completed
+    uint32_t hostRequests;                              // host requests acknowledged
+    uint32_t timeouts;                                  // board requests withdrawn
+    uint32_t ackMaxUs;                                  // longest board request to host acknowledge
+    uint32_t ackLastUs;
+} hxhs_stats_t;
+
+
+/**
+ * @brief Request the host's attention and wait for the handshake to complete
+ *
+ * @param timeout How long to wait for the host to acknowledge and release
+ * @return int 0=acknowledged, -EBUSY handshake in progress, -ETIMEDOUT request withdrawn, -ENODEV lines not ready
+ *
+ * @note Thread context only.
+ */
+int hxhs_request(k_timeout_t timeout);
+
+
+/**
+ * @brief Wait for a host request (already acknowledged when this returns)
+ *
+ * @param timeout How long to wait
+ * @return int 0=host request, -EAGAIN timed out
+ *
+ * @note Requests arriving while no thread waits are counted, a later call returns at once.
+ */
+int hxhs_waitHost(k_timeout_t timeout);
+
+
+/**
+ * @brief Register a function called from the edge interrupt on each host request
+ *
+ * @param callback Notification function, NULL to remove
+ * @param userData Context for callback
+ */
+void hxhs_setHostCallback(hxhs_callback_t callback, void *userData);
+
+
+/**
+ * @brief Check whether the host currently asserts HXCTRL
+ *
+ * @return true HXCTRL asserted
+ */
+bool hxhs_hostAsserted(void);
+
+
+/**
+ * @brief Get a snapshot of the handshake counters
+ *
+ * @param stats Returns counters
+ */
+void hxhs_getStats(hxhs_stats_t *stats);
+
+
+/**
+ * @brief Clear the handshake counters
+ */
+void hxhs_resetStats(void);
+
+#endif
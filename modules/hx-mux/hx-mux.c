@@ -0,0 +1,269 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+
+#include "hx-mux.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(hxmux, CONFIG_HXMUX_LOG_LEVEL);
+
+#define HXMUX_SELECTED_UNKNOWN -1                                       // selected: control byte must be written
+
+struct hxmux_config                                                     // ROM, one per multiplexor
+{
+    struct i2c_dt_spec bus;                                             // HX bus and control address
+};
+
+struct hxmux_data
+{
+    struct k_mutex lock;                                                // one segment transaction at a time
+    int16_t selected;                                                   // segment connected, cached, lock held
+    struct k_spinlock statsLock;
+    hxmux_stats_t stats;
+};
+
+struct hxmux_chanConfig                                                 // ROM, one per segment
+{
+    const struct device *mux;
+    uint8_t channel;
+};
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static int hxmux_select(const struct device *mux, uint8_t channel);
+static int hxmux_writeControl(const struct device *mux, uint8_t control);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Disconnect all segments
+ */
+int hxmux_deselect(const struct device *mux)
+{
+    struct hxmux_data *data = mux->data;
+    int ret;
+
+    k_mutex_lock(&(data->lock), K_FOREVER);
+    ret = hxmux_writeControl(mux, 0);
+    k_mutex_unlock(&(data->lock));
+    return ret;
+}
+
+
+/**
+ * @brief Get a snapshot of the multiplexor counters
+ */
+void hxmux_getStats(const struct device *mux, hxmux_stats_t *stats)
+{
+    struct hxmux_data *data = mux->data;
+    k_spinlock_key_t key = k_spin_lock(&(data->statsLock));
+
+    *stats = data->stats;
+    k_spin_unlock(&(data->statsLock), key);
+}
+
+
+/**
+ * @brief Clear the multiplexor counters
+ */
+void hxmux_resetStats(const struct device *mux)
+{
+    struct hxmux_data *data = mux->data;
+    k_spinlock_key_t key = k_spin_lock(&(data->statsLock));
+
+    memset(&(data->stats), 0, sizeof(data->stats));
+    k_spin_unlock(&(data->statsLock), key);
+}
+
+
+/* Segment I2C API
+ * --------------------------------------------------------------------------------------------- */
+
+static int hxmux_chanConfigure(const struct device *dev, uint32_t devConfig)
+{
+    const struct hxmux_chanConfig *chan = dev->config;
+    const struct hxmux_config *config = chan->mux->config;
+
+    return i2c_configure(config->bus.bus, devConfig);                   // segments share the HX bus timing
+}
+
+
+static int hxmux_chanGetConfig(const struct device *dev, uint32_t *devConfig)
+{
+    const struct hxmux_chanConfig *chan = dev->config;
+    const struct hxmux_config *config = chan->mux->config;
+
+    return i2c_get_config(config->bus.bus, devConfig);
+}
+
+
+static int hxmux_chanTransfer(const struct device *dev, struct i2c_msg *msgs, uint8_t numMsgs, uint16_t addr)
+{
+    const struct hxmux_chanConfig *chan = dev->config;
+    const struct hxmux_config *config = chan->mux->config;
+    struct hxmux_data *data = chan->mux->data;
+    int ret;
+
+    k_mutex_lock(&(data->lock), K_FOREVER);
+    ret = hxmux_select(chan->mux, chan->channel);
+    if (ret == 0)
+    {
+        ret = i2c_transfer(config->bus.bus, msgs, numMsgs, addr);
+        if (ret != 0)
+        {
+            data->selected = HXMUX_SELECTED_UNKNOWN;                    // bus recovery or a mux reset may have dropped the selection
+        }
+    }
+    k_mutex_unlock(&(data->lock));
+    return ret;
+}
+
+
+static DEVICE_API(i2c, hxmux_chanApi) =
+{
+    .configure = hxmux_chanConfigure,
+    .get_config = hxmux_chanGetConfig,
+    .transfer = hxmux_chanTransfer,
+};
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Connect a segment, skipped when it is already connected (lock held)
+ *
+ * @param mux Multiplexor device
+ * @param channel Segment number
+ * @return int 0=selected, else I2C error
+ */
+static int hxmux_select(const struct device *mux, uint8_t channel)
+{
+    struct hxmux_data *data = mux->data;
+    bool cached = (data->selected == channel);
+    k_spinlock_key_t key = k_spin_lock(&(data->statsLock));
+    int ret = 0;
+
+    data->stats.transfers++;
+    data->stats.selectsSkipped += cached ? 1 : 0;
+    k_spin_unlock(&(data->statsLock), key);
+
+    if (!cached)
+    {
+        ret = hxmux_writeControl(mux, BIT(channel));
+        if (ret == 0)
+        {
+            data->selected = channel;
+        }
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Write the control byte, updates the cached selection (lock held)
+ *
+ * @param mux Multiplexor device
+ * @param control Bit per segment to connect
+ * @return int 0=success, else I2C error
+ */
+static int hxmux_writeControl(const struct device *mux, uint8_t control)
+{
+    const struct hxmux_config *config = mux->config;
+    struct hxmux_data *data = mux->data;
+    int ret = i2c_write_dt(&(config->bus), &control, 1);
+    k_spinlock_key_t key = k_spin_lock(&(data->statsLock));
+
+    if (ret == 0)
+    {
+        data->stats.selectWrites++;
+    }
+    else
+    {
+        data->stats.errors++;
+    }
+    k_spin_unlock(&(data->statsLock), key);
+
+    data->selected = HXMUX_SELECTED_UNKNOWN;                            // caller records a single segment selection
+    if (ret != 0)
+    {
+        LOG_ERR("HX mux 0x%02x select 0x%02x failed, err=%d", config->bus.addr, control, ret);
+    }
+    return ret;
+}
+
+
+/* Devicetree instantiation
+ * --------------------------------------------------------------------------------------------- */
+
+static int hxmux_init(const struct device *dev)
+{
+    const struct hxmux_config *config = dev->config;
+    struct hxmux_data *data = dev->data;
+
+    if (!i2c_is_ready_dt(&(config->bus)))
+    {
+        LOG_ERR("I2C bus %s is not ready", config->bus.bus->name);
+        return -ENODEV;
+    }
+    k_mutex_init(&(data->lock));
+    data->selected = HXMUX_SELECTED_UNKNOWN;
+    return hxmux_writeControl(dev, 0);                                  // all segments disconnected, known state
+}
+
+
+static int hxmux_chanInit(const struct device *dev)
+{
+    const struct hxmux_chanConfig *chan = dev->config;
+
+    if (!device_is_ready(chan->mux))
+    {
+        LOG_ERR("HX mux %s is not ready", chan->mux->name);
+        return -ENODEV;
+    }
+    return 0;
+}
+
+
+#define DT_DRV_COMPAT loouq_hx_mux
+
+#define HXMUX_DEFINE(inst)                                                                          \
+    static const struct hxmux_config hxmux_config_##inst =                                          \
+    {                                                                                               \
+        .bus = I2C_DT_SPEC_INST_GET(inst),                                                          \
+    };                                                                                              \
+                                                                                                    \
+    static struct hxmux_data hxmux_data_##inst;                                                     \
+                                                                                                    \
+    DEVICE_DT_INST_DEFINE(inst, hxmux_init, NULL, &hxmux_data_##inst, &hxmux_config_##inst,         \
+                          POST_KERNEL, CONFIG_HXMUX_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(HXMUX_DEFINE)
+
+#undef DT_DRV_COMPAT
+#define DT_DRV_COMPAT loouq_hx_mux_channel
+
+#define HXMUX_CHANNEL_DEFINE(inst)                                                                  \
+    BUILD_ASSERT(DT_INST_REG_ADDR(inst) < 8, "hx-mux segment must be 0-7");                         \
+                                                                                                    \
+    static const struct hxmux_chanConfig hxmux_chanConfig_##inst =                                  \
+    {                                                                                               \
+        .mux = DEVICE_DT_GET(DT_INST_PARENT(inst)),                                                 \
+        .channel = DT_INST_REG_ADDR(inst),                                                          \
+    };                                                                                              \
+                                                                                                    \
+    DEVICE_DT_INST_DEFINE(inst, hxmux_chanInit, NULL, NULL, &hxmux_chanConfig_##inst,               \
+                          POST_KERNEL, CONFIG_HXMUX_CHANNEL_INIT_PRIORITY, &hxmux_chanApi);
+
+DT_INST_FOREACH_STATUS_OKAY(HXMUX_CHANNEL_DEFINE)
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HX_MUX
+#define HX_MUX
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+
+/* Host MTC2 board I2C multiplexor ("loouq,hx-mux" on the HX bus)
+ *
+ * Every downstream segment ("loouq,hx-mux-channel" node) is an I2C bus device: devices declared
+ * under a segment node get it as their bus and use the standard I2C API, segment selection is
+ * done by the driver. Transactions are serialized per multiplexor, the selected segment is cached
+ * so consecutive transactions on the same segment only cost the transaction itself. The cache is
+ * dropped after any failed transaction, select write or segment transfer (the next transaction
+ * writes the control byte again).
+ *
+ * HX bus scheduler clients reach segment devices with hxbus_setBus(), the scheduler prefers
+ * transactions on the segment in use to reduce switching.
+ */
+
+/* Multiplexor counters since boot or hxmux_resetStats()
+ */
+typedef struct _hxmux_stats
+{
+    uint32_t transfers;                                 // segment transactions
+    uint32_t selectWrites;                              // control byte writes (segment switches)
+    uint32_t selectsSkipped;                            // transactions on the segment already selected, no write
+    uint32_t errors;                                    // failed select writes
+} hxmux_stats_t;
+
+
+/**
+ * @brief Disconnect all segments (control byte 0)
+ *
+ * @param mux Multiplexor device ("loouq,hx-mux")
+ * @return int 0=success, else I2C error
+ */
+int hxmux_deselect(const struct device *mux);
+
+
+/**
+ * @brief Get a snapshot of the multiplexor counters
+ *
+ * @param mux Multiplexor device
+ * @param stats Returns counters
+ */
+void hxmux_getStats(const struct device *mux, hxmux_stats_t *stats);
+
+
+/**
+ * @brief Clear the multiplexor counters
+ *
+ * @param mux Multiplexor device
+ */
+void hxmux_resetStats(const struct device *mux);
+
+#endif
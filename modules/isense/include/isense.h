@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ISENSE
+#define ISENSE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+
+/* ISense add-on streaming (ISM330DHCX accel/gyro, BMP581 pressure/temperature)
+ *
+ * The ISM330 hardware FIFO batches accel and gyro samples (and a timestamp every 8 samples),
+ * it is drained in burst reads on the HX bus straight into a ring buffer of FIFO words. BMP581
+ * forced mode samples are inserted into the same stream at a low rate as words with their own
+ * tag. Consumers claim words in place (no copy) and release them when done.
+ *
+ * Each word is 7 bytes, the ISM330 FIFO format: tag byte (sensor in bits 7:3) then 6 data bytes.
+ */
+
+#define ISENSE_WORD_SIZE 7
+
+#define ISENSE_TAG_GYRO 0x01                            // x, y, z int16 little endian
+#define ISENSE_TAG_ACCEL 0x02                           // x, y, z int16 little endian
+#define ISENSE_TAG_TIMESTAMP 0x04                       // uint32 little endian, 25us LSB
+#define ISENSE_TAG_BMP581 0x1f                          // not used by the ISM330: int24 temperature (1/65536 C), uint24 pressure (1/64 Pa)
+
+/* ISM330 accel/gyro output and batching data rate (ODR/BDR register code)
+ */
+typedef enum
+{
+    ISENSE_ODR_12HZ5 = 1,
+    ISENSE_ODR_26HZ,
+    ISENSE_ODR_52HZ,
+    ISENSE_ODR_104HZ,
+    ISENSE_ODR_208HZ,
+    ISENSE_ODR_416HZ,
+    ISENSE_ODR_833HZ,
+} isense_odr_t;
+
+typedef struct _isense_config
+{
+    uint8_t odr;                                        // isense_odr_t
+    uint16_t watermark;                                 // FIFO words per drain (accel + gyro + timestamp words)
+    uint16_t bmpPeriodMs;                               // BMP581 forced sample period, 0=BMP581 not sampled
+} isense_config_t;
+
+/* Streaming counters since isense_start() or isense_resetStats()
+ */
+typedef struct _isense_stats
+{
+    uint32_t words;                                     // FIFO words moved to the ring
+    uint32_t bursts;                                    // FIFO data burst reads
+    uint32_t fifoOverruns;                              // ISM330 FIFO overflowed between drains (samples lost)
+    uint32_t ringDrops;                                 // words left in the FIFO because the ring was full
+    uint32_t bmpSamples;
+    uint32_t cpuUs;                                     // time spent in the streaming callbacks
+} isense_stats_t;
+
+
+/**
+ * @brief Configure the ISense sensors and start streaming
+ *
+ * @param config Rates and batching
+ * @return int 0=streaming, -ENODEV sensor not found, -EALREADY streaming, -EBUSY still stopping,
+ *             else HX bus error
+ */
+int isense_start(const isense_config_t *config);
+
+
+/**
+ * @brief Stop streaming, sensors are put in power down
+ *
+ * Waits for a FIFO drain underway to end, no ISense transfer is left on the HX bus.
+ *
+ * @return int 0=success, else the first HX bus error
+ */
+int isense_stop(void);
+
+
+/**
+ * @brief Wait for streamed words to be available
+ *
+ * @param timeout How long to wait
+ * @return int 0=words available, -EAGAIN timed out
+ */
+int isense_wait(k_timeout_t timeout);
+
+
+/**
+ * @brief Claim streamed words in place, no copy
+ *
+ * @param words Returns pointer to the first claimed word
+ * @param maxWords Most words wanted
+ * @return size_t Words claimed (contiguous, may be fewer than available), 0=none
+ *
+ * @note Single consumer. Claimed words stay valid until isense_release().
+ */
+size_t isense_claim(const uint8_t **words, size_t maxWords);
+
+
+/**
+ * @brief Release claimed words back to the stream
+ *
+ * @param words Number of claimed words consumed
+ */
+void isense_release(size_t words);
+
+
+/**
+ * @brief Get a snapshot of the streaming counters
+ *
+ * @param stats Returns counters
+ */
+void isense_getStats(isense_stats_t *stats);
+
+
+/**
+ * @brief Clear the streaming counters
+ */
+void isense_resetStats(void);
+
+
+/**
+ * @brief Tag (sensor) of a stream word
+ *
+ * @param word Stream word
+ * @return uint8_t ISENSE_TAG_x
+ */
+static inline uint8_t isense_wordTag(const uint8_t *word)
+{
+    return word[0] >> 3;
+}
+
+
+/**
+ * @brief Decode an accel or gyro word to raw axis values
+ *
+ * @param word Stream word (ISENSE_TAG_ACCEL or ISENSE_TAG_GYRO)
+ * @param xyz Returns raw x, y, z (scale per configured full scale)
+ */
+static inline void isense_wordAxes(const uint8_t *word, int16_t xyz[3])
+{
+    xyz[0] = (int16_t)sys_get_le16(&word[1]);
+    xyz[1] = (int16_t)sys_get_le16(&word[3]);
+    xyz[2] = (int16_t)sys_get_le16(&word[5]);
+}
+
+
+/**
+ * @brief Decode a BMP581 word
+ *
+ * @param word Stream word (ISENSE_TAG_BMP581)
+ * @param temperature Returns temperature, 1/65536 C
+ * @param pressure Returns pressure, 1/64 Pa
+ */
+static inline void isense_wordBmp(const uint8_t *word, int32_t *temperature, uint32_t *pressure)
+{
+    *temperature = ((int32_t)(sys_get_le24(&word[1]) << 8)) >> 8;     // sign extend 24 bits
+    *pressure = sys_get_le24(&word[4]);
+}
+
+#endif
@@ -0,0 +1,577 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/ring_buffer.h>
+
+#include "isense.h"
+#include "hx-bus.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(isense, CONFIG_ISENSE_LOG_LEVEL);
+
+#define ISM_ADDR DT_REG_ADDR(DT_NODELABEL(isense_ism))
+#define BMP_NODE DT_NODELABEL(isense_bmp)
+#define BMP_PRESENT DT_NODE_HAS_STATUS(BMP_NODE, okay)
+#define BMP_ADDR COND_CODE_1(BMP_PRESENT, (DT_REG_ADDR(BMP_NODE)), (0))
+
+/* ISM330DHCX registers
+ */
+#define ISM_REG_FIFO_CTRL1 0x07                         // FIFO_CTRL1-4 written as one burst
+#define ISM_REG_WHO_AM_I 0x0f
+#define ISM_REG_CTRL1_XL 0x10                           // CTRL1_XL, CTRL2_G, CTRL3_C written as one burst
+#define ISM_REG_CTRL10_C 0x19
+#define ISM_REG_FIFO_STATUS1 0x3a
+#define ISM_REG_FIFO_DATA_OUT_TAG 0x78                  // burst reads roll back to TAG after each 7 byte word
+
+#define ISM_WHO_AM_I 0x6b
+#define ISM_CTRL3_C_BDU 0x40
+#define ISM_CTRL3_C_IF_INC 0x04
+#define ISM_FS_XL_4G 0x08
+#define ISM_FS_G_500DPS 0x04
+#define ISM_CTRL10_C_TIMESTAMP_EN 0x20
+#define ISM_FIFO_TS_BATCH_8 0x80                        // DEC_TS_BATCH: timestamp word every 8 samples
+#define ISM_FIFO_MODE_CONTINUOUS 0x06
+#define ISM_FIFO_DIFF_MASK 0x03ff
+#define ISM_FIFO_OVR_IA 0x4000                          // FIFO_STATUS2 bit 6, status read as little endian 16 bits
+
+/* BMP581 registers
+ */
+#define BMP_REG_CHIP_ID 0x01
+#define BMP_REG_TEMP_DATA 0x1d                          // temperature 0x1d-0x1f, pressure 0x20-0x22
+#define BMP_REG_OSR_CONFIG 0x36
+#define BMP_REG_ODR_CONFIG 0x37
+
+#define BMP_CHIP_ID 0x50
+#define BMP_OSR_PRESS_EN 0x40                           // pressure enabled, x1 oversampling
+#define BMP_ODR_DEEP_DIS 0x80
+#define BMP_PWR_FORCED 0x02
+
+static const uint32_t isense_odrMilliHz[] = { 0, 12500, 26000, 52000, 104000, 208000, 416000, 833000 };
+
+RING_BUF_DECLARE(isense_ring, CONFIG_ISENSE_RING_WORDS * ISENSE_WORD_SIZE);     // word multiple: claims never split a word
+
+static struct
+{
+    struct k_spinlock lock;                             // guards ring (producer: HX bus thread, consumer: app) and stats
+    struct k_sem dataReady;
+    struct k_sem chainEnded;                            // given when a drain chain ends, isense_stop() waits on it
+    struct k_work_delayable pollWork;                   // FIFO drain timer
+    struct k_work_delayable bmpWork;                    // BMP581 trigger/read timer
+    uint32_t pollMs;
+    uint16_t bmpPeriodMs;
+    bool running;
+    bool draining;                                      // FIFO status/data chain in progress (HX bus thread)
+    bool bmpTriggered;                                  // conversion started, read next
+    bool bmpPending;                                    // bmpWord waiting for the drain chain to finish
+    uint16_t fifoStatus;
+    size_t remaining;                                   // FIFO words left in this drain
+    hxbus_xfer_t statusXfer;
+    hxbus_xfer_t dataXfer;
+    hxbus_xfer_t bmpCmdXfer;
+    hxbus_xfer_t bmpReadXfer;
+    uint8_t bmpWord[ISENSE_WORD_SIZE];
+    isense_stats_t stats;
+} isense;
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static int writeRegs(uint16_t addr, uint8_t reg, const uint8_t *vals, size_t len);
+static int readRegs(uint16_t addr, uint8_t reg, uint8_t *buf, size_t len);
+static void poll_handler(struct k_work *work);
+static void statusDone(hxbus_xfer_t *xfer, int result, void *userData);
+static void drainNext(void);
+static void chainEnd(void);
+static void dataDone(hxbus_xfer_t *xfer, int result, void *userData);
+static void bmp_handler(struct k_work *work);
+static void bmpDone(hxbus_xfer_t *xfer, int result, void *userData);
+static void bmpPut(void);
+static void statsCpu(uint32_t startCycles);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Configure the ISense sensors and start streaming
+ *
+ * @param config Rates and batching
+ * @return int 0=streaming
+ */
+int isense_start(const isense_config_t *config)
+{
+    uint8_t id;
+    uint32_t wordsPerKs;
+    int ret;
+
+    if (config->odr < ISENSE_ODR_12HZ5 || config->odr > ISENSE_ODR_833HZ || config->watermark == 0 ||
+        config->watermark > ISM_FIFO_DIFF_MASK)
+    {
+        return -EINVAL;
+    }
+    if (isense.running)
+    {
+        return -EALREADY;
+    }
+    if (isense.draining)
+    {
+        return -EBUSY;                                                      // previous run's chain still on the HX bus
+    }
+
+    ret = readRegs(ISM_ADDR, ISM_REG_WHO_AM_I, &id, 1);
+    if (ret != 0 || id != ISM_WHO_AM_I)
+    {
+        LOG_ERR("ISM330DHCX not found (id=0x%02x, err=%d)", id, ret);
+        return -ENODEV;
+    }
+
+    const uint8_t ctrl[3] =
+    {
+        (config->odr << 4) | ISM_FS_XL_4G,
+        (config->odr << 4) | ISM_FS_G_500DPS,
+        ISM_CTRL3_C_BDU | ISM_CTRL3_C_IF_INC,
+    };
+    const uint8_t ctrl10 = ISM_CTRL10_C_TIMESTAMP_EN;
+    const uint8_t fifo[4] =
+    {
+        config->watermark & 0xff,
+        config->watermark >> 8,
+        (config->odr << 4) | config->odr,                                   // gyro and accel batch rate = ODR
+        ISM_FIFO_TS_BATCH_8 | ISM_FIFO_MODE_CONTINUOUS,
+    };
+
+    ret = writeRegs(ISM_ADDR, ISM_REG_CTRL1_XL, ctrl, sizeof(ctrl));
+    if (ret == 0)
+    {
+        ret = writeRegs(ISM_ADDR, ISM_REG_CTRL10_C, &ctrl10, 1);
+    }
+    if (ret == 0)
+    {
+        ret = writeRegs(ISM_ADDR, ISM_REG_FIFO_CTRL1, fifo, sizeof(fifo));
+    }
+    if (ret != 0)
+    {
+        LOG_ERR("ISM330DHCX configuration failed, err=%d", ret);
+        return ret;
+    }
+
+    isense.bmpPeriodMs = 0;
+    if (BMP_PRESENT && config->bmpPeriodMs > 0)
+    {
+        const uint8_t bmpConfig[2] = { BMP_OSR_PRESS_EN, BMP_ODR_DEEP_DIS };   // OSR, ODR (standby)
+
+        ret = readRegs(BMP_ADDR, BMP_REG_CHIP_ID, &id, 1);
+        if (ret == 0 && id == BMP_CHIP_ID)
+        {
+            ret = writeRegs(BMP_ADDR, BMP_REG_OSR_CONFIG, bmpConfig, sizeof(bmpConfig));
+        }
+        if (ret == 0 && id == BMP_CHIP_ID)
+        {
+            isense.bmpPeriodMs = MAX(config->bmpPeriodMs, 2 * CONFIG_ISENSE_BMP_CONVERSION_MS);
+        }
+        else
+        {
+            LOG_WRN("BMP581 not available (id=0x%02x, err=%d), streaming ISM330 only", id, ret);
+        }
+    }
+
+    /* Drain when the FIFO reaches the watermark: accel + gyro word per sample, timestamp word every 8 */
+    wordsPerKs = isense_odrMilliHz[config->odr] * 17 / 8;
+    isense.pollMs = MAX(1U, (uint32_t)(((uint64_t)config->watermark * 1000000U) / wordsPerKs));
+
+    k_sem_init(&isense.dataReady, 0, 1);
+    k_sem_init(&isense.chainEnded, 0, 1);
+    k_work_init_delayable(&isense.pollWork, poll_handler);
+    k_work_init_delayable(&isense.bmpWork, bmp_handler);
+    isense.draining = false;
+    isense.bmpTriggered = false;
+    isense.bmpPending = false;
+    isense_resetStats();
+    isense.running = true;
+
+    k_work_schedule(&isense.pollWork, K_MSEC(isense.pollMs));
+    if (isense.bmpPeriodMs > 0)
+    {
+        k_work_schedule(&isense.bmpWork, K_NO_WAIT);
+    }
+    LOG_INF("ISense streaming, drain every %u ms", isense.pollMs);
+    return 0;
+}
+
+
+/**
+ * @brief Stop streaming and power down the sensors
+ *
+ * A drain chain underway ends at its next burst, the call returns once it has. All power down
+ * writes are attempted, the first error is returned.
+ *
+ * @return int 0=success
+ */
+int isense_stop(void)
+{
+    struct k_work_sync sync;
+    const uint8_t off[2] = { 0, 0 };
+    const uint8_t bypass = 0;
+    const uint8_t standby = BMP_ODR_DEEP_DIS;
+    int ret;
+    int err;
+
+    if (!isense.running)
+    {
+        return 0;
+    }
+    isense.running = false;
+    k_work_cancel_delayable_sync(&isense.pollWork, &sync);                     // no new chain starts
+    k_work_cancel_delayable_sync(&isense.bmpWork, &sync);
+    while (isense.draining)
+    {
+        (void)k_sem_take(&isense.chainEnded, K_FOREVER);                       // chain transfers have deadlines, it ends
+    }
+
+    ret = writeRegs(ISM_ADDR, ISM_REG_FIFO_CTRL1 + 3, &bypass, 1);             // FIFO_CTRL4: bypass
+    err = writeRegs(ISM_ADDR, ISM_REG_CTRL1_XL, off, sizeof(off));             // accel, gyro power down
+    ret = (ret != 0) ? ret : err;
+    if (isense.bmpPeriodMs > 0)
+    {
+        err = writeRegs(BMP_ADDR, BMP_REG_ODR_CONFIG, &standby, 1);
+        ret = (ret != 0) ? ret : err;
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Wait for streamed words
+ *
+ * @param timeout How long to wait
+ * @return int 0=words available
+ */
+int isense_wait(k_timeout_t timeout)
+{
+    if (!ring_buf_is_empty(&isense_ring))
+    {
+        return 0;
+    }
+    return k_sem_take(&isense.dataReady, timeout);
+}
+
+
+/**
+ * @brief Claim streamed words in place
+ *
+ * @param words Returns pointer to the first word
+ * @param maxWords Most words wanted
+ * @return size_t Words claimed
+ */
+size_t isense_claim(const uint8_t **words, size_t maxWords)
+{
+    k_spinlock_key_t key = k_spin_lock(&isense.lock);
+    uint8_t *data;
+    uint32_t bytes = ring_buf_get_claim(&isense_ring, &data, maxWords * ISENSE_WORD_SIZE);
+
+    k_spin_unlock(&isense.lock, key);
+    *words = data;
+    return bytes / ISENSE_WORD_SIZE;
+}
+
+
+/**
+ * @brief Release claimed words
+ *
+ * @param words Words consumed
+ */
+void isense_release(size_t words)
+{
+    k_spinlock_key_t key = k_spin_lock(&isense.lock);
+
+    (void)ring_buf_get_finish(&isense_ring, words * ISENSE_WORD_SIZE);
+    k_spin_unlock(&isense.lock, key);
+}
+
+
+/**
+ * @brief Get a snapshot of the streaming counters
+ *
+ * @param stats Returns counters
+ */
+void isense_getStats(isense_stats_t *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&isense.lock);
+
+    *stats = isense.stats;
+    k_spin_unlock(&isense.lock, key);
+}
+
+
+/**
+ * @brief Clear the streaming counters
+ */
+void isense_resetStats(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&isense.lock);
+
+    memset(&isense.stats, 0, sizeof(isense.stats));
+    k_spin_unlock(&isense.lock, key);
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Blocking register write on the HX bus (configuration)
+ */
+static int writeRegs(uint16_t addr, uint8_t reg, const uint8_t *vals, size_t len)
+{
+    hxbus_xfer_t xfer;
+
+    hxbus_initWrite(&xfer, addr, reg, vals, len, HXBUS_PRIO_CONTROL);
+    return hxbus_transfer(&xfer, K_FOREVER);
+}
+
+
+/**
+ * @brief Blocking register read on the HX bus (configuration)
+ */
+static int readRegs(uint16_t addr, uint8_t reg, uint8_t *buf, size_t len)
+{
+    hxbus_xfer_t xfer;
+
+    hxbus_initRead(&xfer, addr, reg, buf, len, HXBUS_PRIO_CONTROL);
+    return hxbus_transfer(&xfer, K_FOREVER);
+}
+
+
+/**
+ * @brief Drain timer, reads the FIFO level (the drain chain continues in HX bus callbacks)
+ *
+ * @param work Poll work item
+ */
+static void poll_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    if (!isense.running)
+    {
+        return;
+    }
+    k_work_schedule(&isense.pollWork, K_MSEC(isense.pollMs));
+    if (isense.draining)
+    {
+        return;                                                             // previous drain still running, bus saturated
+    }
+
+    isense.draining = true;
+    hxbus_initRead(&isense.statusXfer, ISM_ADDR, ISM_REG_FIFO_STATUS1, (uint8_t *)&isense.fifoStatus, sizeof(isense.fifoStatus), HXBUS_PRIO_SENSOR);
+    if (hxbus_submit(&isense.statusXfer, K_MSEC(isense.pollMs), statusDone, NULL) != 0)
+    {
+        chainEnd();
+    }
+}
+
+
+/**
+ * @brief FIFO level read complete, start draining
+ */
+static void statusDone(hxbus_xfer_t *xfer, int result, void *userData)
+{
+    uint32_t start = k_cycle_get_32();
+    uint16_t status = sys_le16_to_cpu(isense.fifoStatus);
+
+    ARG_UNUSED(xfer);
+    ARG_UNUSED(userData);
+
+    if (result != 0)
+    {
+        chainEnd();
+        return;
+    }
+    if (status & ISM_FIFO_OVR_IA)
+    {
+        isense.stats.fifoOverruns++;
+    }
+    isense.remaining = status & ISM_FIFO_DIFF_MASK;
+    drainNext();
+    statsCpu(start);
+}
+
+
+/**
+ * @brief Burst read the next run of FIFO words directly into ring buffer space
+ *
+ * Runs in the HX bus thread (single producer), ends the chain when the drain is complete or
+ * streaming was stopped.
+ */
+static void drainNext(void)
+{
+    k_spinlock_key_t key;
+    uint8_t *space;
+    uint32_t bytes;
+    size_t words = isense.running ? MIN(isense.remaining, CONFIG_ISENSE_BURST_WORDS) : 0;
+
+    if (words > 0)
+    {
+        key = k_spin_lock(&isense.lock);
+        bytes = ring_buf_put_claim(&isense_ring, &space, words * ISENSE_WORD_SIZE);
+        if (bytes == 0)
+        {
+            isense.stats.ringDrops += isense.remaining;                     // consumer behind, samples stay in the FIFO
+            (void)ring_buf_put_finish(&isense_ring, 0);
+        }
+        k_spin_unlock(&isense.lock, key);
+
+        if (bytes > 0)
+        {
+            hxbus_initRead(&isense.dataXfer, ISM_ADDR, ISM_REG_FIFO_DATA_OUT_TAG, space, bytes, HXBUS_PRIO_SENSOR);
+            if (hxbus_submit(&isense.dataXfer, K_MSEC(isense.pollMs), dataDone, NULL) == 0)
+            {
+                return;
+            }
+            key = k_spin_lock(&isense.lock);
+            (void)ring_buf_put_finish(&isense_ring, 0);
+            k_spin_unlock(&isense.lock, key);
+        }
+    }
+
+    chainEnd();
+}
+
+
+/**
+ * @brief End the drain chain: insert a waiting BMP581 word, release isense_stop()
+ */
+static void chainEnd(void)
+{
+    isense.draining = false;                                                // chain done, the ring is free for a BMP581 word
+    if (isense.bmpPending)
+    {
+        bmpPut();
+    }
+    k_sem_give(&isense.chainEnded);
+}
+
+
+/**
+ * @brief FIFO data burst complete, commit the words to the ring
+ */
+static void dataDone(hxbus_xfer_t *xfer, int result, void *userData)
+{
+    uint32_t start = k_cycle_get_32();
+    size_t words = (result == 0) ? xfer->len / ISENSE_WORD_SIZE : 0;
+    k_spinlock_key_t key;
+
+    ARG_UNUSED(userData);
+
+    key = k_spin_lock(&isense.lock);
+    (void)ring_buf_put_finish(&isense_ring, words * ISENSE_WORD_SIZE);
+    isense.stats.words += words;
+    isense.stats.bursts++;
+    k_spin_unlock(&isense.lock, key);
+
+    if (words > 0)
+    {
+        k_sem_give(&isense.dataReady);
+    }
+    isense.remaining = (result == 0) ? isense.remaining - words : 0;
+    drainNext();
+    statsCpu(start);
+}
+
+
+/**
+ * @brief BMP581 timer: alternately start a forced conversion and read its result
+ *
+ * @param work BMP work item
+ */
+static void bmp_handler(struct k_work *work)
+{
+    static const uint8_t forced = BMP_ODR_DEEP_DIS | BMP_PWR_FORCED;
+
+    ARG_UNUSED(work);
+
+    if (!isense.running)
+    {
+        return;
+    }
+    if (!isense.bmpTriggered)
+    {
+        hxbus_initWrite(&isense.bmpCmdXfer, BMP_ADDR, BMP_REG_ODR_CONFIG, &forced, 1, HXBUS_PRIO_SENSOR);
+        isense.bmpTriggered = (hxbus_submit(&isense.bmpCmdXfer, K_FOREVER, NULL, NULL) == 0);
+        k_work_schedule(&isense.bmpWork, K_MSEC(isense.bmpTriggered ? CONFIG_ISENSE_BMP_CONVERSION_MS : isense.bmpPeriodMs));
+    }
+    else
+    {
+        isense.bmpTriggered = false;
+        if (!isense.bmpPending)                                             // previous word not yet inserted: skip this sample
+        {
+            hxbus_initRead(&isense.bmpReadXfer, BMP_ADDR, BMP_REG_TEMP_DATA, &isense.bmpWord[1], ISENSE_WORD_SIZE - 1, HXBUS_PRIO_SENSOR);
+            (void)hxbus_submit(&isense.bmpReadXfer, K_FOREVER, bmpDone, NULL);
+        }
+        k_work_schedule(&isense.bmpWork, K_MSEC(isense.bmpPeriodMs - CONFIG_ISENSE_BMP_CONVERSION_MS));
+    }
+}
+
+
+/**
+ * @brief BMP581 result read, insert into the stream (or wait for the drain chain)
+ */
+static void bmpDone(hxbus_xfer_t *xfer, int result, void *userData)
+{
+    ARG_UNUSED(xfer);
+    ARG_UNUSED(userData);
+
+    if (result != 0 || !isense.running)
+    {
+        return;
+    }
+    isense.bmpWord[0] = ISENSE_TAG_BMP581 << 3;
+    isense.bmpPending = true;
+    if (!isense.draining)                                                   // no ring claim outstanding
+    {
+        bmpPut();
+    }
+}
+
+
+/**
+ * @brief Copy the BMP581 word into the ring (HX bus thread, no claim outstanding)
+ */
+static void bmpPut(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&isense.lock);
+    uint32_t put = ring_buf_put(&isense_ring, isense.bmpWord, ISENSE_WORD_SIZE);
+
+    if (put == ISENSE_WORD_SIZE)
+    {
+        isense.stats.bmpSamples++;
+    }
+    else
+    {
+        isense.stats.ringDrops++;
+    }
+    k_spin_unlock(&isense.lock, key);
+
+    isense.bmpPending = false;
+    k_sem_give(&isense.dataReady);
+}
+
+
+/**
+ * @brief Add callback execution time to the CPU counter
+ *
+ * @param startCycles Cycle count at callback start
+ */
+static void statsCpu(uint32_t startCycles)
+{
+    k_spinlock_key_t key = k_spin_lock(&isense.lock);
+
+    isense.stats.cpuUs += k_cyc_to_us_floor32(k_cycle_get_32() - startCycles);
+    k_spin_unlock(&isense.lock, key);
+}
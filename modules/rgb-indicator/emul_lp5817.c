@@ -0,0 +1,239 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT ti_lp5817
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/emul_stub_device.h>
+
+#include "include/rgb-indicator.h"
+#include "include/emul_lp5817.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(emul_lp5817, CONFIG_RGBINDICATOR_LOG_LEVEL);
+
+#define LP5817_EMUL_BUS_HZ 100000                                       // HX bus, LP5817 is standard mode only
+#define LP5817_EMUL_BITS_PER_BYTE 9                                     // 8 data + ACK
+#define LP5817_EMUL_FRAME_BITS 2                                        // START/RESTART + STOP per message
+
+struct lp5817_emulData
+{
+    struct k_spinlock lock;
+    uint8_t regs[EMUL_LP5817_REG_COUNT];
+    uint8_t pointer;                                                    // register address pointer, auto-increments
+    bool animating;
+    uint32_t failCount;
+    emul_lp5817_stats_t stats;
+};
+
+struct lp5817_emulConfig
+{
+    uint16_t addr;
+};
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+uint8_t emul_lp5817_getReg(const struct emul *target, uint8_t reg)
+{
+    struct lp5817_emulData *data = target->data;
+
+    return (reg < EMUL_LP5817_REG_COUNT) ? data->regs[reg] : 0;
+}
+
+
+void emul_lp5817_getStats(const struct emul *target, emul_lp5817_stats_t *stats)
+{
+    struct lp5817_emulData *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+    *stats = data->stats;
+    k_spin_unlock(&(data->lock), key);
+}
+
+
+void emul_lp5817_resetStats(const struct emul *target)
+{
+    struct lp5817_emulData *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+    memset(&(data->stats), 0, sizeof(data->stats));
+    k_spin_unlock(&(data->lock), key);
+}
+
+
+bool emul_lp5817_isAnimating(const struct emul *target)
+{
+    struct lp5817_emulData *data = target->data;
+
+    return data->animating;
+}
+
+
+void emul_lp5817_failNext(const struct emul *target, uint32_t count)
+{
+    struct lp5817_emulData *data = target->data;
+
+    data->failCount = count;
+}
+
+
+/* Emulator
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Apply a register write, command registers act instead of storing
+ */
+static void lp5817_emulWrite(struct lp5817_emulData *data, uint8_t reg, uint8_t val)
+{
+    switch (reg)
+    {
+        case LP5817_REG_UPDATE:
+            if (val == LP5817_CMD_UPDATE)
+            {
+                data->stats.updateCmds++;
+            }
+            break;
+
+        case LP5817_REG_START:
+            if (val == LP5817_CMD_START)
+            {
+                data->animating = (data->regs[LP5817_REG_AUTOENABLE] != 0);
+            }
+            break;
+
+        case LP5817_REG_STOP:
+            if (val == LP5817_CMD_STOP)
+            {
+                data->animating = false;
+            }
+            break;
+
+        case LP5817_REG_CHIPENABLE:
+            if ((val ^ data->regs[reg]) & LP5817_CMD_CHIPENABLE)
+            {
+                if (val & LP5817_CMD_CHIPENABLE)
+                {
+                    data->stats.chipEnables++;
+                }
+                else
+                {
+                    data->stats.chipDisables++;
+                }
+            }
+            data->regs[reg] = val;
+            break;
+
+        default:
+            data->regs[reg] = val;
+            break;
+    }
+}
+
+
+static int lp5817_emulTransfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+    struct lp5817_emulData *data = target->data;
+    int ret = 0;
+    k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+    data->stats.transactions++;
+    if (data->failCount > 0)
+    {
+        data->failCount--;
+        data->stats.naks++;
+        data->stats.busTimeUs += (LP5817_EMUL_BITS_PER_BYTE + LP5817_EMUL_FRAME_BITS) * 1000000ULL / LP5817_EMUL_BUS_HZ;
+        k_spin_unlock(&(data->lock), key);
+        return -EIO;                                                    // address NAK
+    }
+
+#if defined(CONFIG_EMUL_LP5817_BUS_TIME)
+    uint64_t busTimeUs = data->stats.busTimeUs;
+#endif
+
+    for (int m = 0; m < num_msgs; m++)
+    {
+        struct i2c_msg *msg = &msgs[m];
+        uint32_t i = 0;
+
+        data->stats.messages++;
+        data->stats.busTimeUs += ((1 + msg->len) * LP5817_EMUL_BITS_PER_BYTE + LP5817_EMUL_FRAME_BITS) * 1000000ULL / LP5817_EMUL_BUS_HZ;
+
+        if ((msg->flags & I2C_MSG_RW_MASK) == I2C_MSG_READ)
+        {
+            for (; i < msg->len; i++)
+            {
+                msg->buf[i] = data->regs[data->pointer++ % EMUL_LP5817_REG_COUNT];
+            }
+            data->stats.bytesRead += msg->len;
+            continue;
+        }
+
+        data->stats.bytesWritten += msg->len;
+        if (msg->len > 0 && (m == 0 || (msg->flags & I2C_MSG_RESTART)))  // first byte of a write sets the pointer
+        {
+            data->pointer = msg->buf[i++];
+        }
+        for (; i < msg->len; i++)
+        {
+            if (data->pointer >= EMUL_LP5817_REG_COUNT)
+            {
+                ret = -EIO;                                             // data NAK past register file
+                break;
+            }
+            lp5817_emulWrite(data, data->pointer++, msg->buf[i]);
+        }
+    }
+#if defined(CONFIG_EMUL_LP5817_BUS_TIME)
+    k_busy_wait((uint32_t)(data->stats.busTimeUs - busTimeUs));          // lock held, the bus is busy for everyone
+#endif
+    k_spin_unlock(&(data->lock), key);
+    return ret;
+}
+
+
+static int lp5817_emulInit(const struct emul *target, const struct device *parent)
+{
+    struct lp5817_emulData *data = target->data;
+
+    ARG_UNUSED(parent);
+    memset(data->regs, 0, sizeof(data->regs));
+    data->pointer = 0;
+    data->animating = false;
+    data->failCount = 0;
+    memset(&(data->stats), 0, sizeof(data->stats));
+    return 0;
+}
+
+
+static const struct i2c_emul_api lp5817_emulApi =
+{
+    .transfer = lp5817_emulTransfer,
+};
+
+
+#define LP5817_EMUL(n)                                                                              \
+    static struct lp5817_emulData lp5817_emulData_##n;                                              \
+    static const struct lp5817_emulConfig lp5817_emulConfig_##n =                                   \
+    {                                                                                               \
+        .addr = DT_INST_REG_ADDR(n),                                                                \
+    };                                                                                              \
+    EMUL_DT_INST_DEFINE(n, lp5817_emulInit, &lp5817_emulData_##n, &lp5817_emulConfig_##n,           \
+                        &lp5817_emulApi, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(LP5817_EMUL)
+
+#if !defined(CONFIG_RGBINDICATOR_LP5817)
+#define LP5817_EMUL_STUB(n) EMUL_STUB_DEVICE(DT_DRV_INST(n))              // no devicetree driver, tests reach the chip with rgbi_init()
+
+DT_INST_FOREACH_STATUS_OKAY(LP5817_EMUL_STUB)
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EMUL_LP5817
+#define EMUL_LP5817
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/drivers/emul.h>
+
+/* LP5817 I2C emulator (native_sim), models the register file, command registers and the
+ * animation engine run state. Counts bus activity so driver changes can be compared without
+ * hardware.
+ */
+
+#define EMUL_LP5817_REG_COUNT 0x40
+
+typedef struct _emul_lp5817_stats
+{
+    uint32_t transactions;                              // i2c_transfer calls addressed to the chip
+    uint32_t messages;                                  // I2C messages (START/RESTART + address each)
+    uint32_t bytesWritten;                              // data bytes, excluding address bytes
+    uint32_t bytesRead;
+    uint32_t updateCmds;                                // UPDATE commands received
+    uint32_t chipEnables;                               // CHIP_EN set, wake from standby
+    uint32_t chipDisables;                              // CHIP_EN cleared, standby
+    uint32_t naks;                                      // transfers failed by fault injection
+    uint64_t busTimeUs;                                 // simulated time on a 100kHz bus
+} emul_lp5817_stats_t;
+
+
+/**
+ * @brief Get an emulated register value
+ * 
+ * @param target LP5817 emulator (EMUL_DT_GET)
+ * @param reg Register address
+ * @return uint8_t Register value
+ */
+uint8_t emul_lp5817_getReg(const struct emul *target, uint8_t reg);
+
+
+/**
+ * @brief Get bus activity counters
+ * 
+ * @param target LP5817 emulator
+ * @param stats Returns counters since init or last reset
+ */
+void emul_lp5817_getStats(const struct emul *target, emul_lp5817_stats_t *stats);
+
+
+/**
+ * @brief Clear bus activity counters, register state is kept
+ * 
+ * @param target LP5817 emulator
+ */
+void emul_lp5817_resetStats(const struct emul *target);
+
+
+/**
+ * @brief Determine if the emulated animation engine has been started (and not stopped)
+ * 
+ * @param target LP5817 emulator
+ * @return true START received with autonomous outputs enabled
+ * @return false Engine stopped, outputs follow manual intensity registers
+ */
+bool emul_lp5817_isAnimating(const struct emul *target);
+
+
+/**
+ * @brief Inject failures: the next count transfers are NAKed (-EIO)
+ * 
+ * @param target LP5817 emulator
+ * @param count Number of transfers to fail
+ */
+void emul_lp5817_failNext(const struct emul *target, uint32_t count);
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RGB_INDICATOR_PATTERN
+#define RGB_INDICATOR_PATTERN
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Keyframe patterns for the indicator sequencer
+ *
+ * A pattern is a const table of steps (lives in flash), built with the RGBI_STEP_* macros:
+ *
+ *   RGBI_PATTERN_DEFINE(heartbeat,
+ *       RGBI_STEP_REPEAT(0),                      // forever
+ *           RGBI_STEP_FADE(120, 0, 0, 150),       // fade to red over 150ms
+ *           RGBI_STEP_FADE(0, 0, 0, 250),         // fade to off
+ *           RGBI_STEP_HOLD(600),
+ *       RGBI_STEP_END_REPEAT()
+ *   );
+ *
+ *   rgbi_play(&rgbi, heartbeat);
+ *
+ * Repeats can be nested up to CONFIG_RGBINDICATOR_SEQUENCER_DEPTH levels.
+ */
+
+#define RGBI_OP_END 0                               // end of pattern, indicator left at last color
+#define RGBI_OP_SET 1                               // set color then hold for ms
+#define RGBI_OP_FADE 2                              // linear fade from current color to color over ms
+#define RGBI_OP_HOLD 3                              // keep current color for ms
+#define RGBI_OP_REPEAT 4                            // start of repeated block, count in r (0=forever)
+#define RGBI_OP_END_REPEAT 5                        // end of repeated block
+
+typedef struct _rgbi_step
+{
+    uint8_t op;                                     // RGBI_OP_*
+    uint8_t r;                                      // target color (SET/FADE) or repeat count (REPEAT)
+    uint8_t g;
+    uint8_t b;
+    uint16_t ms;                                    // hold/fade duration
+} rgbi_step_t;
+
+#define RGBI_STEP_SET(_r, _g, _b, _ms) { .op = RGBI_OP_SET, .r = (_r), .g = (_g), .b = (_b), .ms = (_ms) }
+#define RGBI_STEP_FADE(_r, _g, _b, _ms) { .op = RGBI_OP_FADE, .r = (_r), .g = (_g), .b = (_b), .ms = (_ms) }
+#define RGBI_STEP_HOLD(_ms) { .op = RGBI_OP_HOLD, .ms = (_ms) }
+#define RGBI_STEP_REPEAT(_count) { .op = RGBI_OP_REPEAT, .r = (_count) }
+#define RGBI_STEP_END_REPEAT() { .op = RGBI_OP_END_REPEAT }
+
+#define RGBI_PATTERN_DEFINE(_name, ...) \
+    const rgbi_step_t _name[] = { __VA_ARGS__, { .op = RGBI_OP_END } }
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+#define RGBI_SEQ_DEPTH CONFIG_RGBINDICATOR_SEQUENCER_DEPTH
+#else
+#define RGBI_SEQ_DEPTH 1
+#endif
+
+/* Sequencer cursor, the only per-indicator RAM a running pattern needs
+ */
+typedef struct _rgbi_seqCursor
+{
+    const rgbi_step_t *pattern;                     // NULL when no pattern is playing
+    uint8_t pc;                                     // current step index
+    uint8_t depth;                                  // active repeat nesting
+    uint8_t loopStart[RGBI_SEQ_DEPTH];              // step index of first step in repeated block
+    uint8_t loopLeft[RGBI_SEQ_DEPTH];               // passes remaining, 0=forever
+    uint16_t elapsed;                               // ms into current fade
+    uint8_t from[3];                                // fade start color (r, g, b)
+    uint8_t out[3];                                 // last color output (r, g, b)
+    bool outValid;                                  // out[] reflects the chip
+} rgbi_seqCursor_t;
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RGB_INDICATOR_SERVICE
+#define RGB_INDICATOR_SERVICE
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "rgb-indicator.h"
+
+
+/* Status indicator service (zbus)
+ *
+ * Applications publish state on zbus channels and never call the indicator: the service observes
+ * the bound channels and one service thread turns state changes into indicator displays. Each
+ * binding maps a channel's state value (first message byte) through a const table to what is
+ * displayed, bindings hold an arbitration slot at their priority so the most important state
+ * wins (see rgbi_slotInit). Bursts of state changes are coalesced: the displayed state is updated
+ * at most once per CONFIG_RGBINDICATOR_SERVICE_FRAME_MS, using the latest value of each channel.
+ *
+ * Channel messages are read in place (zbus claim), publishing costs the producer the message copy
+ * into the channel and a notification, independent of indicator or I2C activity.
+ *
+ *   static const rgbi_svcState_t cellStates[] =
+ *   {
+ *       [CELL_SEARCHING] = RGBI_SVC_FLASH(RGB(0, 0, 100), 200, 800, 0),
+ *       [CELL_CONNECTED] = RGBI_SVC_COLOR(RGB(0, 100, 0)),
+ *       [CELL_OFF]       = RGBI_SVC_OFF(),
+ *   };
+ *   static const rgbi_svcBinding_t bindings[] =
+ *   {
+ *       { &cell_state_chan, 10, cellStates, ARRAY_SIZE(cellStates) },
+ *       { &fault_chan, 30, faultStates, ARRAY_SIZE(faultStates) },
+ *   };
+ *   rgbi_svcStart(rgbi_fromDevice(DEVICE_DT_GET(DT_NODELABEL(rgbctrl))), bindings, ARRAY_SIZE(bindings));
+ */
+
+/* Display for one state value
+ */
+typedef struct _rgbi_svcState
+{
+    uint8_t op;                                         // rgbi_cmdOp_t: SET, FLASH, PLAY or CANCEL (no display, lower priorities show)
+    uint8_t count;                                      // FLASH count, 0=continuous
+    struct led_rgb pixels;                              // SET/FLASH color
+    uint16_t onMs;                                      // FLASH on time
+    uint16_t offMs;                                     // FLASH off time
+    const rgbi_step_t *pattern;                         // PLAY pattern (CONFIG_RGBINDICATOR_SEQUENCER)
+} rgbi_svcState_t;
+
+#define RGBI_SVC_OFF() { .op = RGBI_CMD_CANCEL }
+#define RGBI_SVC_COLOR(_rgb) { .op = RGBI_CMD_SET, .pixels = _rgb }
+#define RGBI_SVC_FLASH(_rgb, _onMs, _offMs, _count) { .op = RGBI_CMD_FLASH, .pixels = _rgb, .onMs = _onMs, .offMs = _offMs, .count = _count }
+#define RGBI_SVC_PLAY(_pattern) { .op = RGBI_CMD_PLAY, .pattern = _pattern }
+
+/* Channel to display mapping, channel message starts with a uint8_t state value
+ */
+typedef struct _rgbi_svcBinding
+{
+    const struct zbus_channel *chan;
+    uint8_t priority;                                   // arbitration slot priority 0-31, unique per binding
+    const rgbi_svcState_t *states;                      // indexed by state value
+    uint8_t stateCount;                                 // values >= stateCount display nothing (like RGBI_SVC_OFF)
+} rgbi_svcBinding_t;
+
+/* Service counters since start or rgbi_svcResetStats()
+ */
+typedef struct _rgbi_svcStats
+{
+    uint32_t notifications;                             // channel publications observed
+    uint32_t coalesced;                                 // publications superseded within a frame
+    uint32_t frames;                                    // display updates applied
+} rgbi_svcStats_t;
+
+
+/**
+ * @brief Start the service on an indicator
+ *
+ * @param rgbi The RGB indicator the service drives
+ * @param bindings Channel bindings (const, must remain valid)
+ * @param count Number of bindings (max CONFIG_RGBINDICATOR_SERVICE_BINDINGS)
+ * @return int 0=started, -EALREADY running, -EINVAL bad binding, else zbus observer error
+ */
+int rgbi_svcStart(rgb_indicator_t *rgbi, const rgbi_svcBinding_t *bindings, size_t count);
+
+
+/**
+ * @brief Get a snapshot of the service counters
+ *
+ * @param stats Returns counters
+ */
+void rgbi_svcGetStats(rgbi_svcStats_t *stats);
+
+
+/**
+ * @brief Clear the service counters
+ */
+void rgbi_svcResetStats(void);
+
+#endif
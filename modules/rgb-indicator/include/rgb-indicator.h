@@ -12,12 +12,26 @@
 #include <stdbool.h>
 #include <zephyr/sys_clock.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/dlist.h>
 #include <zephyr/drivers/i2c.h>
 
+#include "rgb-indicator-pattern.h"
+#if defined(CONFIG_RGBINDICATOR_HXBUS)
+#include "hx-bus.h"
+#endif
+
 
 /* Temporary channel assignments, board issue
  * Out-0 = Green, Out-1 = Blue, Out-2 = Red
  * Normal is Red/Green/Blue
+ *
+ * Devicetree instantiated indicators (compatible "ti,lp5817") take the mapping from the
+ * channel-map property, rgbi_init() uses this mapping (see lp5817_defaultConfig).
+ * PWM indicators (compatible "loouq,rgb-indicator-pwm") use the same config: channel-map selects
+ * the pwms entry per color, dot-current and color-scale scale the duty cycle, maxCurrent is unused.
+ * With CONFIG_RGBINDICATOR_SETTINGS a calibration stored with rgbi_setCalibration() (channel
+ * map, currents, color scale) and the user brightness replace these defaults at init.
  */
 
 #define LP5817_REG_CHIPENABLE 0x00
@@ -32,6 +46,30 @@
 #define LP5817_REG_INTENSITY1 0x19
 #define LP5817_REG_INTENSITY2 0x1a
 
+/* Autonomous animation engine, one engine per output
+ * Each engine ramps its output between PWM_LOW and PWM_HIGH: T1 fade up, T2 hold high, 
+ * T3 fade down, T4 hold low; times are 4-bit codes (see lp5817_autoTimeMs[]).
+ */
+#define LP5817_REG_AUTOENABLE 0x03                              // bit per output: 1=engine drives output, 0=manual intensity
+#define LP5817_REG_START 0x10
+#define LP5817_REG_STOP 0x11
+#define LP5817_REG_AUTO_BASE 0x1b                               // OUT0 engine, OUT1/OUT2 follow at LP5817_AUTO_BLOCK_SIZE stride
+#define LP5817_AUTO_PWM_LOW 0                                   // offsets within an engine block
+#define LP5817_AUTO_PWM_HIGH 1
+#define LP5817_AUTO_T12 2                                       // T1 (fade up) code in high nibble, T2 (hold high) low nibble
+#define LP5817_AUTO_T34 3                                       // T3 (fade down) code in high nibble, T4 (hold low) low nibble
+#define LP5817_AUTO_PLAYBACK 4                                  // repeat count 1-14, 15=infinite
+#define LP5817_AUTO_BLOCK_SIZE 5
+
+#define LP5817_CMD_AUTOENABLE 0x07
+#define LP5817_CMD_START 0xff
+#define LP5817_CMD_STOP 0xaa
+#define LP5817_AUTO_PLAYBACK_MAX 14
+#define LP5817_AUTO_PLAYBACK_INFINITE 0x0f
+
+#define LP5817_REG_FILE_SIZE (LP5817_REG_AUTO_BASE + 3 * LP5817_AUTO_BLOCK_SIZE)     // shadowed register span 0x00 - 0x29
+#define LP5817_BURST_MAX (3 * LP5817_AUTO_BLOCK_SIZE)           // largest auto-increment burst sent in one transaction
+
 #define LP5817_CMD_CHIPENABLE 0x01
 #define LP5817_CMD_MAXCURRENT 0x01
 #define LP5817_CMD_MAXCURRENT_0 0xff
@@ -53,38 +91,264 @@ struct led_rgb
 
 typedef uint8_t rgbi_color;
 
+/* Per-board LP5817 configuration, ROM resident (from devicetree for "ti,lp5817" instances),
+ * copied to RAM and overridden by stored settings with CONFIG_RGBINDICATOR_SETTINGS
+ */
+typedef struct _lp5817_config
+{
+    uint8_t channelMap[3];                              // LP5817 output (0-2) wired to red, green, blue
+    uint8_t dotCurrent[3];                              // dot (output) current, indexed by LP5817 output
+    uint8_t colorScale[3];                              // red, green, blue calibration 0-255 (255=unscaled), see CONFIG_RGBINDICATOR_COLOR_LUT
+    uint8_t maxCurrent;                                 // DEV_CONFIG0 max current setting
+} lp5817_config_t;
+
+/* Shadow of the LP5817 register file, holds the last value successfully written to each register.
+ * Writes are compared against the shadow so only changed (dirty) registers are sent to the chip.
+ */
+typedef struct _lp5817_shadow
+{
+    uint8_t regs[LP5817_REG_FILE_SIZE];                 // register values, indexed by register address
+    uint64_t validMask;                                 // bit per register, set when the register value is known
+} lp5817_shadow_t;
+
+#define RGBI_HIST_BUCKETS 10                            // latency histogram: <32us, <64us, ... <8ms, >=8ms
+
+/* Indicator performance counters (CONFIG_RGBINDICATOR_STATS)
+ */
+typedef struct _rgbi_stats
+{
+    uint32_t i2cXfers;                                  // I2C transactions (including retries)
+    uint32_t i2cBytes;                                  // bytes written, including register address
+    uint32_t i2cNaks;                                   // failed transactions (NAK/bus error)
+    uint32_t i2cRetries;                                // failed transactions that were retried
+    uint32_t wakeLatency[RGBI_HIST_BUCKETS];            // timer expiry (ISR) to work handler start
+    uint32_t handlerTime[RGBI_HIST_BUCKETS];            // work handler execution time
+    uint32_t wakeLatencyMaxUs;
+    uint32_t handlerTimeMaxUs;
+} rgbi_stats_t;
+
+/* Expiry scheduler counters (CONFIG_RGBINDICATOR_STATS), shared by all indicators
+ */
+typedef struct _rgbi_schedStats
+{
+    uint32_t wakeups;                                   // scheduler timer expiries
+    uint32_t edges;                                     // flash edges and slot expiries fired
+    uint32_t coalesced;                                 // edges fired ahead of time with an earlier edge's wakeup
+} rgbi_schedStats_t;
+
+/* Expiry scheduler node, embedded in the indicator (flash timer) and in arbiter slots. All nodes
+ * share one kernel timer and work item (see CONFIG_RGBINDICATOR_SCHED_COALESCE_MS), handlers run
+ * on the indicator workqueue.
+ */
+typedef struct _rgbi_timer
+{
+    sys_dnode_t node;                                   // linked in the scheduler list while armed
+    int64_t due;                                        // expiry, uptime ticks
+    void (*handler)(struct _rgbi_timer *timer);
+} rgbi_timer_t;
+
+/* Sequence commands posted by the API (any context) and applied by the indicator work handler
+ */
+typedef enum
+{
+    RGBI_CMD_SET = 1,                                   // solid color, stops any sequence
+    RGBI_CMD_FLASH,
+    RGBI_CMD_BREATHE,
+    RGBI_CMD_PLAY,
+    RGBI_CMD_CANCEL,
+} rgbi_cmdOp_t;
+
+typedef struct _rgbi_cmd
+{
+    uint8_t op;                                         // rgbi_cmdOp_t
+    uint8_t count;                                      // flashes/breaths, 0=continuous
+    struct led_rgb pixels;
+    k_timeout_t fadeIn;                                 // flash: K_NO_WAIT
+    k_timeout_t onDuration;
+    k_timeout_t fadeOut;                                // flash: K_NO_WAIT
+    k_timeout_t offDuration;
+    const rgbi_step_t *pattern;                         // RGBI_CMD_PLAY
+} rgbi_cmd_t;
+
+struct _rgb_indicator;
+struct _rgbi_slot;
+struct _rgbi_backend;
+
+#define RGBI_SLOT_PRIORITIES 32                         // slot priorities 0 (lowest) to 31, one slot per priority
+
+/**
+ * @brief Completion callback for asynchronous indicator updates
+ * 
+ * @param rgbi The RGB indicator that was updated
+ * @param result 0=success, -ECANCELED if superseded by a newer update before reaching the bus, else I2C error
+ * @param userData Caller supplied context
+ * 
+ * @note Called from the I2C driver's completion context (typically an ISR), do not block.
+ */
+typedef void (*rgbi_callback_t)(struct _rgb_indicator *rgbi, int result, void *userData);
+
 typedef struct _rgb_indicator
 {
+    const struct _rgbi_backend *backend;                // output driver: LP5817 or PWM
+    uint8_t id;                                         // settings/log identity, LP5817 I2C address or 0x80 + PWM instance
+    const struct device *idScope;                       // device id is unique on: LP5817 I2C bus, PWM indicator device
+#if defined(CONFIG_RGBINDICATOR_BACKEND_LP5817)
     const struct i2c_dt_spec *rgbdev;
-    uint8_t brightness;                                 // 0-255, adj color channel 0-99 input to physical chip intensity
+#endif
+    const lp5817_config_t *config;                      // channel map and currents
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+    lp5817_config_t calib;                              // RAM calibration config points to, defaults overridden by stored settings
+    struct k_spinlock calibLock;                        // guards calib and brightness updates against the settings write copy
+    atomic_t settingsDirty;                             // calibration or brightness changed since the last settings write
+    struct k_work_delayable settingsWork;               // lazy settings writeback (system workqueue)
+#endif
+#if defined(CONFIG_RGBINDICATOR_BACKEND_LP5817)
+    lp5817_shadow_t shadow;                             // chip register state, allows delta-only writes
+#endif
+    uint8_t brightness;                                 // 0-255, scales configured dot currents (see rgbi_setBrightness)
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+    uint8_t colorScale[3];                              // red, green, blue calibration, applied after the shared gamma table
+    struct k_spinlock scaleLock;                        // guards colorScale, colors are mapped from any context
+#endif
     struct led_rgb pixels;                              // stay consistent with Zephyr library led_strip.h
     uint8_t flashesAsked;
     uint8_t flashesPerformed;
     k_timeout_t onDuration;
     k_timeout_t offDuration;
-    struct k_timer flashTimer;
+    rgbi_timer_t flashTimer;                            // sequence edges, shared scheduler node
     uint8_t flashState;
-    struct k_work flashWork;
+    struct k_work flashWork;                            // applies posted commands
+    struct k_spinlock cmdLock;                          // guards the posted command slot, taken from any context
+    rgbi_cmd_t cmd;                                     // latest posted command, replaces an unapplied older command
+    bool cmdPending;
+    rgbi_callback_t cmdCallback;                        // completion of the posted command (color calls), can be NULL
+    void *cmdUserData;
+    bool cmdAsync;                                      // SET from an async setter, callback completes with the transfer
+    volatile bool cmdApplying;                          // taken by the work handler, not yet handed to the backend
+    atomic_t generation;                                // bumped by every posted command
+    atomic_t currentsPending;                           // brightness/calibration changed, currents written by the work handler
+    int currentsResult;                                 // result of the last currents write (work handler)
+    atomic_val_t armedGen;                              // generation flashTimer was last armed for (work handler only)
+    atomic_val_t activeGen;                             // generation of the sequence running (work handler only)
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT)
+    struct k_work initWork;                             // chip configuration, queued ahead of all indicator work
+    struct k_event initEvent;                           // RGBI_EVT_INIT_DONE once configuration is attempted
+    int initResult;                                     // configuration result, valid after RGBI_EVT_INIT_DONE
+    uint32_t initCycles;                                // cycle count when configuration was queued
+#endif
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    rgbi_seqCursor_t seq;                               // keyframe pattern cursor, pattern table itself is const (flash)
+#endif
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+    bool hwSequence;                                    // sequence is being run by the backend (LP5817 engine, nRF PWM loop)
+#endif
+#if defined(CONFIG_RGBINDICATOR_ARBITER)
+    struct k_spinlock arbLock;                          // guards slot table, taken from any context
+    struct _rgbi_slot *slots[RGBI_SLOT_PRIORITIES];     // registered client slots, indexed by priority
+    uint32_t activeMask;                                // bit per priority with an active request
+    int8_t arbWinner;                                   // priority driving the indicator, -1=none
+    rgbi_cmd_t arbPosted;                               // last command the arbiter posted, op 0 = none
+#endif
+#if defined(CONFIG_RGBINDICATOR_PM)
+    struct k_mutex pmLock;                              // serializes output writes with standby
+    struct k_work_delayable standbyWork;                // chip standby after outputs are dark for a while
+    bool awake;                                         // LP5817 enabled and HX bus held
+#endif
+#if defined(CONFIG_RGBINDICATOR_STATS)
+    rgbi_stats_t stats;
+#endif
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    struct k_spinlock xferLock;                         // guards async transfer state, taken from ISR
+    uint8_t staged[3];                                  // requested intensity registers, sent when bus is free
+    uint8_t xferBuf[1 + 3];                             // register address + intensities for in-flight burst
+    struct i2c_msg xferMsg;
+#if defined(CONFIG_RGBINDICATOR_HXBUS)
+    hxbus_xfer_t hxXfer;                                // in-flight burst queued on the HX bus scheduler
+#endif
+    uint8_t xferAttempts;                               // retries used by in-flight burst
+    bool xferBusy;                                      // transfer in flight
+    bool xferPending;                                   // staged values waiting for in-flight transfer to complete
+    rgbi_callback_t xferCb;                             // completion callback for the latest update
+    void *xferCbData;
+    rgbi_callback_t pendingCb;                          // completion callback for the staged (not yet sent) update
+    void *pendingCbData;
+#endif
 } rgb_indicator_t;
 
+#if defined(CONFIG_RGBINDICATOR_ARBITER)
+/* Client slot for indicator arbitration, owned (allocated) by the client
+ */
+typedef struct _rgbi_slot
+{
+    rgb_indicator_t *rgbi;
+    rgbi_cmd_t request;                                 // what the client wants displayed
+    rgbi_timer_t expiry;                                // releases the request when it expires
+    uint8_t priority;                                   // 0-31, higher wins
+} rgbi_slot_t;
+#endif
+
 
+#if defined(CONFIG_RGBINDICATOR_BACKEND_LP5817)
 /**
  * @brief Initialize RGB indicator hardware and driver 
  * 
  * @param rgb_ctrllr Physical RGB controller devices
  * @param rgbi RGB indicator structure
- * @return int Error indicator, 0=success
+ * @return int Error indicator, 0=success, -ENODEV I2C bus not ready
+ *
+ * @note With CONFIG_RGBINDICATOR_DEFERRED_INIT the chip is configured in the background, see rgbi_waitReady().
  */
 int rgbi_init(const struct i2c_dt_spec *rgb_ctrllr, rgb_indicator_t * rgbi);
+#endif
+
+
+/**
+ * @brief Get the RGB indicator of a devicetree instantiated "ti,lp5817" or "loouq,rgb-indicator-pwm" device
+ * 
+ * The device is initialized at boot, no rgbi_init() call is needed. The device also implements
+ * the Zephyr LED API (led_set_color, led_blink, led_set_brightness). led_blink flashes the last
+ * non-black color set with led_set_color, full white if none was set; led_set_color with black
+ * turns the LED off without changing the blink color.
+ * 
+ * @param dev Indicator device (DEVICE_DT_GET)
+ * @return rgb_indicator_t* Indicator to use with the rgbi_ API
+ */
+rgb_indicator_t *rgbi_fromDevice(const struct device *dev);
+
+
+/**
+ * @brief Wait for the indicator chip configuration to complete
+ * 
+ * With CONFIG_RGBINDICATOR_DEFERRED_INIT initialization only queues the chip configuration, boot
+ * continues while it runs. Color and brightness calls made before it completes wait for it,
+ * flash/pattern commands are queued behind it. Without the option the chip is configured during
+ * initialization and this returns 0 at once.
+ * 
+ * The configuration runs on the indicator workqueue (the system workqueue without
+ * CONFIG_RGBINDICATOR_WORKQUEUE). Work items on that queue do not wait: this and the color and
+ * brightness calls return -EAGAIN there until the configuration is done.
+ * 
+ * @param rgbi The RGB indicator
+ * @param timeout How long to wait, not waited on the indicator workqueue
+ * @return int 0=ready, -EAGAIN timed out (or not ready, indicator workqueue), else chip configuration error
+ */
+int rgbi_waitReady(rgb_indicator_t *rgbi, k_timeout_t timeout);
 
 
 /**
  * @brief Set the color of the display using a led_rgb struct
  * 
+ * The color is written by the indicator work handler, which owns the outputs, and replaces any
+ * flash or pattern underway. The caller waits for the write.
+ * 
  * @param indicator Device spec pointer to the indicator to operate
  * @param pixels The structure containing the red, green, and blue color pixels.
+ * @return int Error indicator, 0=success (also 0 if color unchanged and no write needed),
+ *             -ECANCELED replaced by a newer command before it was written
+ * 
+ * @note Callable from ISR context, the color is then posted without waiting.
  */
-void rgbi_setColor(rgb_indicator_t * rgbi, const struct led_rgb * pixels);                                 // set color and display
+int rgbi_setColor(rgb_indicator_t * rgbi, const struct led_rgb * pixels);                                 // set color and display
 
 
 /**
@@ -94,16 +358,141 @@ void rgbi_setColor(rgb_indicator_t * rgbi, const struct led_rgb * pixels);
  * @param red Brightness of the red channel 0 (off) to 255 (full brightness)
  * @param green Brightness of the green channel 0 (off) to 255 (full brightness)
  * @param blue Brightness of the blue channel 0 (off) to 255 (full brightness)
+ * @return int Error indicator, 0=success, see rgbi_setColor()
+ */
+int rgbi_setColorFromPixels(rgb_indicator_t * rgbi, rgbi_color red, rgbi_color green, rgbi_color blue);   // set color and display
+
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+/**
+ * @brief Post a color update without waiting for the I2C transfer (non-blocking)
+ * 
+ * The color is a command like rgbi_setColor(): it replaces any flash or pattern underway and a
+ * command posted after it replaces it. The work handler hands it to the backend; if a transfer is
+ * already in flight the new color is staged and sent when the bus frees, newer colors posted
+ * meanwhile replace the staged color (only the latest color is written).
+ * 
+ * @note Constant time, callable from any context (including ISR). The callback runs from the work
+ * handler or the transfer completion (can be ISR), with the transfer result or -ECANCELED if a
+ * newer command or color replaced this one first.
+ * 
+ * @param indicator Device spec pointer to the indicator to operate
+ * @param pixels The structure containing the red, green, and blue color pixels.
+ * @param callback Optional completion callback (can be NULL)
+ * @param userData Context passed to callback
+ * @return int 0=update posted, errors are reported to the callback
+ */
+int rgbi_setColorAsync(rgb_indicator_t * rgbi, const struct led_rgb * pixels, rgbi_callback_t callback, void *userData);
+
+
+/**
+ * @brief Post a color update using individual color values without waiting for the I2C transfer
+ * 
+ * @note Same command and context rules as rgbi_setColorAsync().
+ * 
+ * @param indicator Device spec pointer to the indicator to operate
+ * @param red Brightness of the red channel 0 (off) to 255 (full brightness)
+ * @param green Brightness of the green channel 0 (off) to 255 (full brightness)
+ * @param blue Brightness of the blue channel 0 (off) to 255 (full brightness)
+ * @param callback Optional completion callback (can be NULL)
+ * @param userData Context passed to callback
+ * @return int 0=update posted, errors are reported to the callback
+ */
+int rgbi_setColorFromPixelsAsync(rgb_indicator_t * rgbi, rgbi_color red, rgbi_color green, rgbi_color blue, rgbi_callback_t callback, void *userData);
+
+
+/**
+ * @brief Post indicator off (all channels to 0) without waiting for the I2C transfer
+ * 
+ * @param indicator Device spec pointer to the indicator to operate
+ * @param callback Optional completion callback (can be NULL)
+ * @param userData Context passed to callback
+ * @return int 0=update posted, errors are reported to the callback
  */
-void rgbi_setColorFromPixels(rgb_indicator_t * rgbi, rgbi_color red, rgbi_color green, rgbi_color blue);   // set color and display
+int rgbi_offAsync(rgb_indicator_t * rgbi, rgbi_callback_t callback, void *userData);
+
+
+/**
+ * @brief Poll for completion of posted updates
+ * 
+ * @param indicator Device spec pointer to the indicator to operate
+ * @return true An update is in flight or staged
+ * @return false All posted updates have reached the chip (or failed)
+ */
+bool rgbi_isUpdating(rgb_indicator_t * rgbi);
+#endif
+
+
+/**
+ * @brief Set the overall indicator brightness, color is unchanged
+ * 
+ * Brightness scales the LP5817 dot (output) currents, a brightness change is a single register
+ * burst and does not re-send the color. The currents are written by the indicator work handler,
+ * a flash or pattern underway keeps running. With CONFIG_RGBINDICATOR_SETTINGS the brightness is
+ * stored (lazily, see rgbi_settingsFlush) and restored at init.
+ * 
+ * @param indicator Device spec pointer to the indicator to operate
+ * @param brightness 0 (dark) to 255 (configured full current)
+ * @return int Error indicator, 0=success
+ */
+int rgbi_setBrightness(rgb_indicator_t * rgbi, uint8_t brightness);
+
+
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+/**
+ * @brief Set the per-channel color calibration (white balance)
+ * 
+ * Colors set afterwards use the new calibration, the color displayed is not re-sent.
+ * 
+ * @param rgbi The RGB indicator
+ * @param red Red scale, 0-255 (255=unscaled)
+ * @param green Green scale
+ * @param blue Blue scale
+ * @return int 0=success, -EAGAIN indicator not yet configured (ISR, indicator workqueue)
+ */
+int rgbi_setColorScale(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue);
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+/**
+ * @brief Replace the board calibration (channel map, max and dot currents, color scale)
+ * 
+ * Currents are written to the chip at once (by the indicator work handler), the channel map and
+ * color scale apply to colors set afterwards. The calibration is stored with the brightness, see rgbi_settingsFlush().
+ * 
+ * @param rgbi The RGB indicator
+ * @param calib New calibration (copied)
+ * @return int 0=success, -EINVAL channel map is not a permutation of outputs 0-2, else I2C error
+ */
+int rgbi_setCalibration(rgb_indicator_t *rgbi, const lp5817_config_t *calib);
+
+
+/**
+ * @brief Write unsaved calibration and brightness to flash now
+ * 
+ * Changes (rgbi_setBrightness, rgbi_setColorScale, rgbi_setCalibration) are kept in RAM and
+ * written back CONFIG_RGBINDICATOR_SETTINGS_WRITEBACK_MS after the first unsaved change, at most
+ * one flash write per interval. Flush before a reset or power down to keep the latest values.
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=saved or nothing to save, else settings (flash) error
+ */
+int rgbi_settingsFlush(rgb_indicator_t *rgbi);
+#endif
 
 
 /**
  * @brief Shut indicator off, all channels to 0
  * 
+ * Same command as rgbi_setColor() with black: a flash or pattern underway is stopped.
+ * 
  * @param indicator Device spec pointer to the indicator to operate
+ * @return int Error indicator, 0=success, see rgbi_setColor()
+ * 
+ * @note Callable from ISR context, the off is then posted and written by the indicator work handler.
  */
-void rgbi_off(rgb_indicator_t * rgbi);                                                                     // set all channels to 0 = OFF
+int rgbi_off(rgb_indicator_t * rgbi);                                                                     // set all channels to 0 = OFF
 
 
 /**
@@ -114,6 +503,11 @@ void rgbi_off(rgb_indicator_t * rgbi);
  * @param onDuration The period of time the indicator should be ON in a flash iteration
  * @param offDuration The period of time the indicator should be OFF in a flash iteration
  * @param count The number of flashes, ON/OFF sequences, that should be performed.
+ * 
+ * @note Callable from any context (including ISR), the sequence is posted and started by the
+ * indicator work handler. A newer flash/pattern/cancel replaces it, timer edges of a replaced
+ * sequence are discarded. The indicator is off after the last flash, also when the sequence ran
+ * on backend hardware (LP5817 engine within CONFIG_RGBINDICATOR_AUTONOMOUS_TOLERANCE, nRF PWM).
  */
 void rgbi_flash(rgb_indicator_t * rgbi, struct led_rgb * pixels, k_timeout_t onDuration, k_timeout_t offDuration, uint8_t count);
 
@@ -125,18 +519,163 @@ void rgbi_flash(rgb_indicator_t * rgbi, struct led_rgb * pixels, k_timeout_t onD
  * @param pixels The color to display when the indicator is in the ON state
  * @param onDuration The period of time the indicator should be ON in a flash iteration
  * @param offDuration The period of time the indicator should be OFF in a flash iteration
+ * 
+ * @note Callable from any context (including ISR).
  */
 void rgbi_flash_continuous(rgb_indicator_t * rgbi, struct led_rgb pixels, k_timeout_t onDuration, k_timeout_t offDuration);
 
 
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+/**
+ * @brief Perform a breathe (fading flash) sequence using the LP5817 animation engine
+ * 
+ * The pattern is programmed once, the chip runs it with no further I2C traffic or CPU wakeups. 
+ * Times are rounded to the nearest engine time step (0 to 8.05 seconds).
+ * 
+ * @param indicator Device spec pointer to the indicator to operate
+ * @param pixels The color at the peak of each breath
+ * @param fadeIn Ramp time from off to full color
+ * @param onDuration Hold time at full color
+ * @param fadeOut Ramp time from full color to off
+ * @param offDuration Hold time off between breaths
+ * @param count Number of breaths 1-14, 0=continuous until cancelled
+ * @return int 0=success, -ENOTSUP if the pattern cannot be represented by the engine or the
+ *             indicator is not a LP5817
+ * 
+ * @note Callable from any context (including ISR).
+ */
+int rgbi_breathe(rgb_indicator_t * rgbi, const struct led_rgb * pixels, k_timeout_t fadeIn, k_timeout_t onDuration, k_timeout_t fadeOut, k_timeout_t offDuration, uint8_t count);
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+/**
+ * @brief Play a keyframe pattern (color steps, holds, fades, repeats) on the indicator
+ * 
+ * @param indicator Device spec pointer to the indicator to operate
+ * @param pattern Const pattern table created with RGBI_PATTERN_DEFINE()
+ * @return int 0=success
+ * 
+ * @note Callable from any context (including ISR). Pattern is busy (rgbi_isBusy) until it reaches its end, patterns with a forever repeat
+ * run until rgbi_cancel() or another flash/pattern is started.
+ */
+int rgbi_play(rgb_indicator_t * rgbi, const rgbi_step_t * pattern);
+#endif
+
+
 /**
  * @brief Stop/cancel a flash sequence. Required to end a continuous flash sequence, but can cut a normal count flash short. 
  * 
  * @param indicator Device spec pointer to the indicator to operate
+ * 
+ * @note Callable from any context (including ISR). The cancel is posted, a timer edge of the
+ * cancelled sequence that is already queued is discarded and cannot turn the indicator back on.
  */
 void rgbi_cancel(rgb_indicator_t * rgbi);
 
 
+#if defined(CONFIG_RGBINDICATOR_ARBITER)
+/**
+ * @brief Register a client slot at a priority
+ * 
+ * Clients sharing an indicator each own a slot. The highest priority slot with an active request
+ * drives the indicator, when it is released or expires the next lower active slot resumes. With
+ * slots in use the direct rgbi_ color/flash calls bypass arbitration and should not be mixed in.
+ * 
+ * @param indicator Device spec pointer to the indicator to operate
+ * @param slot Client owned slot (static storage)
+ * @param priority 0 (lowest) to 31 (highest), one slot per priority
+ * @return int 0=success, -EINVAL priority out of range, -EBUSY priority already registered
+ */
+int rgbi_slotInit(rgb_indicator_t * rgbi, rgbi_slot_t * slot, uint8_t priority);
+
+
+/**
+ * @brief Request a solid color
+ * 
+ * @param slot Client slot
+ * @param pixels Color to display
+ * @param expiry Request released after this (relative) time, K_FOREVER holds until rgbi_slotRelease()
+ * 
+ * @note Callable from any context (including ISR). Replaces the slot's previous request, the
+ * indicator is only updated if the slot is (or becomes) the winner.
+ */
+void rgbi_slotColor(rgbi_slot_t * slot, const struct led_rgb * pixels, k_timeout_t expiry);
+
+
+/**
+ * @brief Request a flash sequence
+ * 
+ * @param slot Client slot
+ * @param pixels The color to display when the indicator is in the ON state
+ * @param onDuration The period of time the indicator should be ON in a flash iteration
+ * @param offDuration The period of time the indicator should be OFF in a flash iteration
+ * @param count The number of flashes, 0=continuous
+ * @param expiry Request released after this (relative) time, K_FOREVER holds until rgbi_slotRelease()
+ * 
+ * @note A count limited flash holds the slot (indicator off) after the last flash until the
+ * request expires or is released, size the expiry to the sequence.
+ */
+void rgbi_slotFlash(rgbi_slot_t * slot, const struct led_rgb * pixels, k_timeout_t onDuration, k_timeout_t offDuration, uint8_t count, k_timeout_t expiry);
+
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+/**
+ * @brief Request a keyframe pattern
+ * 
+ * @param slot Client slot
+ * @param pattern Const pattern table created with RGBI_PATTERN_DEFINE()
+ * @param expiry Request released after this (relative) time, K_FOREVER holds until rgbi_slotRelease()
+ * @return int 0=success, -EINVAL no pattern
+ */
+int rgbi_slotPlay(rgbi_slot_t * slot, const rgbi_step_t * pattern, k_timeout_t expiry);
+#endif
+
+
+/**
+ * @brief Release the slot's request, the next lower active slot (or off) takes over
+ * 
+ * @param slot Client slot
+ * 
+ * @note Callable from any context (including ISR).
+ */
+void rgbi_slotRelease(rgbi_slot_t * slot);
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+/**
+ * @brief Get a snapshot of the indicator performance counters
+ * 
+ * @param indicator Device spec pointer to the indicator
+ * @param stats Returns counters since init or last reset
+ */
+void rgbi_getStats(rgb_indicator_t * rgbi, rgbi_stats_t * stats);
+
+
+/**
+ * @brief Clear the indicator performance counters
+ * 
+ * @param indicator Device spec pointer to the indicator
+ */
+void rgbi_resetStats(rgb_indicator_t * rgbi);
+
+
+/**
+ * @brief Get a snapshot of the expiry scheduler counters, shared by all indicators
+ * 
+ * @param stats Returns counters since boot or last reset
+ */
+void rgbi_getSchedStats(rgbi_schedStats_t * stats);
+
+
+/**
+ * @brief Clear the expiry scheduler counters
+ */
+void rgbi_resetSchedStats(void);
+#endif
+
+
 /**
  * @brief Determine if a flash sequence is underway. 
  * 
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "rgb-indicator-priv.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(rgb_indicator);
+
+/* Indicator arbitration
+ *
+ * Each client slot is registered at a unique priority, a bit per priority in activeMask marks
+ * slots with a request. The winner is the most significant set bit (single CLZ instruction),
+ * re-evaluation is O(1) and needs no heap. A command is only posted to the indicator when the
+ * winner changes or the winning slot changes its request, and not when it equals the command
+ * still showing (a repost would restart a running flash).
+ */
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static void slotRequest(rgbi_slot_t *slot, const rgbi_cmd_t *request, k_timeout_t expiry);
+static void slotExpiry(rgbi_timer_t *timer);
+static void arbitrate(rgb_indicator_t *rgbi, uint8_t changed);
+static bool cmdEqual(const rgbi_cmd_t *a, const rgbi_cmd_t *b);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Register a client slot at a priority
+ *
+ * @param rgbi The RGB indicator the slot shares
+ * @param slot Client owned slot
+ * @param priority 0-31, higher wins
+ * @return int 0=success
+ */
+int rgbi_slotInit(rgb_indicator_t *rgbi, rgbi_slot_t *slot, uint8_t priority)
+{
+    k_spinlock_key_t key;
+    int ret = 0;
+
+    if (priority >= RGBI_SLOT_PRIORITIES)
+    {
+        return -EINVAL;
+    }
+
+    slot->rgbi = rgbi;
+    slot->priority = priority;
+    rgbi_schedInit(&(slot->expiry), slotExpiry);
+
+    key = k_spin_lock(&(rgbi->arbLock));
+    if (rgbi->slots[priority] != NULL && rgbi->slots[priority] != slot)
+    {
+        ret = -EBUSY;
+    }
+    else
+    {
+        rgbi->slots[priority] = slot;
+    }
+    k_spin_unlock(&(rgbi->arbLock), key);
+
+    if (ret != 0)
+    {
+        LOG_ERR("Indicator slot priority %d already registered", priority);
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Request a solid color
+ *
+ * @param slot Client slot
+ * @param pixels Color to display
+ * @param expiry Request lifetime, K_FOREVER=until released
+ */
+void rgbi_slotColor(rgbi_slot_t *slot, const struct led_rgb *pixels, k_timeout_t expiry)
+{
+    rgbi_cmd_t request = { .op = RGBI_CMD_SET, .pixels = *pixels };
+
+    slotRequest(slot, &request, expiry);
+}
+
+
+/**
+ * @brief Request a flash sequence
+ *
+ * @param slot Client slot
+ * @param pixels The color set to display when flash indicates ON
+ * @param onDuration The amount of time the indicator is on
+ * @param offDuration The amount of time the indicator is off
+ * @param count The number of "on" flashes, 0=continuous
+ * @param expiry Request lifetime, K_FOREVER=until released
+ */
+void rgbi_slotFlash(rgbi_slot_t *slot, const struct led_rgb *pixels, k_timeout_t onDuration, k_timeout_t offDuration, uint8_t count, k_timeout_t expiry)
+{
+    rgbi_cmd_t request =
+    {
+        .op = RGBI_CMD_FLASH,
+        .count = count,
+        .pixels = *pixels,
+        .fadeIn = K_NO_WAIT,
+        .onDuration = onDuration,
+        .fadeOut = K_NO_WAIT,
+        .offDuration = offDuration,
+    };
+
+    slotRequest(slot, &request, expiry);
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+/**
+ * @brief Request a keyframe pattern
+ *
+ * @param slot Client slot
+ * @param pattern Pattern step table
+ * @param expiry Request lifetime, K_FOREVER=until released
+ * @return int 0=success
+ */
+int rgbi_slotPlay(rgbi_slot_t *slot, const rgbi_step_t *pattern, k_timeout_t expiry)
+{
+    rgbi_cmd_t request = { .op = RGBI_CMD_PLAY, .pattern = pattern };
+
+    if (pattern == NULL)
+    {
+        return -EINVAL;
+    }
+    slotRequest(slot, &request, expiry);
+    return 0;
+}
+#endif
+
+
+/**
+ * @brief Release the slot's request
+ *
+ * @param slot Client slot
+ */
+void rgbi_slotRelease(rgbi_slot_t *slot)
+{
+    rgb_indicator_t *rgbi = slot->rgbi;
+    k_spinlock_key_t key;
+
+    rgbi_schedCancel(&(slot->expiry));
+
+    key = k_spin_lock(&(rgbi->arbLock));
+    rgbi->activeMask &= ~BIT(slot->priority);
+    arbitrate(rgbi, slot->priority);
+    k_spin_unlock(&(rgbi->arbLock), key);
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Store a slot request, activate the slot and re-evaluate the winner
+ *
+ * @param slot Client slot
+ * @param request Command to run while the slot wins
+ * @param expiry Request lifetime, K_FOREVER=until released
+ */
+static void slotRequest(rgbi_slot_t *slot, const rgbi_cmd_t *request, k_timeout_t expiry)
+{
+    rgb_indicator_t *rgbi = slot->rgbi;
+    k_spinlock_key_t key;
+
+    rgbi_schedCancel(&(slot->expiry));                                  // expiry of the previous request must not release this one
+
+    key = k_spin_lock(&(rgbi->arbLock));
+    slot->request = *request;
+    rgbi->activeMask |= BIT(slot->priority);
+    arbitrate(rgbi, slot->priority);
+    k_spin_unlock(&(rgbi->arbLock), key);
+
+    if (rgbi_schedArm(&(slot->expiry), expiry) != 0)                   // K_FOREVER leaves it disarmed
+    {
+        LOG_WRN("Slot %u expiry is not a relative timeout, held until released", slot->priority);
+    }
+}
+
+
+/**
+ * @brief Slot expiry (scheduler, indicator workqueue), releases the request
+ *
+ * @param timer Slot expiry node
+ */
+static void slotExpiry(rgbi_timer_t *timer)
+{
+    rgbi_slotRelease(CONTAINER_OF(timer, rgbi_slot_t, expiry));
+}
+
+
+/**
+ * @brief Select the highest priority active slot and post its request if the displayed state changes
+ *
+ * Called with arbLock held, posting under the lock keeps commands from racing callers in order.
+ *
+ * @param rgbi The RGB indicator
+ * @param changed Priority of the slot whose request or state changed
+ */
+static void arbitrate(rgb_indicator_t *rgbi, uint8_t changed)
+{
+    int8_t winner = (int8_t)find_msb_set(rgbi->activeMask) - 1;         // -1 when no active slot
+    rgbi_cmd_t cancel = { .op = RGBI_CMD_CANCEL };
+    const rgbi_cmd_t *cmd = (winner < 0) ? &cancel : &(rgbi->slots[winner]->request);
+
+    if (winner == rgbi->arbWinner && winner != changed)
+    {
+        return;                                                         // lower priority change, hidden
+    }
+    rgbi->arbWinner = winner;
+    if (cmdEqual(cmd, &(rgbi->arbPosted)) &&
+        (cmd->op == RGBI_CMD_SET || cmd->op == RGBI_CMD_CANCEL || rgbi_isBusy(rgbi)))
+    {
+        return;                                                         // still showing, an ended sequence is replayed
+    }
+    rgbi->arbPosted = *cmd;
+    rgbi_post(rgbi, cmd);
+}
+
+
+/**
+ * @brief Compare two commands field by field (struct padding is unspecified, no memcmp)
+ *
+ * @return true if posting b would repeat a
+ */
+static bool cmdEqual(const rgbi_cmd_t *a, const rgbi_cmd_t *b)
+{
+    return a->op == b->op && a->count == b->count &&
+           a->pixels.r == b->pixels.r && a->pixels.g == b->pixels.g && a->pixels.b == b->pixels.b &&
+           K_TIMEOUT_EQ(a->fadeIn, b->fadeIn) && K_TIMEOUT_EQ(a->onDuration, b->onDuration) &&
+           K_TIMEOUT_EQ(a->fadeOut, b->fadeOut) && K_TIMEOUT_EQ(a->offDuration, b->offDuration) &&
+           a->pattern == b->pattern;
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/led.h>
+#include <zephyr/dt-bindings/led/led.h>
+#include <zephyr/pm/device.h>
+
+#include "rgb-indicator-priv.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(rgb_indicator);
+
+#define RGBI_BLINK_DEFAULT_MS 500                                       // led_blink() with no delays requested
+
+#if defined(CONFIG_RGBINDICATOR_LP5817)
+struct lp5817_devConfig                                                 // ROM, one per devicetree instance
+{
+    struct i2c_dt_spec bus;
+    lp5817_config_t chip;
+};
+#endif
+
+static const uint8_t rgbi_colorMapping[] = { LED_COLOR_ID_RED, LED_COLOR_ID_GREEN, LED_COLOR_ID_BLUE };
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Get the RGB indicator of an indicator device (LP5817 or PWM)
+ * 
+ * @param dev Indicator device
+ * @return rgb_indicator_t* Indicator for use with the rgbi_ API
+ */
+rgb_indicator_t *rgbi_fromDevice(const struct device *dev)
+{
+    struct rgbi_devData *data = dev->data;
+
+    return &(data->rgbi);
+}
+
+
+/* Zephyr LED API
+ * --------------------------------------------------------------------------------------------- */
+
+static int rgbi_ledSetColor(const struct device *dev, uint32_t led, uint8_t num_colors, const uint8_t *color)
+{
+    struct rgbi_devData *data = dev->data;
+    struct led_rgb pixels;
+
+    if (led != 0 || num_colors != ARRAY_SIZE(rgbi_colorMapping))
+    {
+        return -EINVAL;
+    }
+
+    pixels.r = color[0];
+    pixels.g = color[1];
+    pixels.b = color[2];
+    if (pixels.r != 0 || pixels.g != 0 || pixels.b != 0)                 // black turns the LED off, blink keeps the color
+    {
+        data->color = pixels;
+    }
+    return rgbi_setColor(&(data->rgbi), &pixels);
+}
+
+
+static int rgbi_ledSetBrightness(const struct device *dev, uint32_t led, uint8_t value)
+{
+    struct rgbi_devData *data = dev->data;
+
+    if (led != 0 || value > LED_BRIGHTNESS_MAX)
+    {
+        return -EINVAL;
+    }
+    return rgbi_setBrightness(&(data->rgbi), (uint16_t)value * UINT8_MAX / LED_BRIGHTNESS_MAX);
+}
+
+
+/**
+ * @brief led_blink(): flash continuously in the last non-black color set with led_set_color(), full
+ * white if none was set. led_set_color() with black ends the blink and turns the LED off.
+ */
+static int rgbi_ledBlink(const struct device *dev, uint32_t led, uint32_t delay_on, uint32_t delay_off)
+{
+    struct rgbi_devData *data = dev->data;
+    struct led_rgb pixels = data->color;
+
+    if (led != 0)
+    {
+        return -EINVAL;
+    }
+    if (delay_on == 0 && delay_off == 0)
+    {
+        delay_on = RGBI_BLINK_DEFAULT_MS;
+        delay_off = RGBI_BLINK_DEFAULT_MS;
+    }
+
+    if (pixels.r == 0 && pixels.g == 0 && pixels.b == 0)
+    {
+        pixels = (struct led_rgb)RGB(UINT8_MAX, UINT8_MAX, UINT8_MAX);        // no color set yet
+    }
+
+    rgbi_flash_continuous(&(data->rgbi), pixels, K_MSEC(delay_on), K_MSEC(delay_off));
+    return 0;
+}
+
+
+static int rgbi_ledGetInfo(const struct device *dev, uint32_t led, const struct led_info **info)
+{
+    static const struct led_info rgbi_info =
+    {
+        .label = "rgb-indicator",
+        .index = 0,
+        .num_colors = ARRAY_SIZE(rgbi_colorMapping),
+        .color_mapping = rgbi_colorMapping,
+    };
+
+    if (led != 0)
+    {
+        return -EINVAL;
+    }
+    *info = &rgbi_info;
+    return 0;
+}
+
+
+DEVICE_API(led, rgbi_ledApi) =
+{
+    .blink = rgbi_ledBlink,
+    .get_info = rgbi_ledGetInfo,
+    .set_brightness = rgbi_ledSetBrightness,
+    .set_color = rgbi_ledSetColor,
+};
+
+
+/**
+ * @brief Determine if a device is an indicator instance (LP5817 or PWM)
+ * 
+ * @param dev Device to check
+ * @return true Device was created by an indicator driver
+ */
+bool rgbi_isIndicatorDevice(const struct device *dev)
+{
+    return dev != NULL && dev->api == &rgbi_ledApi;
+}
+
+
+/* Devicetree instantiation, LP5817 (PWM instances live in rgb-indicator-pwm.c)
+ * --------------------------------------------------------------------------------------------- */
+
+#if defined(CONFIG_RGBINDICATOR_LP5817)
+#define DT_DRV_COMPAT ti_lp5817
+
+static int lp5817_devInit(const struct device *dev)
+{
+    const struct lp5817_devConfig *config = dev->config;
+    struct rgbi_devData *data = dev->data;
+
+    if (!i2c_is_ready_dt(&(config->bus)))
+    {
+        LOG_ERR("I2C bus %s is not ready", config->bus.bus->name);
+        return -ENODEV;
+    }
+    return rgbi_initConfig(&(data->rgbi), &(config->bus), &(config->chip));
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_PM)
+static int lp5817_pmAction(const struct device *dev, enum pm_device_action action)
+{
+    struct rgbi_devData *data = dev->data;
+
+    switch (action)
+    {
+        case PM_DEVICE_ACTION_SUSPEND:
+            return rgbi_pmStandby(&(data->rgbi));                       // -EBUSY while lit
+        case PM_DEVICE_ACTION_RESUME:
+            return 0;                                                   // chip wakes on the next lit output
+        default:
+            return -ENOTSUP;
+    }
+}
+
+#define LP5817_PM_DEFINE(inst) PM_DEVICE_DT_INST_DEFINE(inst, lp5817_pmAction);
+#define LP5817_PM_GET(inst) PM_DEVICE_DT_INST_GET(inst)
+#else
+#define LP5817_PM_DEFINE(inst)
+#define LP5817_PM_GET(inst) NULL
+#endif
+
+
+#define LP5817_DEFINE(inst)                                                                         \
+    BUILD_ASSERT(DT_INST_PROP_LEN(inst, channel_map) == 3, "channel-map needs 3 entries");          \
+    BUILD_ASSERT(DT_INST_PROP_LEN(inst, dot_current) == 3, "dot-current needs 3 entries");          \
+    BUILD_ASSERT(DT_INST_PROP_LEN(inst, color_scale) == 3, "color-scale needs 3 entries");          \
+                                                                                                    \
+    static const struct lp5817_devConfig lp5817_config_##inst =                                     \
+    {                                                                                               \
+        .bus = I2C_DT_SPEC_INST_GET(inst),                                                          \
+        .chip =                                                                                     \
+        {                                                                                           \
+            .channelMap = DT_INST_PROP(inst, channel_map),                                          \
+            .dotCurrent = DT_INST_PROP(inst, dot_current),                                          \
+            .maxCurrent = DT_INST_PROP(inst, max_current),                                          \
+            .colorScale = DT_INST_PROP(inst, color_scale),                                          \
+        },                                                                                          \
+    };                                                                                              \
+                                                                                                    \
+    static struct rgbi_devData lp5817_data_##inst;                                                 \
+                                                                                                    \
+    LP5817_PM_DEFINE(inst)                                                                          \
+                                                                                                    \
+    DEVICE_DT_INST_DEFINE(inst, lp5817_devInit, LP5817_PM_GET(inst), &lp5817_data_##inst,           \
+                          &lp5817_config_##inst,                                                    \
+                          POST_KERNEL, CONFIG_RGBINDICATOR_INIT_PRIORITY, &rgbi_ledApi);
+
+DT_INST_FOREACH_STATUS_OKAY(LP5817_DEFINE)
+#endif
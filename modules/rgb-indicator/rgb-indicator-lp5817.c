@@ -0,0 +1,1065 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/sys/util.h>
+#if defined(CONFIG_RGBINDICATOR_PM)
+#include <zephyr/pm/device_runtime.h>
+#endif
+
+#include "rgb-indicator-priv.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(rgb_indicator);
+
+/* TI LP5817 backend: intensities and currents through the shadowed register file over I2C (or the
+ * HX bus scheduler), flash/breathe sequences on the chip's animation engine
+ */
+
+static const lp5817_config_t lp5817_defaultConfig =                            // rgbi_init() boards, see header channel assignments
+{
+    .channelMap = { 2, 0, 1 },                                                  // red=OUT2, green=OUT0, blue=OUT1
+    .dotCurrent = { 128, 128, 128 },                                            // relative brightness of each RGB channel
+    .maxCurrent = LP5817_CMD_MAXCURRENT,
+    .colorScale = { 255, 255, 255 },
+};
+
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+static const uint16_t lp5817_autoTimeMs[16] =                                   // animation engine time codes (milliseconds)
+{
+    0, 90, 180, 360, 540, 800, 1070, 1520, 2060, 2500, 3040, 4020, 5010, 5990, 7060, 8050
+};
+#endif
+
+#if defined(CONFIG_RGBINDICATOR_PM)
+#define LP5817_RETAINED_MASK (BIT64(LP5817_REG_MAXCURRENT) | BIT64(LP5817_REG_OUTENABLE) |          \
+                              BIT64(LP5817_REG_DOTCURRENT_0) | BIT64(LP5817_REG_DOTCURRENT_1) |     \
+                              BIT64(LP5817_REG_DOTCURRENT_2))                  // configuration restored on wake if unknown
+#endif
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+struct syncWait                                                                 // blocking caller waiting on an async update
+{
+    struct k_sem done;
+    int result;
+};
+#endif
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static int lp5817_configure(rgb_indicator_t *rgbi);
+static int lp5817_setOutputs(rgb_indicator_t *rgbi, const uint8_t levels[3]);
+static int lp5817_setCurrents(rgb_indicator_t *rgbi);
+static int lp5817_setDotCurrent(rgb_indicator_t *rgbi);
+static int lp5817_writeRegs(rgb_indicator_t *rgbi, uint8_t reg, const uint8_t *vals, size_t len);
+static int lp5817_writeCmd(rgb_indicator_t *rgbi, uint8_t reg, uint8_t cmd);
+static int lp5817_i2cWrite(rgb_indicator_t *rgbi, const uint8_t *buf, size_t len);
+static void lp5817_commitShadow(lp5817_shadow_t *shadow, uint8_t reg, const uint8_t *vals, size_t len, bool ok);
+static bool lp5817_dirtyRange(const lp5817_shadow_t *shadow, uint8_t reg, const uint8_t *vals, size_t len, size_t *first, size_t *last);
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+static int lp5817_setOutputsAsync(rgb_indicator_t *rgbi, const uint8_t levels[3], rgbi_callback_t callback, void *userData);
+static bool lp5817_isUpdating(rgb_indicator_t *rgbi);
+static bool lp5817_prepareXfer(rgb_indicator_t *rgbi);
+static int lp5817_submitXfer(rgb_indicator_t *rgbi);
+static int lp5817_sendXfer(rgb_indicator_t *rgbi);
+static void lp5817_xferComplete(const struct device *dev, int result, void *data);   // I2C driver callback (ISR)
+#if defined(CONFIG_RGBINDICATOR_HXBUS)
+static void lp5817_hxComplete(hxbus_xfer_t *xfer, int result, void *userData);      // HX bus thread callback
+#endif
+static void syncComplete(rgb_indicator_t *rgbi, int result, void *userData);        // completion for blocking wrappers
+#endif
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+static bool lp5817_seqFits(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd);
+static int lp5817_seqStart(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, const uint8_t peak[3], uint32_t *runMs);
+static void lp5817_seqStop(rgb_indicator_t *rgbi);
+static bool lp5817_autoEncode(const rgbi_cmd_t *cmd, uint8_t timeCodes[4]);
+static int lp5817_startAuto(rgb_indicator_t *rgbi, const uint8_t peak[3], const uint8_t timeCodes[4], uint8_t count);
+static int lp5817_stopAuto(rgb_indicator_t *rgbi);
+static bool lp5817_autoTimeCode(k_timeout_t duration, uint32_t tolerancePct, uint8_t *code);
+#endif
+#if defined(CONFIG_RGBINDICATOR_PM)
+static int lp5817_pmActivity(rgb_indicator_t *rgbi, bool lit);
+static int lp5817_wake(rgb_indicator_t *rgbi);
+static bool lp5817_isIdle(rgb_indicator_t *rgbi);
+static void standby_handler(struct k_work *work);                               // delayed chip standby
+#endif
+
+static const rgbi_backend_t lp5817_backend =
+{
+    .configure = lp5817_configure,
+    .setOutputs = lp5817_setOutputs,
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    .setOutputsAsync = lp5817_setOutputsAsync,
+    .isUpdating = lp5817_isUpdating,
+#endif
+    .setCurrents = lp5817_setCurrents,
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+    .seqFits = lp5817_seqFits,
+    .seqStart = lp5817_seqStart,
+    .seqStop = lp5817_seqStop,
+#endif
+};
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Initialize RGB indicator device and driver
+ * 
+ * @param rgb_dev TI LP5817 RGB controller device 
+ * @param rgbi RGB indicator struct holding display parameters
+ * @return int 0 = success
+ */
+int rgbi_init(const struct i2c_dt_spec *rgb_dev, rgb_indicator_t * rgbi)
+{
+    return rgbi_initConfig(rgbi, rgb_dev, &lp5817_defaultConfig);
+}
+
+
+/**
+ * @brief Initialize RGB indicator device and driver with a board specific chip configuration
+ * 
+ * @param rgbi RGB indicator struct holding display parameters
+ * @param rgb_dev TI LP5817 RGB controller device 
+ * @param config Channel map and currents
+ * @return int 0 = success
+ */
+int rgbi_initConfig(rgb_indicator_t *rgbi, const struct i2c_dt_spec *rgb_dev, const lp5817_config_t *config)
+{
+    if (!device_is_ready(rgb_dev->bus))
+    {
+        LOG_ERR("I2C bus %s is not ready", rgb_dev->bus->name);
+        return -ENODEV;
+    }
+
+    rgbi->rgbdev = rgb_dev;
+    rgbi->shadow.validMask = 0;                                 // chip state unknown, first writes go to the chip unconditionally
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    rgbi->xferBusy = false;
+    rgbi->xferPending = false;
+    rgbi->pendingCb = NULL;
+#endif
+#if defined(CONFIG_RGBINDICATOR_PM)
+    k_mutex_init(&(rgbi->pmLock));
+    k_work_init_delayable(&(rgbi->standbyWork), standby_handler);
+    rgbi->awake = (pm_device_runtime_get(rgb_dev->bus) == 0);   // lp5817_configure() enables the chip, standby follows once dark
+#endif
+    return rgbi_initIndicator(rgbi, &lp5817_backend, config, rgb_dev->addr, rgb_dev->bus);
+}
+
+
+/* Backend operations
+ * --------------------------------------------------------------------------------------------- */
+
+ /**
+ * @brief Initialize TI LP5817 chip for use, outputs off
+ * 
+ * Stored settings are already applied to the configuration and brightness by the front end.
+ * 
+ * @param rgbi The RGB indicator, rgbdev is the device spec for the RGB LED controller 
+ * @return int 0=success, else I2C error
+ */
+static int lp5817_configure(rgb_indicator_t *rgbi)
+{
+	int ret;
+    const struct i2c_dt_spec *rgb_ctrllr = rgbi->rgbdev;
+    const uint8_t off[3] = { 0, 0, 0 };
+    uint8_t config[3];
+
+    /* Write CHIP_EN = 1, chip max current and output enables (0x00-0x02) in one burst
+     * Set dot (channel) currents and clear intensities
+     * Send UPDATE_CMD to activate configuration
+     */
+
+    config[0] = LP5817_CMD_CHIPENABLE;
+    config[1] = rgbi->config->maxCurrent;
+    config[2] = LP5817_CMD_OUTENABLE;
+
+    ret = lp5817_writeRegs(rgbi, LP5817_REG_CHIPENABLE, config, sizeof(config));
+    if (ret != 0)
+    {
+        LOG_ERR("Failed to enable LP5817@%x err=%d", rgb_ctrllr->addr, ret);
+        return ret;
+    }
+
+    ret = lp5817_setDotCurrent(rgbi);                                   // apply dot (channel) configured current (brightness adjustment)
+    if (ret != 0)
+    {
+        LOG_ERR("Failed to set LP5817 DOT (channel) current");
+        return ret;
+    }
+
+    ret = lp5817_setOutputs(rgbi, off);
+    if (ret == 0)
+    {
+        ret = lp5817_writeCmd(rgbi, LP5817_REG_UPDATE, LP5817_CMD_UPDATE);
+    }
+    if (ret != 0)
+    {
+        LOG_ERR("Failed to apply settings to LP5817");
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Set the 3 intensity (PWM) registers, only changed channels are written to the chip
+ * 
+ * @param rgbi The RGB indicator to update
+ * @param levels Intensities, output order OUT0-OUT2
+ * @return int 0=success
+ */
+static int lp5817_setOutputs(rgb_indicator_t *rgbi, const uint8_t levels[3])
+{
+   	int ret;
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    struct syncWait wait;                                               // blocking wrapper over async path, keeps one owner of intensity shadow
+
+    k_sem_init(&wait.done, 0, 1);
+    ret = lp5817_setOutputsAsync(rgbi, levels, syncComplete, &wait);
+    if (ret == 0)
+    {
+        k_sem_take(&wait.done, K_FOREVER);
+        ret = (wait.result == -ECANCELED) ? 0 : wait.result;             // superseded by a newer color is not a failure
+    }
+#elif defined(CONFIG_RGBINDICATOR_PM)
+    k_mutex_lock(&(rgbi->pmLock), K_FOREVER);
+    ret = lp5817_pmActivity(rgbi, (levels[0] | levels[1] | levels[2]) != 0);
+    if (ret == 0)
+    {
+        ret = lp5817_writeRegs(rgbi, LP5817_REG_INTENSITY0, levels, 3);
+    }
+    k_mutex_unlock(&(rgbi->pmLock));
+#else
+    ret = lp5817_writeRegs(rgbi, LP5817_REG_INTENSITY0, levels, 3);
+#endif
+    return ret;
+}
+
+
+/**
+ * @brief Write max current and brightness scaled dot currents, latched with UPDATE (work handler)
+ * 
+ * A chip in standby is not woken: its dot currents are marked unknown in the shadow and
+ * lp5817_wake() writes the new values with the enable burst.
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=success
+ */
+static int lp5817_setCurrents(rgb_indicator_t *rgbi)
+{
+    int ret;
+
+#if defined(CONFIG_RGBINDICATOR_PM)
+    k_mutex_lock(&(rgbi->pmLock), K_FOREVER);
+    if (!rgbi->awake)
+    {
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+        k_spinlock_key_t key = k_spin_lock(&(rgbi->xferLock));
+        lp5817_commitShadow(&(rgbi->shadow), LP5817_REG_DOTCURRENT_0, NULL, 3, false);
+        k_spin_unlock(&(rgbi->xferLock), key);
+#else
+        lp5817_commitShadow(&(rgbi->shadow), LP5817_REG_DOTCURRENT_0, NULL, 3, false);
+#endif
+        k_mutex_unlock(&(rgbi->pmLock));
+        return 0;
+    }
+#endif
+    ret = lp5817_writeRegs(rgbi, LP5817_REG_MAXCURRENT, &(rgbi->config->maxCurrent), 1);        // shadowed, no traffic unless calibration changed
+    if (ret == 0)
+    {
+        ret = lp5817_setDotCurrent(rgbi);
+    }
+    if (ret == 0)
+    {
+        ret = lp5817_writeCmd(rgbi, LP5817_REG_UPDATE, LP5817_CMD_UPDATE);   // currents are latched by UPDATE
+    }
+#if defined(CONFIG_RGBINDICATOR_PM)
+    k_mutex_unlock(&(rgbi->pmLock));
+#endif
+    return ret;
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+/**
+ * @brief Let caller know if posted updates are still waiting to reach the chip
+ * 
+ * @param rgbi The RGB indicator
+ * @return true Transfer in flight or staged
+ */
+static bool lp5817_isUpdating(rgb_indicator_t *rgbi)
+{
+    return rgbi->xferBusy || rgbi->xferPending;
+}
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+/**
+ * @brief Determine if the animation engine can run a sequence (times up to 8s, up to 14 repeats)
+ */
+static bool lp5817_seqFits(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd)
+{
+    uint8_t timeCodes[4];
+
+    ARG_UNUSED(rgbi);
+    return lp5817_autoEncode(cmd, timeCodes);
+}
+
+
+/**
+ * @brief Hand a flash/breathe sequence to the LP5817 animation engine
+ * 
+ * @param rgbi The RGB indicator
+ * @param cmd Flash or breathe command
+ * @param peak Peak intensities, output order
+ * @param runMs Returns the run time of a count limited sequence (engine time steps)
+ * @return int 0=engine running the sequence, -ENOTSUP if not representable, else I2C error
+ */
+static int lp5817_seqStart(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, const uint8_t peak[3], uint32_t *runMs)
+{
+    uint8_t timeCodes[4];
+    uint32_t periodMs = 0;
+
+    if (!lp5817_autoEncode(cmd, timeCodes))
+    {
+        return -ENOTSUP;
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(timeCodes); i++)
+    {
+        periodMs += lp5817_autoTimeMs[timeCodes[i]];
+    }
+    *runMs = periodMs * cmd->count;
+    return lp5817_startAuto(rgbi, peak, timeCodes, cmd->count);
+}
+
+
+/**
+ * @brief Return the outputs to manual intensity control
+ */
+static void lp5817_seqStop(rgb_indicator_t *rgbi)
+{
+    (void)lp5817_stopAuto(rgbi);
+}
+#endif
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Write the dot current registers: configured current scaled by brightness, one burst
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=success
+ */
+static int lp5817_setDotCurrent(rgb_indicator_t *rgbi)
+{
+    uint8_t dotCurrent[3];
+
+    for (size_t i = 0; i < ARRAY_SIZE(dotCurrent); i++)
+    {
+        dotCurrent[i] = (uint16_t)rgbi->config->dotCurrent[i] * rgbi->brightness / UINT8_MAX;
+    }
+    return lp5817_writeRegs(rgbi, LP5817_REG_DOTCURRENT_0, dotCurrent, sizeof(dotCurrent));
+}
+
+/**
+ * @brief Write a range of consecutive LP5817 registers through the shadow register file
+ * 
+ * Registers matching the shadow are trimmed from both ends of the range, the remaining dirty
+ * span is sent as a single auto-increment burst (one START/address/STOP). If nothing changed
+ * no bus traffic is generated.
+ * 
+ * @param rgbi The RGB indicator to update
+ * @param reg First register address of the range
+ * @param vals New register values
+ * @param len Number of registers in the range (max LP5817_BURST_MAX)
+ * @return int 0=success, else I2C error
+ */
+static int lp5817_writeRegs(rgb_indicator_t *rgbi, uint8_t reg, const uint8_t *vals, size_t len)
+{
+    int ret;
+    uint8_t cmd[1 + LP5817_BURST_MAX];
+    lp5817_shadow_t *shadow = &(rgbi->shadow);
+    size_t first = 0;
+    size_t last = len;
+
+    __ASSERT_NO_MSG(len <= LP5817_BURST_MAX && reg + len <= LP5817_REG_FILE_SIZE);
+
+    if (!lp5817_dirtyRange(shadow, reg, vals, len, &first, &last))
+    {
+        return 0;                                                       // no change, skip I2C traffic
+    }
+
+    cmd[0] = reg + first;                                               // LP5817 auto-increments register address on burst
+    memcpy(&cmd[1], &vals[first], last - first);
+    ret = lp5817_i2cWrite(rgbi, cmd, 1 + last - first);
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    k_spinlock_key_t key = k_spin_lock(&(rgbi->xferLock));            // async completion also updates the shadow
+    lp5817_commitShadow(shadow, cmd[0], &cmd[1], last - first, ret == 0);
+    k_spin_unlock(&(rgbi->xferLock), key);
+#else
+    lp5817_commitShadow(shadow, cmd[0], &cmd[1], last - first, ret == 0);
+#endif
+    return ret;
+}
+
+
+/**
+ * @brief Record the outcome of a register burst in the shadow
+ * 
+ * @param shadow Shadow register file
+ * @param reg First register written
+ * @param vals Values written
+ * @param len Number of registers written
+ * @param ok Write succeeded, if false the registers are marked unknown to force a rewrite next time (vals unused)
+ */
+static void lp5817_commitShadow(lp5817_shadow_t *shadow, uint8_t reg, const uint8_t *vals, size_t len, bool ok)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (ok)
+        {
+            shadow->regs[reg + i] = vals[i];
+            shadow->validMask |= BIT64(reg + i);
+        }
+        else
+        {
+            shadow->validMask &= ~BIT64(reg + i);
+        }
+    }
+}
+
+
+/**
+ * @brief Find the span of registers that differ from the shadow (or are unknown)
+ * 
+ * @param shadow Shadow register file
+ * @param reg First register address of the range
+ * @param vals New register values
+ * @param len Number of registers in the range
+ * @param first Returns index (into vals) of first dirty register
+ * @param last Returns index one past the last dirty register
+ * @return true At least one register is dirty
+ * @return false Range matches chip state, nothing to write
+ */
+static bool lp5817_dirtyRange(const lp5817_shadow_t *shadow, uint8_t reg, const uint8_t *vals, size_t len, size_t *first, size_t *last)
+{
+    size_t f = 0;
+    size_t l = len;
+
+    while (f < l && (shadow->validMask & BIT64(reg + f)) && shadow->regs[reg + f] == vals[f])
+    {
+        f++;
+    }
+    if (f == l)
+    {
+        return false;
+    }
+    while ((shadow->validMask & BIT64(reg + l - 1)) && shadow->regs[reg + l - 1] == vals[l - 1])
+    {
+        l--;
+    }
+    *first = f;
+    *last = l;
+    return true;
+}
+
+
+/**
+ * @brief Write an LP5817 command register, commands are actions so are never filtered by the shadow
+ * 
+ * @param rgbi The RGB indicator to update
+ * @param reg Command register address
+ * @param cmd Command value
+ * @return int 0=success, else I2C error
+ */
+static int lp5817_writeCmd(rgb_indicator_t *rgbi, uint8_t reg, uint8_t cmd)
+{
+    uint8_t buf[2] = { reg, cmd };
+
+    return lp5817_i2cWrite(rgbi, buf, sizeof(buf));
+}
+
+
+/**
+ * @brief Blocking I2C write with retry, all chip writes go through here (counted when stats enabled)
+ * 
+ * @param rgbi The RGB indicator
+ * @param buf Register address followed by data
+ * @param len Bytes to write
+ * @return int 0=success, else I2C error of last attempt
+ */
+static int lp5817_i2cWrite(rgb_indicator_t *rgbi, const uint8_t *buf, size_t len)
+{
+    int ret;
+
+#if defined(CONFIG_RGBINDICATOR_PM)
+    ret = pm_device_runtime_get(rgbi->rgbdev->bus);                     // reference count only while indicator is awake
+    if (ret != 0)
+    {
+        return ret;
+    }
+#endif
+    for (int attempt = 0; ; attempt++)
+    {
+#if defined(CONFIG_RGBINDICATOR_HXBUS)
+        hxbus_xfer_t xfer;
+
+        hxbus_initWrite(&xfer, rgbi->rgbdev->addr, buf[0], &buf[1], len - 1, HXBUS_PRIO_COSMETIC);
+        ret = hxbus_transfer(&xfer, K_FOREVER);                         // sensor reads queued meanwhile go first
+#else
+        ret = i2c_write_dt(rgbi->rgbdev, buf, len);
+#endif
+        RGBI_STAT_INC(rgbi, i2cXfers);
+        RGBI_STAT_ADD(rgbi, i2cBytes, len);
+        if (ret == 0)
+        {
+            break;
+        }
+        RGBI_STAT_INC(rgbi, i2cNaks);
+        if (attempt >= CONFIG_RGBINDICATOR_I2C_RETRIES)
+        {
+            break;
+        }
+        RGBI_STAT_INC(rgbi, i2cRetries);
+    }
+#if defined(CONFIG_RGBINDICATOR_PM)
+    (void)pm_device_runtime_put(rgbi->rgbdev->bus);
+#endif
+    return ret;
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+
+/**
+ * @brief Stage new intensities and start a transfer if the bus is idle, does not wait for the bus
+ * 
+ * Only one transfer per indicator is in flight, colors posted while busy replace the staged
+ * color and go out (delta-only) when the in-flight transfer completes. The callback completes
+ * every post, failures included. With CONFIG_RGBINDICATOR_PM the pmLock mutex is taken (chip
+ * wake), thread context only: the front end calls this from the work handler.
+ * 
+ * @return int 0=posted, else wake or I2C submission error
+ */
+static int lp5817_setOutputsAsync(rgb_indicator_t *rgbi, const uint8_t levels[3], rgbi_callback_t callback, void *userData)
+{
+    int ret = 0;
+    bool start = false;
+    bool doneNow = false;
+    rgbi_callback_t supersededCb = NULL;
+    void *supersededData = NULL;
+    k_spinlock_key_t key;
+
+#if defined(CONFIG_RGBINDICATOR_PM)
+    __ASSERT(!k_is_in_isr(), "LP5817 async write under PM takes pmLock");
+    k_mutex_lock(&(rgbi->pmLock), K_FOREVER);                           // held until submitted, standby sees xferBusy
+    ret = lp5817_pmActivity(rgbi, (levels[0] | levels[1] | levels[2]) != 0);
+    if (ret != 0)
+    {
+        k_mutex_unlock(&(rgbi->pmLock));
+        if (callback != NULL)
+        {
+            callback(rgbi, ret, userData);
+        }
+        return ret;
+    }
+#endif
+    key = k_spin_lock(&(rgbi->xferLock));
+    memcpy(rgbi->staged, levels, sizeof(rgbi->staged));
+
+    if (rgbi->xferBusy)
+    {
+        supersededCb = rgbi->pendingCb;                                 // previously staged color will never be sent
+        supersededData = rgbi->pendingCbData;
+        rgbi->pendingCb = callback;
+        rgbi->pendingCbData = userData;
+        rgbi->xferPending = true;                                       // completion handler sends staged color
+    }
+    else
+    {
+        rgbi->xferCb = callback;
+        rgbi->xferCbData = userData;
+        start = lp5817_prepareXfer(rgbi);
+        doneNow = !start;
+    }
+    k_spin_unlock(&(rgbi->xferLock), key);
+
+    if (supersededCb != NULL)
+    {
+        supersededCb(rgbi, -ECANCELED, supersededData);
+    }
+
+    if (start)
+    {
+        ret = lp5817_submitXfer(rgbi);
+    }
+    else if (doneNow && callback != NULL)
+    {
+        callback(rgbi, 0, userData);                                    // nothing changed, complete immediately
+    }
+#if defined(CONFIG_RGBINDICATOR_PM)
+    k_mutex_unlock(&(rgbi->pmLock));
+#endif
+    return ret;
+}
+
+
+/**
+ * @brief Build the intensity burst for staged values (xferLock held)
+ * 
+ * @return true Transfer prepared and indicator marked busy, caller must submit
+ * @return false Staged values match chip, no transfer needed
+ */
+static bool lp5817_prepareXfer(rgb_indicator_t *rgbi)
+{
+    size_t first;
+    size_t last;
+
+    if (!lp5817_dirtyRange(&(rgbi->shadow), LP5817_REG_INTENSITY0, rgbi->staged, sizeof(rgbi->staged), &first, &last))
+    {
+        return false;
+    }
+
+    rgbi->xferBuf[0] = LP5817_REG_INTENSITY0 + first;
+    memcpy(&(rgbi->xferBuf[1]), &(rgbi->staged[first]), last - first);
+    rgbi->xferMsg.buf = rgbi->xferBuf;
+    rgbi->xferMsg.len = 1 + last - first;
+    rgbi->xferMsg.flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+    rgbi->xferAttempts = 0;
+    rgbi->xferBusy = true;
+    return true;
+}
+
+
+/**
+ * @brief Hand the prepared transfer to the I2C driver, on failure complete the update with the error
+ * 
+ * @return int 0=submitted, else I2C error
+ */
+static int lp5817_submitXfer(rgb_indicator_t *rgbi)
+{
+    int ret = lp5817_sendXfer(rgbi);
+
+    RGBI_STAT_INC(rgbi, i2cXfers);
+    RGBI_STAT_ADD(rgbi, i2cBytes, rgbi->xferMsg.len);
+    if (ret != 0)
+    {
+        LOG_ERR("Could not submit indicator update, err=%d", ret);
+        lp5817_xferComplete(rgbi->rgbdev->bus, ret, rgbi);               // unwind as a failed transfer, releases staged update
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Start the prepared burst on the bus (I2C driver callback or HX bus scheduler)
+ * 
+ * @return int 0=started
+ */
+static int lp5817_sendXfer(rgb_indicator_t *rgbi)
+{
+#if defined(CONFIG_RGBINDICATOR_HXBUS)
+    hxbus_initWrite(&(rgbi->hxXfer), rgbi->rgbdev->addr, rgbi->xferBuf[0], &(rgbi->xferBuf[1]), rgbi->xferMsg.len - 1, HXBUS_PRIO_COSMETIC);
+    return hxbus_submit(&(rgbi->hxXfer), K_FOREVER, lp5817_hxComplete, rgbi);
+#else
+    return i2c_transfer_cb_dt(rgbi->rgbdev, &(rgbi->xferMsg), 1, lp5817_xferComplete, rgbi);
+#endif
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_HXBUS)
+/**
+ * @brief HX bus completion, same handling as an I2C driver completion
+ */
+static void lp5817_hxComplete(hxbus_xfer_t *xfer, int result, void *userData)
+{
+    rgb_indicator_t *rgbi = (rgb_indicator_t *)userData;
+
+    ARG_UNUSED(xfer);
+    lp5817_xferComplete(rgbi->rgbdev->bus, result, rgbi);
+}
+#endif
+
+
+/**
+ * @brief I2C transfer completion, commits the burst to the shadow and sends any staged color
+ * 
+ * @param dev I2C bus device
+ * @param result Transfer result
+ * @param data The RGB indicator
+ */
+static void lp5817_xferComplete(const struct device *dev, int result, void *data)
+{
+    rgb_indicator_t *rgbi = (rgb_indicator_t *)data;
+    rgbi_callback_t doneCb;
+    void *doneData;
+    rgbi_callback_t nextCb = NULL;
+    void *nextData = NULL;
+    bool next = false;
+    k_spinlock_key_t key;
+
+    if (result != 0)
+    {
+        RGBI_STAT_INC(rgbi, i2cNaks);
+        if (rgbi->xferAttempts < CONFIG_RGBINDICATOR_I2C_RETRIES)      // resend same burst, staged colors wait
+        {
+            rgbi->xferAttempts++;
+            RGBI_STAT_INC(rgbi, i2cRetries);
+            RGBI_STAT_INC(rgbi, i2cXfers);
+            RGBI_STAT_ADD(rgbi, i2cBytes, rgbi->xferMsg.len);
+            if (lp5817_sendXfer(rgbi) == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    key = k_spin_lock(&(rgbi->xferLock));
+    lp5817_commitShadow(&(rgbi->shadow), rgbi->xferBuf[0], &(rgbi->xferBuf[1]), rgbi->xferMsg.len - 1, result == 0);
+    doneCb = rgbi->xferCb;
+    doneData = rgbi->xferCbData;
+    rgbi->xferCb = NULL;
+    rgbi->xferBusy = false;
+
+    if (rgbi->xferPending)
+    {
+        rgbi->xferPending = false;
+        rgbi->xferCb = rgbi->pendingCb;
+        rgbi->xferCbData = rgbi->pendingCbData;
+        rgbi->pendingCb = NULL;
+        next = lp5817_prepareXfer(rgbi);
+        if (!next)
+        {
+            nextCb = rgbi->xferCb;                                      // staged color already on chip
+            nextData = rgbi->xferCbData;
+            rgbi->xferCb = NULL;
+        }
+    }
+    k_spin_unlock(&(rgbi->xferLock), key);
+
+    if (result != 0)
+    {
+        LOG_ERR("Indicator update failed, err=%d", result);
+    }
+    if (doneCb != NULL)
+    {
+        doneCb(rgbi, result, doneData);
+    }
+    if (next)
+    {
+        (void)lp5817_submitXfer(rgbi);
+    }
+    else if (nextCb != NULL)
+    {
+        nextCb(rgbi, 0, nextData);
+    }
+}
+
+
+/**
+ * @brief Completion callback used by the blocking API, wakes the waiting caller
+ */
+static void syncComplete(rgb_indicator_t *rgbi, int result, void *userData)
+{
+    struct syncWait *wait = (struct syncWait *)userData;
+
+    wait->result = result;
+    k_sem_give(&(wait->done));
+}
+
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+/**
+ * @brief Convert sequence times to engine time codes
+ * 
+ * Flash times must be within CONFIG_RGBINDICATOR_AUTONOMOUS_TOLERANCE of a step (the timer path
+ * runs the others exactly), breathe times take the nearest step.
+ * 
+ * @param cmd Flash or breathe command
+ * @param timeCodes Returns fade in, on, fade out, off codes
+ * @return true Sequence can be run by the engine
+ */
+static bool lp5817_autoEncode(const rgbi_cmd_t *cmd, uint8_t timeCodes[4])
+{
+    uint32_t tolerancePct = (cmd->op == RGBI_CMD_FLASH) ? CONFIG_RGBINDICATOR_AUTONOMOUS_TOLERANCE : UINT32_MAX;
+
+    return cmd->count <= LP5817_AUTO_PLAYBACK_MAX &&
+           lp5817_autoTimeCode(cmd->fadeIn, tolerancePct, &timeCodes[0]) &&
+           lp5817_autoTimeCode(cmd->onDuration, tolerancePct, &timeCodes[1]) &&
+           lp5817_autoTimeCode(cmd->fadeOut, tolerancePct, &timeCodes[2]) &&
+           lp5817_autoTimeCode(cmd->offDuration, tolerancePct, &timeCodes[3]);
+}
+
+
+/**
+ * @brief Program all 3 engines with one burst and start the animation
+ * 
+ * @param rgbi The RGB indicator
+ * @param peak Peak intensities, output order
+ * @param timeCodes T1-T4 engine time codes
+ * @param count Playback count, 0=infinite
+ * @return int 0=success
+ */
+static int lp5817_startAuto(rgb_indicator_t *rgbi, const uint8_t peak[3], const uint8_t timeCodes[4], uint8_t count)
+{
+    int ret;
+    uint8_t engines[3 * LP5817_AUTO_BLOCK_SIZE];
+    const uint8_t autoEnable = LP5817_CMD_AUTOENABLE;
+
+    for (size_t out = 0; out < 3; out++)
+    {
+        uint8_t *block = &engines[out * LP5817_AUTO_BLOCK_SIZE];
+
+        block[LP5817_AUTO_PWM_LOW] = 0;
+        block[LP5817_AUTO_PWM_HIGH] = peak[out];
+        block[LP5817_AUTO_T12] = (timeCodes[0] << 4) | timeCodes[1];
+        block[LP5817_AUTO_T34] = (timeCodes[2] << 4) | timeCodes[3];
+        block[LP5817_AUTO_PLAYBACK] = (count == 0) ? LP5817_AUTO_PLAYBACK_INFINITE : count;
+    }
+
+#if defined(CONFIG_RGBINDICATOR_PM)
+    k_mutex_lock(&(rgbi->pmLock), K_FOREVER);
+    ret = lp5817_pmActivity(rgbi, true);                                // engine drives the outputs, stay awake
+    if (ret == 0)
+    {
+        ret = lp5817_writeRegs(rgbi, LP5817_REG_AUTO_BASE, engines, sizeof(engines));
+    }
+#else
+    ret = lp5817_writeRegs(rgbi, LP5817_REG_AUTO_BASE, engines, sizeof(engines));
+#endif
+    if (ret == 0)
+    {
+        ret = lp5817_writeRegs(rgbi, LP5817_REG_AUTOENABLE, &autoEnable, 1);
+    }
+    if (ret == 0)
+    {
+        ret = lp5817_writeCmd(rgbi, LP5817_REG_UPDATE, LP5817_CMD_UPDATE);
+    }
+    if (ret == 0)
+    {
+        ret = lp5817_writeCmd(rgbi, LP5817_REG_START, LP5817_CMD_START);
+    }
+#if defined(CONFIG_RGBINDICATOR_PM)
+    k_mutex_unlock(&(rgbi->pmLock));
+#endif
+    return ret;
+}
+
+
+/**
+ * @brief Stop the animation engines and return outputs to manual intensity control
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=success
+ */
+static int lp5817_stopAuto(rgb_indicator_t *rgbi)
+{
+    int ret;
+    const uint8_t autoEnable = 0;
+
+    ret = lp5817_writeCmd(rgbi, LP5817_REG_STOP, LP5817_CMD_STOP);
+    ret += lp5817_writeRegs(rgbi, LP5817_REG_AUTOENABLE, &autoEnable, 1);
+    ret += lp5817_writeCmd(rgbi, LP5817_REG_UPDATE, LP5817_CMD_UPDATE);
+    if (ret != 0)
+    {
+        LOG_ERR("Failed to stop LP5817 animation");
+    }
+#if defined(CONFIG_RGBINDICATOR_PM)
+    k_mutex_lock(&(rgbi->pmLock), K_FOREVER);
+    (void)lp5817_pmActivity(rgbi, false);                               // manual outputs normally dark, standby checks
+    k_mutex_unlock(&(rgbi->pmLock));
+#endif
+    return ret;
+}
+
+
+/**
+ * @brief Convert a duration to the nearest animation engine time code
+ * 
+ * @param duration Requested duration
+ * @param tolerancePct Largest rounding error accepted, percent of the duration (UINT32_MAX=any)
+ * @param code Returns engine time code 0-15
+ * @return true Duration is within the engine range and tolerance
+ * @return false Duration too long for the engine or not close enough to a step
+ */
+static bool lp5817_autoTimeCode(k_timeout_t duration, uint32_t tolerancePct, uint8_t *code)
+{
+    int64_t ms = k_ticks_to_ms_floor64(duration.ticks);
+    uint8_t best = 0;
+
+    if (ms > lp5817_autoTimeMs[ARRAY_SIZE(lp5817_autoTimeMs) - 1])
+    {
+        return false;
+    }
+    for (uint8_t i = 1; i < ARRAY_SIZE(lp5817_autoTimeMs); i++)
+    {
+        if (llabs(ms - lp5817_autoTimeMs[i]) < llabs(ms - lp5817_autoTimeMs[best]))
+        {
+            best = i;
+        }
+    }
+    if (tolerancePct != UINT32_MAX && llabs(ms - lp5817_autoTimeMs[best]) * 100 > ms * tolerancePct)
+    {
+        return false;
+    }
+    *code = best;
+    return true;
+}
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_PM)
+/**
+ * @brief Put the chip in standby if idle, releases the HX bus
+ */
+int rgbi_pmStandby(rgb_indicator_t *rgbi)
+{
+    const uint8_t disable = 0;
+    int ret = 0;
+
+    k_mutex_lock(&(rgbi->pmLock), K_FOREVER);
+    if (rgbi->awake)
+    {
+        if (!lp5817_isIdle(rgbi))
+        {
+            ret = -EBUSY;
+        }
+        else
+        {
+            ret = lp5817_writeRegs(rgbi, LP5817_REG_CHIPENABLE, &disable, 1);
+            if (ret == 0)
+            {
+                rgbi->awake = false;
+                (void)pm_device_runtime_put(rgbi->rgbdev->bus);
+            }
+        }
+    }
+    k_mutex_unlock(&(rgbi->pmLock));
+    return ret;
+}
+
+
+/**
+ * @brief Track output activity (pmLock held): lit outputs wake the chip, dark outputs schedule standby
+ * 
+ * @param rgbi The RGB indicator
+ * @param lit Outputs about to be driven (color or engine)
+ * @return int 0=chip ready for the write, else wake error
+ */
+static int lp5817_pmActivity(rgb_indicator_t *rgbi, bool lit)
+{
+    if (lit)
+    {
+        (void)k_work_cancel_delayable(&(rgbi->standbyWork));
+    }
+    else
+    {
+        (void)rgbi_scheduleWork(&(rgbi->standbyWork), K_MSEC(CONFIG_RGBINDICATOR_PM_STANDBY_MS));
+    }
+
+    if (!rgbi->awake && (lit || !lp5817_isIdle(rgbi)))                  // dark write to outputs not known dark also needs the bus
+    {
+        return lp5817_wake(rgbi);
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Fast wake: take the HX bus and enable the chip with one configuration burst
+ * 
+ * The chip keeps its registers in standby, so with a valid shadow the burst is trimmed to the
+ * CHIP_EN register alone (one 2 byte write). Configuration that is unknown (failed write) is
+ * restored from the shadow values.
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=awake
+ */
+static int lp5817_wake(rgb_indicator_t *rgbi)
+{
+    const uint8_t config[3] = { LP5817_CMD_CHIPENABLE, rgbi->config->maxCurrent, LP5817_CMD_OUTENABLE };
+    bool restore = (rgbi->shadow.validMask & LP5817_RETAINED_MASK) != LP5817_RETAINED_MASK;
+    int ret;
+
+    ret = pm_device_runtime_get(rgbi->rgbdev->bus);
+    if (ret != 0)
+    {
+        LOG_ERR("HX bus resume failed, err=%d", ret);
+        return ret;
+    }
+
+    ret = lp5817_writeRegs(rgbi, LP5817_REG_CHIPENABLE, config, sizeof(config));     // 0x00-0x02 in one burst
+    if (ret == 0 && restore)
+    {
+        ret = lp5817_setDotCurrent(rgbi);
+        if (ret == 0)
+        {
+            ret = lp5817_writeCmd(rgbi, LP5817_REG_UPDATE, LP5817_CMD_UPDATE);
+        }
+    }
+    if (ret != 0)
+    {
+        LOG_ERR("LP5817 wake failed, err=%d", ret);
+        (void)pm_device_runtime_put(rgbi->rgbdev->bus);
+        return ret;
+    }
+    rgbi->awake = true;
+    return 0;
+}
+
+
+/**
+ * @brief Determine if the chip can be put in standby: outputs known dark, no engine or update underway
+ * 
+ * @param rgbi The RGB indicator
+ * @return true Idle
+ */
+static bool lp5817_isIdle(rgb_indicator_t *rgbi)
+{
+    bool idle = true;
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    k_spinlock_key_t key = k_spin_lock(&(rgbi->xferLock));
+
+    idle = !rgbi->xferBusy && !rgbi->xferPending;
+#endif
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+    idle = idle && !rgbi->hwSequence;
+#endif
+    for (uint8_t reg = LP5817_REG_INTENSITY0; reg <= LP5817_REG_INTENSITY2 && idle; reg++)
+    {
+        idle = (rgbi->shadow.validMask & BIT64(reg)) && rgbi->shadow.regs[reg] == 0;
+    }
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    k_spin_unlock(&(rgbi->xferLock), key);
+#endif
+    return idle;
+}
+
+
+/**
+ * @brief Delayed standby, outputs have been dark for CONFIG_RGBINDICATOR_PM_STANDBY_MS
+ * 
+ * @param work Standby work item
+ */
+static void standby_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    rgb_indicator_t *rgbi = CONTAINER_OF(dwork, rgb_indicator_t, standbyWork);
+
+    (void)rgbi_pmStandby(rgbi);                                         // -EBUSY: lit again, next dark write reschedules
+}
+#endif
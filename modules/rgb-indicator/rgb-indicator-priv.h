@@ -0,0 +1,263 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RGB_INDICATOR_PRIV
+#define RGB_INDICATOR_PRIV
+
+/* Module internal interfaces shared between rgb-indicator source files, not for application use
+ */
+
+#include <zephyr/drivers/led.h>
+#include "include/rgb-indicator.h"
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+#define RGBI_STAT_INC(_rgbi, _field) ((_rgbi)->stats._field++)
+#define RGBI_STAT_ADD(_rgbi, _field, _n) ((_rgbi)->stats._field += (_n))
+#else
+#define RGBI_STAT_INC(_rgbi, _field)
+#define RGBI_STAT_ADD(_rgbi, _field, _n)
+#endif
+
+/* Output backend, one per indicator: LP5817 (I2C) or PWM. The front end (rgb-indicator.c) owns
+ * color mapping, sequences and settings, backends only drive outputs. Levels are in output order
+ * (channel map, gamma and calibration already applied).
+ */
+typedef struct _rgbi_backend
+{
+    int (*configure)(rgb_indicator_t *rgbi);                                    // enable outputs, apply currents, outputs off
+    int (*setOutputs)(rgb_indicator_t *rgbi, const uint8_t levels[3]);          // blocking until the outputs show the levels
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    int (*setOutputsAsync)(rgb_indicator_t *rgbi, const uint8_t levels[3], rgbi_callback_t callback, void *userData);  // work handler, callback on every post; NULL: setOutputs + callback
+    bool (*isUpdating)(rgb_indicator_t *rgbi);                                  // NULL: never has updates outstanding
+#endif
+    int (*setCurrents)(rgb_indicator_t *rgbi);                                  // brightness/calibration changed
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+    bool (*seqFits)(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd);              // NULL: no hardware sequencer
+    int (*seqStart)(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, const uint8_t peak[3], uint32_t *runMs);   // -ENOTSUP: timer driven
+    void (*seqStop)(rgb_indicator_t *rgbi);
+#endif
+} rgbi_backend_t;
+
+
+/* Device data of indicator LED devices (any backend), rgbi_fromDevice() relies on rgbi being first
+ */
+struct rgbi_devData
+{
+    rgb_indicator_t rgbi;
+    struct led_rgb color;                                                       // led_blink() color: last non-black LED API color, 0=white
+};
+
+extern const struct led_driver_api rgbi_ledApi;                                 // LED API shared by the indicator devices
+
+
+/**
+ * @brief Initialize the indicator front end, called by the backend init once its own state is set up
+ * 
+ * @param rgbi The RGB indicator
+ * @param backend Output driver operations (ROM)
+ * @param config Channel map and currents, must remain valid (ROM)
+ * @param id Indicator identity for settings and logs (LP5817 I2C address, PWM 0x80 + instance)
+ * @param idScope Device id is unique on (LP5817 I2C bus, PWM indicator device), part of the settings key
+ * @return int 0=success
+ */
+int rgbi_initIndicator(rgb_indicator_t *rgbi, const rgbi_backend_t *backend, const lp5817_config_t *config, uint8_t id,
+                       const struct device *idScope);
+
+
+#if defined(CONFIG_RGBINDICATOR_BACKEND_LP5817)
+/**
+ * @brief Initialize an indicator with a specific LP5817 configuration
+ * 
+ * @param rgbi The RGB indicator
+ * @param rgb_dev I2C spec of the LP5817
+ * @param config Chip configuration (channel map, currents), must remain valid (ROM)
+ * @return int 0=success
+ */
+int rgbi_initConfig(rgb_indicator_t *rgbi, const struct i2c_dt_spec *rgb_dev, const lp5817_config_t *config);
+#endif
+
+
+/**
+ * @brief Schedule delayed indicator work on the indicator workqueue (system workqueue without it)
+ * 
+ * @param dwork Delayable work item
+ * @param delay Delay before the work runs
+ * @return int k_work_schedule result
+ */
+int rgbi_scheduleWork(struct k_work_delayable *dwork, k_timeout_t delay);
+
+
+/**
+ * @brief Submit indicator work to the indicator workqueue (system workqueue without it)
+ * 
+ * @param work Work item
+ * @return int k_work_submit result
+ */
+int rgbi_submitWork(struct k_work *work);
+
+
+/**
+ * @brief Prepare an expiry scheduler node, not armed
+ * 
+ * @param timer Scheduler node
+ * @param handler Called on the indicator workqueue when the node expires
+ */
+void rgbi_schedInit(rgbi_timer_t *timer, void (*handler)(rgbi_timer_t *timer));
+
+
+/**
+ * @brief Arm a scheduler node, replaces an expiry already armed; callable from any context
+ * 
+ * Expiries due within CONFIG_RGBINDICATOR_SCHED_COALESCE_MS of a scheduler wakeup are fired by
+ * that wakeup, up to that much early.
+ * 
+ * @param timer Scheduler node
+ * @param delay Relative time to expiry, K_FOREVER disarms the node
+ * @return int 0=armed (or disarmed for K_FOREVER), -EINVAL absolute timeout, node left as it was
+ */
+int rgbi_schedArm(rgbi_timer_t *timer, k_timeout_t delay);
+
+
+/**
+ * @brief Disarm a scheduler node, no-op if not armed; callable from any context
+ * 
+ * @param timer Scheduler node
+ */
+void rgbi_schedCancel(rgbi_timer_t *timer);
+
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+/**
+ * @brief Cycle count of the last scheduler timer expiry, start of the expiry to handler latency
+ * 
+ * @return uint32_t k_cycle_get_32() in the timer ISR
+ */
+uint32_t rgbi_schedWakeCycles(void);
+#endif
+
+
+/**
+ * @brief Output a color from a timed sequence (flash, pattern), posted without blocking when async is enabled
+ * 
+ * @param rgbi The RGB indicator
+ * @param red Red channel intensity
+ * @param green Green channel intensity
+ * @param blue Blue channel intensity
+ */
+void rgbi_outputColor(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue);
+
+
+/**
+ * @brief Post a sequence command, replaces an older command not yet applied
+ * 
+ * Constant time and callable from any context, the command is applied by the work handler.
+ * 
+ * @param rgbi The RGB indicator
+ * @param cmd Command to post (copied)
+ */
+void rgbi_post(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd);
+
+
+/**
+ * @brief Arm flashTimer for the sequence currently running, work handler context only
+ * 
+ * The expiry is stamped with the running sequence generation, an expiry belonging to a sequence
+ * that was replaced by a command applied with it is discarded.
+ * 
+ * @param rgbi The RGB indicator
+ * @param delay Time to next sequence edge
+ */
+void rgbi_armTimer(rgb_indicator_t *rgbi, k_timeout_t delay);
+
+
+/**
+ * @brief Stop a hardware sequence (LP5817 engine, nRF PWM loop), if running, before the MCU takes over the outputs
+ * 
+ * @param rgbi The RGB indicator
+ */
+void rgbi_stopEngine(rgb_indicator_t *rgbi);
+
+
+/**
+ * @brief Determine if a device is an indicator device ("ti,lp5817" or "loouq,rgb-indicator-pwm")
+ * 
+ * @param dev Device to check
+ * @return true Device is an indicator, rgbi_fromDevice() is valid
+ */
+bool rgbi_isIndicatorDevice(const struct device *dev);
+
+
+#if defined(CONFIG_RGBINDICATOR_PM)
+/**
+ * @brief Put the LP5817 in standby and release the HX bus if all outputs are dark
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=in standby, -EBUSY outputs lit or update underway, else I2C error
+ */
+int rgbi_pmStandby(rgb_indicator_t *rgbi);
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+/**
+ * @brief Prepare an indicator's RAM settings from its configuration, nothing is read yet
+ * 
+ * @param rgbi The RGB indicator
+ * @param config Default (devicetree or built-in) configuration
+ */
+void rgbi_settingsInit(rgb_indicator_t *rgbi, const lp5817_config_t *config);
+
+
+/**
+ * @brief Replace the defaults with the stored calibration and brightness, if present
+ * 
+ * Reads flash, called from chip configuration (background with CONFIG_RGBINDICATOR_DEFERRED_INIT).
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=loaded or nothing stored, else settings error (defaults are kept)
+ */
+int rgbi_settingsLoad(rgb_indicator_t *rgbi);
+
+
+/**
+ * @brief Note a runtime change, the record is written back at the end of the writeback interval
+ * 
+ * @param rgbi The RGB indicator
+ */
+void rgbi_settingsChanged(rgb_indicator_t *rgbi);
+
+
+/**
+ * @brief Check a calibration before it is used, channelMap indexes the output registers
+ * 
+ * @param calib Calibration to check
+ * @return true Channel map is a permutation of the outputs 0-2
+ */
+bool rgbi_settingsValid(const lp5817_config_t *calib);
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+/**
+ * @brief Start a pattern, work handler context only (applies RGBI_CMD_PLAY)
+ * 
+ * @param rgbi The RGB indicator
+ * @param pattern Pattern step table
+ */
+void rgbi_seqStart(rgb_indicator_t *rgbi, const rgbi_step_t *pattern);
+
+
+/**
+ * @brief Run the pattern from the cursor until the next timed step, arms flashTimer for it
+ * 
+ * Called from the flash timer expiry handler (indicator workqueue).
+ * 
+ * @param rgbi The RGB indicator
+ */
+void rgbi_seqRun(rgb_indicator_t *rgbi);
+#endif
+
+#endif
@@ -0,0 +1,477 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT loouq_rgb_indicator_pwm
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/util.h>
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+#include <zephyr/drivers/pinctrl.h>
+#include <zephyr/dt-bindings/pwm/pwm.h>
+#include <hal/nrf_pwm.h>
+#else
+#include <zephyr/drivers/pwm.h>
+#endif
+
+#include "rgb-indicator-priv.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(rgb_indicator);
+
+/* PWM backend: one PWM output per LED color. Duty = level x dot-current x brightness, so brightness
+ * and calibration changes only rescale the duty cycles (no color table rebuild).
+ *
+ * nRF (CONFIG_RGBINDICATOR_PWM_NRF): the indicator owns the PWM instance. A solid color is one
+ * sequence value the peripheral repeats on its own. A flash is SEQ0 = on value held for the on time
+ * (REFRESH), SEQ1 = off value held for the off time, LOOP = flash count, so the whole flash runs
+ * without timer edges or CPU wakeups. Otherwise the Zephyr PWM API sets the outputs and flashes are
+ * timer driven by the front end.
+ */
+
+#define RGBPWM_ID_BASE 0x80                                                     // rgbi id 0x80 + instance, LP5817 ids are I2C addresses
+#define RGBPWM_DUTY_MAX (UINT8_MAX * UINT8_MAX)                                 // rgbpwm_duty() full scale
+
+struct rgbpwm_config                                                            // ROM, one per devicetree instance
+{
+    lp5817_config_t chip;                                                       // channel map, dot-current (duty scale), color scale
+    uint8_t id;
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+    NRF_PWM_Type *pwm;
+    const struct pinctrl_dev_config *pcfg;
+    uint16_t top;                                                               // COUNTERTOP, period in 1MHz clocks
+    uint8_t channel[3];                                                         // PWM channel per output
+    uint8_t inverted;                                                           // bit per output, PWM_POLARITY_INVERTED
+#else
+    struct pwm_dt_spec outputs[3];
+#endif
+};
+
+struct rgbpwm_data
+{
+    struct rgbi_devData dev;                                                    // first, see rgbi_fromDevice()
+    const struct rgbpwm_config *config;
+    struct k_mutex lock;                                                        // output state and PWM registers, backend ops run in thread context
+    uint8_t levels[3];                                                          // last levels set, output order
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+    uint8_t peak[3];                                                            // flash on levels while a sequence runs
+    bool running;                                                               // sequence playback started, not yet stopped
+    uint16_t solid[NRF_PWM_CHANNEL_COUNT];                                      // sequence values (EasyDMA, RAM), individual decoder
+    uint16_t on[NRF_PWM_CHANNEL_COUNT];
+    uint16_t off[NRF_PWM_CHANNEL_COUNT];
+#endif
+};
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static int rgbpwm_configure(rgb_indicator_t *rgbi);
+static int rgbpwm_setOutputs(rgb_indicator_t *rgbi, const uint8_t levels[3]);
+static int rgbpwm_setCurrents(rgb_indicator_t *rgbi);
+static inline uint32_t rgbpwm_duty(const rgb_indicator_t *rgbi, size_t output, uint8_t level);
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+static bool rgbpwm_seqFits(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd);
+static int rgbpwm_seqStart(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, const uint8_t peak[3], uint32_t *runMs);
+static void rgbpwm_seqStop(rgb_indicator_t *rgbi);
+static uint32_t rgbpwm_periods(const struct rgbpwm_config *config, k_timeout_t duration);
+static void rgbpwm_fillValues(struct rgbpwm_data *data, const uint8_t levels[3], uint16_t values[NRF_PWM_CHANNEL_COUNT]);
+static void rgbpwm_playSolid(struct rgbpwm_data *data);                        // lock held
+static void rgbpwm_stop(struct rgbpwm_data *data);                             // lock held
+#endif
+
+static const rgbi_backend_t rgbpwm_backend =
+{
+    .configure = rgbpwm_configure,
+    .setOutputs = rgbpwm_setOutputs,
+    .setCurrents = rgbpwm_setCurrents,
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+    .seqFits = rgbpwm_seqFits,
+    .seqStart = rgbpwm_seqStart,
+    .seqStop = rgbpwm_seqStop,
+#endif
+};
+
+
+/* Backend operations
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Route the PWM channels and set up the counter, outputs off
+ *
+ * @param rgbi The RGB indicator
+ * @return int 0=success
+ */
+static int rgbpwm_configure(rgb_indicator_t *rgbi)
+{
+    const uint8_t off[3] = { 0, 0, 0 };
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+    struct rgbpwm_data *data = CONTAINER_OF(rgbi, struct rgbpwm_data, dev.rgbi);
+    const struct rgbpwm_config *config = data->config;
+    int ret = pinctrl_apply_state(config->pcfg, PINCTRL_STATE_DEFAULT);
+
+    if (ret != 0)
+    {
+        LOG_ERR("Failed to route PWM indicator 0x%02x pins, err=%d", rgbi->id, ret);
+        return ret;
+    }
+    nrf_pwm_configure(config->pwm, NRF_PWM_CLK_1MHz, NRF_PWM_MODE_UP, config->top);
+    nrf_pwm_decoder_set(config->pwm, NRF_PWM_LOAD_INDIVIDUAL, NRF_PWM_STEP_AUTO);
+    nrf_pwm_seq_end_delay_set(config->pwm, 0, 0);
+    nrf_pwm_seq_end_delay_set(config->pwm, 1, 0);
+#endif
+    return rgbpwm_setOutputs(rgbi, off);
+}
+
+
+/**
+ * @brief Set the output duty cycles, stored only while a hardware flash owns the outputs
+ *
+ * @param rgbi The RGB indicator
+ * @param levels Intensities, output order
+ * @return int 0=success, else PWM driver error
+ */
+static int rgbpwm_setOutputs(rgb_indicator_t *rgbi, const uint8_t levels[3])
+{
+    struct rgbpwm_data *data = CONTAINER_OF(rgbi, struct rgbpwm_data, dev.rgbi);
+    k_mutex_lock(&(data->lock), K_FOREVER);
+    int ret = 0;
+
+    memcpy(data->levels, levels, sizeof(data->levels));
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+    if (!rgbi->hwSequence)                                                      // seqStop() restores the stored levels
+    {
+        rgbpwm_playSolid(data);
+    }
+#else
+    for (size_t i = 0; i < ARRAY_SIZE(data->config->outputs) && ret == 0; i++)  // under the lock, stored levels match the outputs
+    {
+        const struct pwm_dt_spec *out = &(data->config->outputs[i]);
+
+        ret = pwm_set_pulse_dt(out, (uint64_t)out->period * rgbpwm_duty(rgbi, i, data->levels[i]) / RGBPWM_DUTY_MAX);
+    }
+#endif
+    k_mutex_unlock(&(data->lock));
+    return ret;
+}
+
+
+/**
+ * @brief Brightness or calibration changed, rescale the duty cycles of the levels showing
+ *
+ * @param rgbi The RGB indicator
+ * @return int 0=success, else PWM driver error
+ */
+static int rgbpwm_setCurrents(rgb_indicator_t *rgbi)
+{
+    struct rgbpwm_data *data = CONTAINER_OF(rgbi, struct rgbpwm_data, dev.rgbi);
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+    k_mutex_lock(&(data->lock), K_FOREVER);
+
+    if (rgbi->hwSequence)
+    {
+        rgbpwm_fillValues(data, data->peak, data->on);                         // loaded by the next flash, no restart
+    }
+    else
+    {
+        rgbpwm_playSolid(data);
+    }
+    k_mutex_unlock(&(data->lock));
+    return 0;
+#else
+    uint8_t levels[3];
+
+    k_mutex_lock(&(data->lock), K_FOREVER);
+    memcpy(levels, data->levels, sizeof(levels));
+    k_mutex_unlock(&(data->lock));
+    return rgbpwm_setOutputs(rgbi, levels);                                     // work handler, no output write can come between
+#endif
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+/**
+ * @brief Determine if the PWM sequencer can run a sequence: flashes (no fades) of at least one period
+ */
+static bool rgbpwm_seqFits(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd)
+{
+    struct rgbpwm_data *data = CONTAINER_OF(rgbi, struct rgbpwm_data, dev.rgbi);
+    uint32_t onPeriods = rgbpwm_periods(data->config, cmd->onDuration);
+    uint32_t offPeriods = rgbpwm_periods(data->config, cmd->offDuration);
+
+    return cmd->op == RGBI_CMD_FLASH &&
+           K_TIMEOUT_EQ(cmd->fadeIn, K_NO_WAIT) && K_TIMEOUT_EQ(cmd->fadeOut, K_NO_WAIT) &&
+           onPeriods > 0 && onPeriods <= PWM_SEQ_REFRESH_REFRESH_Msk + 1 &&
+           offPeriods > 0 && offPeriods <= PWM_SEQ_REFRESH_REFRESH_Msk + 1;
+}
+
+
+/**
+ * @brief Run a flash on the PWM sequencer: SEQ0 on, SEQ1 off, looped count times (or forever)
+ *
+ * @param rgbi The RGB indicator
+ * @param cmd Flash command
+ * @param peak On intensities, output order
+ * @param runMs Returns the run time of a count limited flash
+ * @return int 0=sequence running, -ENOTSUP not a flash the sequencer can run
+ */
+static int rgbpwm_seqStart(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, const uint8_t peak[3], uint32_t *runMs)
+{
+    struct rgbpwm_data *data = CONTAINER_OF(rgbi, struct rgbpwm_data, dev.rgbi);
+    const struct rgbpwm_config *config = data->config;
+    const uint8_t dark[3] = { 0, 0, 0 };
+    uint32_t onPeriods;
+    uint32_t offPeriods;
+
+    if (!rgbpwm_seqFits(rgbi, cmd))
+    {
+        return -ENOTSUP;
+    }
+    onPeriods = rgbpwm_periods(config, cmd->onDuration);
+    offPeriods = rgbpwm_periods(config, cmd->offDuration);
+    *runMs = (uint32_t)((uint64_t)(onPeriods + offPeriods) * config->top * cmd->count / USEC_PER_MSEC);
+
+    k_mutex_lock(&(data->lock), K_FOREVER);
+    memcpy(data->peak, peak, sizeof(data->peak));
+    rgbpwm_fillValues(data, peak, data->on);
+    rgbpwm_fillValues(data, dark, data->off);
+
+    rgbpwm_stop(data);                                                          // sequence registers are loaded on SEQSTART
+    nrf_pwm_seq_ptr_set(config->pwm, 0, data->on);
+    nrf_pwm_seq_cnt_set(config->pwm, 0, NRF_PWM_CHANNEL_COUNT);
+    nrf_pwm_seq_refresh_set(config->pwm, 0, onPeriods - 1);                     // value repeats REFRESH + 1 periods
+    nrf_pwm_seq_ptr_set(config->pwm, 1, data->off);
+    nrf_pwm_seq_cnt_set(config->pwm, 1, NRF_PWM_CHANNEL_COUNT);
+    nrf_pwm_seq_refresh_set(config->pwm, 1, offPeriods - 1);
+    if (cmd->count > 0)
+    {
+        nrf_pwm_loop_set(config->pwm, cmd->count);
+        nrf_pwm_shorts_set(config->pwm, NRF_PWM_SHORT_LOOPSDONE_STOP_MASK);     // ends dark, front end timer restores solid
+    }
+    else
+    {
+        nrf_pwm_loop_set(config->pwm, 1);
+        nrf_pwm_shorts_set(config->pwm, NRF_PWM_SHORT_LOOPSDONE_SEQSTART0_MASK);
+    }
+    nrf_pwm_enable(config->pwm);
+    nrf_pwm_task_trigger(config->pwm, NRF_PWM_TASK_SEQSTART0);
+    data->running = true;
+    k_mutex_unlock(&(data->lock));
+    return 0;
+}
+
+
+/**
+ * @brief End a flash, the outputs return to the last levels set
+ */
+static void rgbpwm_seqStop(rgb_indicator_t *rgbi)
+{
+    struct rgbpwm_data *data = CONTAINER_OF(rgbi, struct rgbpwm_data, dev.rgbi);
+    k_mutex_lock(&(data->lock), K_FOREVER);
+
+    rgbpwm_playSolid(data);
+    k_mutex_unlock(&(data->lock));
+}
+#endif
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Output duty: level scaled by the output's dot-current and the brightness
+ *
+ * @param rgbi The RGB indicator
+ * @param output Output 0-2
+ * @param level Intensity
+ * @return uint32_t Duty, 0 to RGBPWM_DUTY_MAX
+ */
+static inline uint32_t rgbpwm_duty(const rgb_indicator_t *rgbi, size_t output, uint8_t level)
+{
+    return (uint32_t)level * rgbi->config->dotCurrent[output] * rgbi->brightness / UINT8_MAX;
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+/**
+ * @brief Convert a sequence time to PWM periods, rounded to the nearest period
+ */
+static uint32_t rgbpwm_periods(const struct rgbpwm_config *config, k_timeout_t duration)
+{
+    uint64_t us = k_ticks_to_us_near64(duration.ticks);
+
+    return (uint32_t)MIN((us + config->top / 2) / config->top, UINT32_MAX);
+}
+
+
+/**
+ * @brief Build the individual decoder values (compare + polarity) for a set of levels
+ *
+ * @param data Indicator instance
+ * @param levels Intensities, output order
+ * @param values Returns the sequence value, unused channels off
+ */
+static void rgbpwm_fillValues(struct rgbpwm_data *data, const uint8_t levels[3], uint16_t values[NRF_PWM_CHANNEL_COUNT])
+{
+    const struct rgbpwm_config *config = data->config;
+
+    for (size_t ch = 0; ch < NRF_PWM_CHANNEL_COUNT; ch++)
+    {
+        values[ch] = BIT(15);                                                   // normal polarity, compare 0 = low
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(config->channel); i++)
+    {
+        uint16_t compare = rgbpwm_duty(&(data->dev.rgbi), i, levels[i]) * config->top / RGBPWM_DUTY_MAX;
+
+        values[config->channel[i]] = (config->inverted & BIT(i)) ? compare : (compare | BIT(15));
+    }
+}
+
+
+/**
+ * @brief Show the stored levels: one value repeated by the peripheral, stopped when dark (lock held)
+ *
+ * @param data Indicator instance
+ */
+static void rgbpwm_playSolid(struct rgbpwm_data *data)
+{
+    const struct rgbpwm_config *config = data->config;
+
+    rgbpwm_stop(data);
+    if ((data->levels[0] | data->levels[1] | data->levels[2]) == 0)
+    {
+        nrf_pwm_disable(config->pwm);                                           // pins return to their inactive (GPIO) level
+        return;
+    }
+    rgbpwm_fillValues(data, data->levels, data->solid);
+    nrf_pwm_seq_ptr_set(config->pwm, 0, data->solid);
+    nrf_pwm_seq_cnt_set(config->pwm, 0, NRF_PWM_CHANNEL_COUNT);
+    nrf_pwm_seq_refresh_set(config->pwm, 0, 0);
+    nrf_pwm_loop_set(config->pwm, 0);
+    nrf_pwm_shorts_set(config->pwm, 0);                                         // last value repeats after SEQEND0
+    nrf_pwm_enable(config->pwm);
+    nrf_pwm_task_trigger(config->pwm, NRF_PWM_TASK_SEQSTART0);
+    data->running = true;
+}
+
+
+/**
+ * @brief Stop sequence playback, sleeps until the PWM period in progress ends (lock held)
+ *
+ * A count limited flash stops itself (LOOPSDONE_STOP short), its STOPPED event is still set. The
+ * STOP task takes effect at the end of the period (up to 32.767ms), the caller sleeps instead of
+ * polling the event.
+ *
+ * @param data Indicator instance
+ */
+static void rgbpwm_stop(struct rgbpwm_data *data)
+{
+    NRF_PWM_Type *pwm = data->config->pwm;
+
+    nrf_pwm_shorts_set(pwm, 0);
+    if (!data->running)
+    {
+        return;
+    }
+    if (!nrf_pwm_event_check(pwm, NRF_PWM_EVENT_STOPPED))
+    {
+        nrf_pwm_task_trigger(pwm, NRF_PWM_TASK_STOP);
+        k_sleep(K_USEC(data->config->top));                                     // COUNTERTOP is the period in 1MHz clocks
+        while (!nrf_pwm_event_check(pwm, NRF_PWM_EVENT_STOPPED))
+        {
+            k_sleep(K_TICKS(1));
+        }
+    }
+    nrf_pwm_event_clear(pwm, NRF_PWM_EVENT_STOPPED);
+    data->running = false;
+}
+#endif
+
+
+/* Devicetree instantiation
+ * --------------------------------------------------------------------------------------------- */
+
+static int rgbpwm_init(const struct device *dev)
+{
+    const struct rgbpwm_config *config = dev->config;
+    struct rgbpwm_data *data = dev->data;
+
+#if !defined(CONFIG_RGBINDICATOR_PWM_NRF)
+    for (size_t i = 0; i < ARRAY_SIZE(config->outputs); i++)
+    {
+        if (!pwm_is_ready_dt(&(config->outputs[i])))
+        {
+            LOG_ERR("PWM %s is not ready", config->outputs[i].dev->name);
+            return -ENODEV;
+        }
+    }
+#endif
+    data->config = config;
+    k_mutex_init(&(data->lock));
+    return rgbi_initIndicator(&(data->dev.rgbi), &rgbpwm_backend, &(config->chip), config->id, dev);
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_PWM_NRF)
+#define RGBPWM_CTLR(inst) DT_INST_PWMS_CTLR_BY_IDX(inst, 0)
+
+#define RGBPWM_OUTPUT_CHECK(inst, idx)                                                              \
+    BUILD_ASSERT(DT_SAME_NODE(DT_INST_PWMS_CTLR_BY_IDX(inst, idx), RGBPWM_CTLR(inst)),              \
+                 "PWM indicator outputs must use one nRF PWM instance");                            \
+    BUILD_ASSERT(DT_INST_PWMS_PERIOD_BY_IDX(inst, idx) == DT_INST_PWMS_PERIOD_BY_IDX(inst, 0),      \
+                 "PWM indicator outputs must share one period");
+
+#define RGBPWM_INVERTED(inst, idx) \
+    (((DT_INST_PWMS_FLAGS_BY_IDX(inst, idx) & PWM_POLARITY_INVERTED) != 0) << (idx))
+
+#define RGBPWM_HW_DEFINE(inst)                                                                      \
+    RGBPWM_OUTPUT_CHECK(inst, 1)                                                                    \
+    RGBPWM_OUTPUT_CHECK(inst, 2)                                                                    \
+    BUILD_ASSERT(IN_RANGE(DT_INST_PWMS_PERIOD_BY_IDX(inst, 0) / NSEC_PER_USEC, 3, 32767),           \
+                 "PWM indicator period must be 3us to 32.767ms");                                   \
+    PINCTRL_DT_DEFINE(RGBPWM_CTLR(inst));
+
+#define RGBPWM_HW_CONFIG(inst)                                                                      \
+        .pwm = (NRF_PWM_Type *)DT_REG_ADDR(RGBPWM_CTLR(inst)),                                      \
+        .pcfg = PINCTRL_DT_DEV_CONFIG_GET(RGBPWM_CTLR(inst)),                                       \
+        .top = DT_INST_PWMS_PERIOD_BY_IDX(inst, 0) / NSEC_PER_USEC,                                 \
+        .channel = { DT_INST_PWMS_CHANNEL_BY_IDX(inst, 0), DT_INST_PWMS_CHANNEL_BY_IDX(inst, 1),    \
+                     DT_INST_PWMS_CHANNEL_BY_IDX(inst, 2) },                                        \
+        .inverted = RGBPWM_INVERTED(inst, 0) | RGBPWM_INVERTED(inst, 1) | RGBPWM_INVERTED(inst, 2),
+#else
+#define RGBPWM_HW_DEFINE(inst)
+
+#define RGBPWM_HW_CONFIG(inst)                                                                      \
+        .outputs = { PWM_DT_SPEC_INST_GET_BY_IDX(inst, 0), PWM_DT_SPEC_INST_GET_BY_IDX(inst, 1),    \
+                     PWM_DT_SPEC_INST_GET_BY_IDX(inst, 2) },
+#endif
+
+
+#define RGBPWM_DEFINE(inst)                                                                         \
+    BUILD_ASSERT(DT_INST_PROP_LEN(inst, pwms) == 3, "pwms needs 3 entries");                        \
+    BUILD_ASSERT(DT_INST_PROP_LEN(inst, channel_map) == 3, "channel-map needs 3 entries");          \
+    BUILD_ASSERT(DT_INST_PROP_LEN(inst, dot_current) == 3, "dot-current needs 3 entries");          \
+    BUILD_ASSERT(DT_INST_PROP_LEN(inst, color_scale) == 3, "color-scale needs 3 entries");          \
+    RGBPWM_HW_DEFINE(inst)                                                                          \
+                                                                                                    \
+    static const struct rgbpwm_config rgbpwm_config_##inst =                                        \
+    {                                                                                               \
+        .chip =                                                                                     \
+        {                                                                                           \
+            .channelMap = DT_INST_PROP(inst, channel_map),                                          \
+            .dotCurrent = DT_INST_PROP(inst, dot_current),                                          \
+            .colorScale = DT_INST_PROP(inst, color_scale),                                          \
+        },                                                                                          \
+        .id = RGBPWM_ID_BASE + (inst),                                                              \
+        RGBPWM_HW_CONFIG(inst)                                                                      \
+    };                                                                                              \
+                                                                                                    \
+    static struct rgbpwm_data rgbpwm_data_##inst;                                                   \
+                                                                                                    \
+    DEVICE_DT_INST_DEFINE(inst, rgbpwm_init, NULL, &rgbpwm_data_##inst, &rgbpwm_config_##inst,      \
+                          POST_KERNEL, CONFIG_RGBINDICATOR_INIT_PRIORITY, &rgbi_ledApi);
+
+DT_INST_FOREACH_STATUS_OKAY(RGBPWM_DEFINE)
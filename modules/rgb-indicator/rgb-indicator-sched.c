@@ -0,0 +1,260 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Shared expiry scheduler: one kernel timer and one work item serve the flash edges and slot
+ * expiries of every indicator. Pending expiries are kept in a list sorted by due time, the kernel
+ * timer is armed for the head only. On expiry the work handler fires every node due within the
+ * coalescing window, so edges of indicators flashing in step cost one wakeup.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/sys_clock.h>
+
+#include "rgb-indicator-priv.h"
+#include "trace-pins.h"                                                         // rgbi_timer marker
+
+#define SCHED_COALESCE_TICKS k_ms_to_ticks_ceil64(CONFIG_RGBINDICATOR_SCHED_COALESCE_MS)
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static void schedInsert(rgbi_timer_t *timer);                                   // sorted insert, sched_lock held
+static void schedRearm(void);                                                   // kernel timer to list head, sched_lock held
+static void sched_expiry(struct k_timer *timer);                                // ISR for kernel timer expiry
+static void sched_handler(struct k_work *work);                                 // fires due nodes
+
+static struct k_spinlock sched_lock;                                            // guards sched_list, taken from any context
+static sys_dlist_t sched_list = SYS_DLIST_STATIC_INIT(&sched_list);             // armed nodes, earliest due first
+static K_TIMER_DEFINE(sched_timer, sched_expiry, NULL);
+static K_WORK_DEFINE(sched_work, sched_handler);
+#if defined(CONFIG_RGBINDICATOR_STATS)
+static rgbi_schedStats_t sched_stats;
+static uint32_t sched_wakeCycles;                                               // cycle count at last kernel timer expiry
+#endif
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+/**
+ * @brief Get a snapshot of the expiry scheduler counters
+ *
+ * @param stats Returns counters since boot or last reset
+ */
+void rgbi_getSchedStats(rgbi_schedStats_t *stats)
+{
+    unsigned int key = irq_lock();                                  // wakeups counted in the timer ISR
+
+    *stats = sched_stats;
+    irq_unlock(key);
+}
+
+
+/**
+ * @brief Clear the expiry scheduler counters
+ */
+void rgbi_resetSchedStats(void)
+{
+    unsigned int key = irq_lock();
+
+    memset(&sched_stats, 0, sizeof(sched_stats));
+    irq_unlock(key);
+}
+#endif
+
+
+/**
+ * @brief Prepare a scheduler node, not armed
+ */
+void rgbi_schedInit(rgbi_timer_t *timer, void (*handler)(rgbi_timer_t *timer))
+{
+    sys_dnode_init(&(timer->node));
+    timer->handler = handler;
+}
+
+
+/**
+ * @brief Arm (or re-arm) a node, callable from any context
+ */
+int rgbi_schedArm(rgbi_timer_t *timer, k_timeout_t delay)
+{
+    k_spinlock_key_t key;
+
+    if (K_TIMEOUT_EQ(delay, K_FOREVER))
+    {
+        rgbi_schedCancel(timer);                                    // never expires
+        return 0;
+    }
+    if (delay.ticks < 0)
+    {
+        return -EINVAL;                                             // absolute timeout (K_TIMEOUT_ABS_*)
+    }
+
+    key = k_spin_lock(&sched_lock);
+    if (sys_dnode_is_linked(&(timer->node)))
+    {
+        sys_dlist_remove(&(timer->node));                          // from the list or a firing batch
+    }
+    timer->due = k_uptime_ticks() + delay.ticks;
+    schedInsert(timer);
+    if (sys_dlist_peek_head(&sched_list) == &(timer->node))        // new earliest expiry
+    {
+        schedRearm();
+    }
+    k_spin_unlock(&sched_lock, key);
+    return 0;
+}
+
+
+/**
+ * @brief Disarm a node, callable from any context
+ */
+void rgbi_schedCancel(rgbi_timer_t *timer)
+{
+    k_spinlock_key_t key = k_spin_lock(&sched_lock);
+
+    if (sys_dnode_is_linked(&(timer->node)))
+    {
+        bool wasHead = sys_dlist_peek_head(&sched_list) == &(timer->node);
+
+        sys_dlist_remove(&(timer->node));
+        if (wasHead)
+        {
+            schedRearm();
+        }
+    }
+    k_spin_unlock(&sched_lock, key);
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+/**
+ * @brief Cycle count at the last scheduler wakeup, for timer to handler latency
+ */
+uint32_t rgbi_schedWakeCycles(void)
+{
+    return sched_wakeCycles;
+}
+#endif
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Insert a node in due order, after nodes with the same due time (sched_lock held)
+ *
+ * New expiries are usually the latest, the search starts at the tail.
+ *
+ * @param timer Node to insert, not linked
+ */
+static void schedInsert(rgbi_timer_t *timer)
+{
+    sys_dnode_t *prev = sys_dlist_peek_tail(&sched_list);
+    sys_dnode_t *next = NULL;                                           // first node due after timer
+
+    while (prev != NULL && CONTAINER_OF(prev, rgbi_timer_t, node)->due > timer->due)
+    {
+        next = prev;
+        prev = sys_dlist_peek_prev(&sched_list, prev);
+    }
+    if (next == NULL)
+    {
+        sys_dlist_append(&sched_list, &(timer->node));
+    }
+    else
+    {
+        sys_dlist_insert(next, &(timer->node));
+    }
+}
+
+
+/**
+ * @brief Arm the kernel timer for the earliest node, stop it if none (sched_lock held)
+ */
+static void schedRearm(void)
+{
+    sys_dnode_t *head = sys_dlist_peek_head(&sched_list);
+
+    if (head == NULL)
+    {
+        k_timer_stop(&sched_timer);
+        return;
+    }
+    int64_t remain = CONTAINER_OF(head, rgbi_timer_t, node)->due - k_uptime_ticks();
+
+    k_timer_start(&sched_timer, K_TICKS(MAX(remain, 0)), K_NO_WAIT);
+}
+
+
+/**
+ * @brief ISR for the kernel timer, hands the due nodes to the work handler
+ *
+ * @param timer Scheduler kernel timer
+ */
+static void sched_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    TPIN_ON(rgbi_timer);
+#if defined(CONFIG_RGBINDICATOR_STATS)
+    sched_wakeCycles = k_cycle_get_32();
+    sched_stats.wakeups++;
+#endif
+    rgbi_submitWork(&sched_work);
+    TPIN_OFF(rgbi_timer);
+}
+
+
+/**
+ * @brief Fire every node due within the coalescing window, then re-arm for the next
+ *
+ * The due nodes are moved to a batch first, nodes armed by a handler during the pass go to the
+ * list and wait for their own wakeup. Nodes are taken from the batch one at a time with the lock
+ * released around the handler, a handler may arm or cancel any node (including its own), which
+ * takes it out of the batch.
+ *
+ * @param work Scheduler work item
+ */
+static void sched_handler(struct k_work *work)
+{
+    int64_t now = k_uptime_ticks();
+    int64_t horizon = now + SCHED_COALESCE_TICKS;                  // edges this close ride along with this wakeup
+    sys_dlist_t batch;
+    sys_dnode_t *head;
+    k_spinlock_key_t key;
+
+    ARG_UNUSED(work);
+
+    sys_dlist_init(&batch);
+    key = k_spin_lock(&sched_lock);
+    while ((head = sys_dlist_peek_head(&sched_list)) != NULL && CONTAINER_OF(head, rgbi_timer_t, node)->due <= horizon)
+    {
+        sys_dlist_remove(head);
+        sys_dlist_append(&batch, head);
+    }
+
+    while ((head = sys_dlist_get(&batch)) != NULL)
+    {
+        rgbi_timer_t *timer = CONTAINER_OF(head, rgbi_timer_t, node);
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+        sched_stats.edges++;
+        if (timer->due > now)
+        {
+            sched_stats.coalesced++;
+        }
+#endif
+        k_spin_unlock(&sched_lock, key);
+        timer->handler(timer);
+        key = k_spin_lock(&sched_lock);
+    }
+    schedRearm();
+    k_spin_unlock(&sched_lock, key);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys_clock.h>
+
+#include "rgb-indicator-priv.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(rgb_indicator);
+
+#define SEQ_FRAME_MS CONFIG_RGBINDICATOR_SEQUENCER_FRAME_MS
+#define SEQ_STEP_LIMIT 64                                                       // zero-time steps per run, guards against empty forever loops
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static void seqEmit(rgbi_seqCursor_t *cursor, rgb_indicator_t *rgbi, const uint8_t color[3]);
+static uint32_t seqFade(rgbi_seqCursor_t *cursor, rgb_indicator_t *rgbi, const rgbi_step_t *step);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Start playing a keyframe pattern, replaces any flash or pattern underway
+ *
+ * @param rgbi The RGB indicator to actuate
+ * @param pattern Pattern step table (see RGBI_PATTERN_DEFINE)
+ * @return int 0=success
+ */
+int rgbi_play(rgb_indicator_t *rgbi, const rgbi_step_t *pattern)
+{
+    rgbi_cmd_t cmd = { .op = RGBI_CMD_PLAY, .pattern = pattern };
+
+    if (pattern == NULL)
+    {
+        return -EINVAL;
+    }
+    rgbi_post(rgbi, &cmd);
+    return 0;
+}
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Module internal
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Reset the cursor to the start of a pattern and run it
+ *
+ * @param rgbi The RGB indicator
+ * @param pattern Pattern step table
+ */
+void rgbi_seqStart(rgb_indicator_t *rgbi, const rgbi_step_t *pattern)
+{
+    rgbi_seqCursor_t *cursor = &(rgbi->seq);
+
+    rgbi_schedCancel(&(rgbi->flashTimer));
+    rgbi_stopEngine(rgbi);
+    rgbi->onDuration = K_NO_WAIT;                                       // not a flash sequence
+
+    cursor->pc = 0;
+    cursor->depth = 0;
+    cursor->elapsed = 0;
+    cursor->outValid = false;                                           // first color always written
+    cursor->pattern = pattern;
+
+    rgbi_seqRun(rgbi);
+}
+
+
+/**
+ * @brief Run the pattern until the next timed step and arm the flash timer for it
+ *
+ * @param rgbi The RGB indicator
+ */
+void rgbi_seqRun(rgb_indicator_t *rgbi)
+{
+    rgbi_seqCursor_t *cursor = &(rgbi->seq);
+    uint32_t delayMs = 0;
+
+    for (size_t guard = 0; guard < SEQ_STEP_LIMIT && cursor->pattern != NULL && delayMs == 0; guard++)
+    {
+        const rgbi_step_t *step = &(cursor->pattern[cursor->pc]);
+        const uint8_t color[3] = { step->r, step->g, step->b };
+
+        switch (step->op)
+        {
+            case RGBI_OP_SET:
+                seqEmit(cursor, rgbi, color);
+                cursor->pc++;
+                delayMs = step->ms;
+                break;
+
+            case RGBI_OP_FADE:
+                delayMs = seqFade(cursor, rgbi, step);                  // 0 when fade complete, continue with next step
+                break;
+
+            case RGBI_OP_HOLD:
+                cursor->pc++;
+                delayMs = step->ms;
+                break;
+
+            case RGBI_OP_REPEAT:
+                if (cursor->depth >= RGBI_SEQ_DEPTH)
+                {
+                    LOG_ERR("Pattern repeats nested deeper than %d", RGBI_SEQ_DEPTH);
+                    cursor->pattern = NULL;
+                    break;
+                }
+                cursor->pc++;
+                cursor->loopStart[cursor->depth] = cursor->pc;
+                cursor->loopLeft[cursor->depth] = step->r;
+                cursor->depth++;
+                break;
+
+            case RGBI_OP_END_REPEAT:
+                if (cursor->depth == 0)                                 // unmatched, ignore
+                {
+                    cursor->pc++;
+                }
+                else if (cursor->loopLeft[cursor->depth - 1] == 0)      // forever
+                {
+                    cursor->pc = cursor->loopStart[cursor->depth - 1];
+                }
+                else if (--cursor->loopLeft[cursor->depth - 1] > 0)
+                {
+                    cursor->pc = cursor->loopStart[cursor->depth - 1];
+                }
+                else
+                {
+                    cursor->depth--;
+                    cursor->pc++;
+                }
+                break;
+
+            case RGBI_OP_END:
+            default:
+                cursor->pattern = NULL;                                 // done, indicator stays at last color
+                break;
+        }
+    }
+
+    if (cursor->pattern != NULL)
+    {
+        if (delayMs == 0)
+        {
+            LOG_WRN("Pattern has no timed steps, stopped");
+            cursor->pattern = NULL;
+            return;
+        }
+        rgbi_armTimer(rgbi, K_MSEC(delayMs));
+    }
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Output a frame, frames equal to the last output are dropped (no I2C traffic)
+ *
+ * @param cursor Sequencer cursor
+ * @param rgbi The RGB indicator
+ * @param color Frame color r, g, b
+ */
+static void seqEmit(rgbi_seqCursor_t *cursor, rgb_indicator_t *rgbi, const uint8_t color[3])
+{
+    if (cursor->outValid && memcmp(cursor->out, color, sizeof(cursor->out)) == 0)
+    {
+        return;
+    }
+    memcpy(cursor->out, color, sizeof(cursor->out));
+    cursor->outValid = true;
+    rgbi_outputColor(rgbi, color[0], color[1], color[2]);
+}
+
+
+/**
+ * @brief Advance a fade step by one frame
+ *
+ * Color is interpolated in 16-bit fixed point, rounded to the nearest level. The frame interval
+ * is stretched to the time between quantized color steps so slow fades do not wake the CPU for
+ * frames that would not change the output.
+ *
+ * @param cursor Sequencer cursor
+ * @param rgbi The RGB indicator
+ * @param step The fade step
+ * @return uint32_t Time until next frame (ms), 0 if fade is complete
+ */
+static uint32_t seqFade(rgbi_seqCursor_t *cursor, rgb_indicator_t *rgbi, const rgbi_step_t *step)
+{
+    const uint8_t target[3] = { step->r, step->g, step->b };
+    uint8_t frame[3];
+    uint32_t frac;
+    uint32_t interval;
+    uint16_t maxDelta = 0;
+
+    if (cursor->elapsed == 0)                                           // first frame of fade, capture start color
+    {
+        if (cursor->outValid)
+        {
+            memcpy(cursor->from, cursor->out, sizeof(cursor->from));
+        }
+        else
+        {
+            memset(cursor->from, 0, sizeof(cursor->from));
+        }
+    }
+
+    if (cursor->elapsed >= step->ms)
+    {
+        seqEmit(cursor, rgbi, target);
+        cursor->elapsed = 0;
+        cursor->pc++;
+        return 0;
+    }
+
+    frac = ((uint32_t)cursor->elapsed << 16) / step->ms;                // Q16 progress through the fade
+    for (size_t i = 0; i < 3; i++)
+    {
+        int32_t delta = (int32_t)target[i] - (int32_t)cursor->from[i];
+
+        frame[i] = cursor->from[i] + (int32_t)((delta * (int32_t)frac + (1 << 15)) >> 16);    // rounded to nearest
+        maxDelta = MAX(maxDelta, (uint16_t)abs(delta));
+    }
+    seqEmit(cursor, rgbi, frame);
+
+    interval = (maxDelta > 0) ? MAX(SEQ_FRAME_MS, step->ms / maxDelta) : step->ms;
+    interval = MIN(interval, (uint32_t)(step->ms - cursor->elapsed));
+    cursor->elapsed += interval;
+    return interval;
+}
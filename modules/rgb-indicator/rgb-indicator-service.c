@@ -0,0 +1,270 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "rgb-indicator-priv.h"
+#include "rgb-indicator-service.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(rgb_indicator);
+
+#define SVC_STATE_NONE -1                                                       // lastState: nothing applied yet
+
+ZBUS_SUBSCRIBER_DEFINE(rgbi_svcSub, CONFIG_RGBINDICATOR_SERVICE_QUEUE_SIZE);    // notifications only, messages stay in the channels
+K_THREAD_STACK_DEFINE(rgbi_svcStack, CONFIG_RGBINDICATOR_SERVICE_STACK_SIZE);
+
+static struct
+{
+    rgb_indicator_t *rgbi;
+    const rgbi_svcBinding_t *bindings;
+    size_t count;
+    rgbi_slot_t slots[CONFIG_RGBINDICATOR_SERVICE_BINDINGS];                    // one arbitration slot per binding
+    int16_t lastState[CONFIG_RGBINDICATOR_SERVICE_BINDINGS];                    // state displayed per binding, service thread only
+    struct k_spinlock lock;                                                     // guards stats
+    rgbi_svcStats_t stats;
+    struct k_thread thread;
+} rgbi_svc;
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static void svc_run(void *p1, void *p2, void *p3);                              // service thread
+static int bindingIndex(const struct zbus_channel *chan);
+static void applyFrame(uint32_t dirty);
+static void applyState(size_t idx, uint8_t state);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Start the service on an indicator
+ *
+ * @param rgbi The RGB indicator the service drives
+ * @param bindings Channel bindings (const, must remain valid)
+ * @param count Number of bindings
+ * @return int 0=started
+ */
+int rgbi_svcStart(rgb_indicator_t *rgbi, const rgbi_svcBinding_t *bindings, size_t count)
+{
+    int ret;
+
+    if (rgbi_svc.rgbi != NULL)
+    {
+        return -EALREADY;
+    }
+    if (count == 0 || count > CONFIG_RGBINDICATOR_SERVICE_BINDINGS)
+    {
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (zbus_chan_msg_size(bindings[i].chan) < sizeof(uint8_t))
+        {
+            return -EINVAL;
+        }
+        ret = rgbi_slotInit(rgbi, &rgbi_svc.slots[i], bindings[i].priority);
+        if (ret == 0)
+        {
+            ret = zbus_chan_add_obs(bindings[i].chan, &rgbi_svcSub, K_MSEC(100));
+        }
+        if (ret != 0)
+        {
+            LOG_ERR("Indicator service binding %d failed, err=%d", i, ret);
+            return ret;
+        }
+        rgbi_svc.lastState[i] = SVC_STATE_NONE;
+    }
+
+    rgbi_svc.rgbi = rgbi;
+    rgbi_svc.bindings = bindings;
+    rgbi_svc.count = count;
+    rgbi_svcResetStats();
+
+    k_thread_create(&rgbi_svc.thread, rgbi_svcStack, K_THREAD_STACK_SIZEOF(rgbi_svcStack), svc_run,
+                    NULL, NULL, NULL, CONFIG_RGBINDICATOR_SERVICE_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&rgbi_svc.thread, "rgbi_svc");
+    return 0;
+}
+
+
+/**
+ * @brief Get a snapshot of the service counters
+ *
+ * @param stats Returns counters
+ */
+void rgbi_svcGetStats(rgbi_svcStats_t *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&rgbi_svc.lock);
+
+    *stats = rgbi_svc.stats;
+    k_spin_unlock(&rgbi_svc.lock, key);
+}
+
+
+/**
+ * @brief Clear the service counters
+ */
+void rgbi_svcResetStats(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&rgbi_svc.lock);
+
+    memset(&rgbi_svc.stats, 0, sizeof(rgbi_svc.stats));
+    k_spin_unlock(&rgbi_svc.lock, key);
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Service thread: collect channel notifications, apply them at most once per frame
+ *
+ * The first change after a quiet frame is applied at once, changes arriving within the frame
+ * that follows are collected (dirty bit per binding) and applied together when it ends.
+ */
+static void svc_run(void *p1, void *p2, void *p3)
+{
+    const struct zbus_channel *chan;
+    k_timepoint_t frameEnd = sys_timepoint_calc(K_NO_WAIT);
+    uint32_t dirty = BIT_MASK(rgbi_svc.count);                                  // show the channels' current state at start
+    int idx;
+
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (1)
+    {
+        if (dirty != 0 && sys_timepoint_expired(frameEnd))
+        {
+            applyFrame(dirty);
+            dirty = 0;
+            frameEnd = sys_timepoint_calc(K_MSEC(CONFIG_RGBINDICATOR_SERVICE_FRAME_MS));
+        }
+
+        if (zbus_sub_wait(&rgbi_svcSub, &chan, (dirty != 0) ? sys_timepoint_timeout(frameEnd) : K_FOREVER) != 0)
+        {
+            continue;                                                           // frame ended
+        }
+        idx = bindingIndex(chan);
+        if (idx < 0)
+        {
+            continue;
+        }
+
+        k_spinlock_key_t key = k_spin_lock(&rgbi_svc.lock);
+        rgbi_svc.stats.notifications++;
+        if (dirty & BIT(idx))
+        {
+            rgbi_svc.stats.coalesced++;
+        }
+        k_spin_unlock(&rgbi_svc.lock, key);
+        dirty |= BIT(idx);
+    }
+}
+
+
+/**
+ * @brief Find the binding of a channel
+ *
+ * @param chan Notifying channel
+ * @return int Binding index, -1=not bound
+ */
+static int bindingIndex(const struct zbus_channel *chan)
+{
+    for (size_t i = 0; i < rgbi_svc.count; i++)
+    {
+        if (rgbi_svc.bindings[i].chan == chan)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/**
+ * @brief Read the latest state of each changed channel (in place) and update its slot
+ *
+ * @param dirty Bit per binding with a change
+ */
+static void applyFrame(uint32_t dirty)
+{
+    const struct zbus_channel *chan;
+    uint8_t state;
+
+    while (dirty != 0)
+    {
+        size_t idx = find_lsb_set(dirty) - 1;
+
+        dirty &= ~BIT(idx);
+        chan = rgbi_svc.bindings[idx].chan;
+        if (zbus_chan_claim(chan, K_MSEC(CONFIG_RGBINDICATOR_SERVICE_FRAME_MS)) != 0)
+        {
+            LOG_WRN("Indicator service could not read %s", zbus_chan_name(chan));
+            continue;
+        }
+        state = *(const uint8_t *)zbus_chan_const_msg(chan);
+        (void)zbus_chan_finish(chan);
+
+        applyState(idx, state);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&rgbi_svc.lock);
+    rgbi_svc.stats.frames++;
+    k_spin_unlock(&rgbi_svc.lock, key);
+}
+
+
+/**
+ * @brief Display a binding's state through its arbitration slot
+ *
+ * @param idx Binding index
+ * @param state Channel state value
+ */
+static void applyState(size_t idx, uint8_t state)
+{
+    const rgbi_svcBinding_t *binding = &rgbi_svc.bindings[idx];
+    const rgbi_svcState_t *display = (state < binding->stateCount) ? &binding->states[state] : NULL;
+    rgbi_slot_t *slot = &rgbi_svc.slots[idx];
+
+    if (rgbi_svc.lastState[idx] == state)
+    {
+        return;                                                                 // republished unchanged, keep a running flash in phase
+    }
+    rgbi_svc.lastState[idx] = state;
+
+    switch ((display != NULL) ? display->op : RGBI_CMD_CANCEL)
+    {
+        case RGBI_CMD_SET:
+            rgbi_slotColor(slot, &display->pixels, K_FOREVER);
+            break;
+
+        case RGBI_CMD_FLASH:
+            rgbi_slotFlash(slot, &display->pixels, K_MSEC(display->onMs), K_MSEC(display->offMs), display->count, K_FOREVER);
+            break;
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+        case RGBI_CMD_PLAY:
+            if (rgbi_slotPlay(slot, display->pattern, K_FOREVER) != 0)
+            {
+                LOG_WRN("Indicator service pattern rejected, %s state %d", zbus_chan_name(binding->chan), state);
+            }
+            break;
+#endif
+
+        default:
+            rgbi_slotRelease(slot);
+            break;
+    }
+}
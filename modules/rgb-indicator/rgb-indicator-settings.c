@@ -0,0 +1,246 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/settings/settings.h>
+
+#include "rgb-indicator-priv.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(rgb_indicator);
+
+/* Indicator settings
+ *
+ * Calibration and user brightness are kept in one record per indicator, key "rgbi/<scope>/<id>/cal".
+ * id is the LP5817 I2C address, scoped by the I2C bus device, or 0x80 + instance for PWM indicators,
+ * scoped by the indicator device (e.g. rgbi/i2c@9000/2d/cal, rgbi/rgb-indicator/80/cal). The
+ * record is read once during chip configuration. Runtime changes only
+ * update the RAM copy and mark it dirty, a delayed work item writes the record back
+ * CONFIG_RGBINDICATOR_SETTINGS_WRITEBACK_MS after the first unsaved change. Changes made while the
+ * write is pending are carried by it, so the flash is written at most once per interval no matter
+ * how often brightness is adjusted.
+ */
+
+#define RGBI_SETTINGS_VERSION 1
+#define RGBI_SETTINGS_ROOT "rgbi"
+#define RGBI_SETTINGS_LEAF "cal"
+#define RGBI_SETTINGS_KEY_SIZE (SETTINGS_MAX_NAME_LEN + 1)
+
+typedef struct _rgbi_settingsRec                                                // stored record, all uint8_t (no padding)
+{
+    uint8_t version;
+    lp5817_config_t calib;
+    uint8_t brightness;
+} rgbi_settingsRec_t;
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static int settingsSet(const char *key, size_t len, settings_read_cb readCb, void *cbArg, void *param);
+static void settingsSave_handler(struct k_work *work);                         // delayed writeback (system workqueue)
+static int settingsSave(rgb_indicator_t *rgbi);
+static void settingsKey(const rgb_indicator_t *rgbi, char *key, size_t size, bool leaf);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Write unsaved settings now (before a reset or power down)
+ *
+ * @param rgbi The RGB indicator
+ * @return int 0=saved or nothing to save, else settings (flash) error
+ */
+int rgbi_settingsFlush(rgb_indicator_t *rgbi)
+{
+    struct k_work_sync sync;
+
+    k_work_cancel_delayable_sync(&(rgbi->settingsWork), &sync);
+    return settingsSave(rgbi);
+}
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Module internal
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Prepare an indicator's RAM settings from its configuration, nothing is read yet
+ *
+ * @param rgbi The RGB indicator
+ * @param config Default (devicetree or built-in) configuration
+ */
+void rgbi_settingsInit(rgb_indicator_t *rgbi, const lp5817_config_t *config)
+{
+    rgbi->calib = *config;
+    rgbi->config = &(rgbi->calib);                                              // chip code reads the RAM copy from here on
+    atomic_clear(&(rgbi->settingsDirty));
+    k_work_init_delayable(&(rgbi->settingsWork), settingsSave_handler);
+}
+
+
+/**
+ * @brief Replace the defaults with the stored calibration and brightness, if present
+ *
+ * @param rgbi The RGB indicator
+ * @return int 0=loaded or nothing stored, else settings error (defaults are kept)
+ */
+int rgbi_settingsLoad(rgb_indicator_t *rgbi)
+{
+    char key[RGBI_SETTINGS_KEY_SIZE];
+    int ret = settings_subsys_init();
+
+    if (ret != 0)
+    {
+        LOG_ERR("Settings not available, err=%d, using default calibration", ret);
+        return ret;
+    }
+    settingsKey(rgbi, key, sizeof(key), false);
+    ret = settings_load_subtree_direct(key, settingsSet, rgbi);
+    if (ret != 0)
+    {
+        LOG_WRN("Indicator settings %s not loaded, err=%d", key, ret);
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Note a runtime change, the record is written back at the end of the writeback interval
+ *
+ * @param rgbi The RGB indicator
+ */
+void rgbi_settingsChanged(rgb_indicator_t *rgbi)
+{
+    atomic_set(&(rgbi->settingsDirty), 1);
+    k_work_schedule(&(rgbi->settingsWork), K_MSEC(CONFIG_RGBINDICATOR_SETTINGS_WRITEBACK_MS));   // no-op if already pending
+}
+
+
+/**
+ * @brief Check a calibration before it is used, channelMap indexes the output registers
+ *
+ * @param calib Calibration to check
+ * @return true Channel map is a permutation of the outputs 0-2
+ */
+bool rgbi_settingsValid(const lp5817_config_t *calib)
+{
+    uint8_t outputs = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(calib->channelMap); i++)
+    {
+        if (calib->channelMap[i] > 2)
+        {
+            return false;
+        }
+        outputs |= BIT(calib->channelMap[i]);
+    }
+    return outputs == BIT_MASK(3);
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Settings direct load callback, applies a stored record to the RAM settings (tables are
+ * rebuilt by the caller)
+ *
+ * @return int 0=continue loading
+ */
+static int settingsSet(const char *key, size_t len, settings_read_cb readCb, void *cbArg, void *param)
+{
+    rgb_indicator_t *rgbi = param;
+    rgbi_settingsRec_t rec;
+    k_spinlock_key_t lockKey;
+    const char *next;
+
+    if (!settings_name_steq(key, RGBI_SETTINGS_LEAF, &next) || next != NULL)
+    {
+        return 0;                                                               // not ours, keep loading
+    }
+    if (len != sizeof(rec) || readCb(cbArg, &rec, sizeof(rec)) != sizeof(rec) ||
+        rec.version != RGBI_SETTINGS_VERSION || !rgbi_settingsValid(&rec.calib))
+    {
+        LOG_WRN("Stored indicator settings invalid, using default calibration");
+        return 0;
+    }
+
+    lockKey = k_spin_lock(&(rgbi->calibLock));
+    rgbi->calib = rec.calib;
+    rgbi->brightness = rec.brightness;
+    k_spin_unlock(&(rgbi->calibLock), lockKey);
+    LOG_DBG("Indicator settings loaded, brightness=%d", rec.brightness);
+    return 0;
+}
+
+
+/**
+ * @brief Delayed writeback, a failed write is retried after another interval
+ *
+ * @param work Settings work item
+ */
+static void settingsSave_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    rgb_indicator_t *rgbi = CONTAINER_OF(dwork, rgb_indicator_t, settingsWork);
+
+    if (settingsSave(rgbi) != 0)
+    {
+        rgbi_settingsChanged(rgbi);
+    }
+}
+
+
+/**
+ * @brief Write the record if it changed since the last write
+ *
+ * @param rgbi The RGB indicator
+ * @return int 0=saved or clean, else settings error
+ */
+static int settingsSave(rgb_indicator_t *rgbi)
+{
+    char key[RGBI_SETTINGS_KEY_SIZE];
+    rgbi_settingsRec_t rec = { .version = RGBI_SETTINGS_VERSION };
+    k_spinlock_key_t lockKey;
+    int ret;
+
+    if (!atomic_cas(&(rgbi->settingsDirty), 1, 0))                             // cleared first: a change during the write marks it again
+    {
+        return 0;
+    }
+    lockKey = k_spin_lock(&(rgbi->calibLock));                                 // consistent record, setters may run from any thread
+    rec.calib = rgbi->calib;
+    rec.brightness = rgbi->brightness;
+    k_spin_unlock(&(rgbi->calibLock), lockKey);
+
+    settingsKey(rgbi, key, sizeof(key), true);
+    ret = settings_save_one(key, &rec, sizeof(rec));
+    if (ret != 0)
+    {
+        atomic_set(&(rgbi->settingsDirty), 1);
+        LOG_ERR("Indicator settings write failed, err=%d", ret);
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Compose an indicator's settings key from its scope device name and id
+ *
+ * @param rgbi The RGB indicator
+ * @param key Returns the key
+ * @param size Size of key
+ * @param leaf true=record key, false=subtree (load)
+ */
+static void settingsKey(const rgb_indicator_t *rgbi, char *key, size_t size, bool leaf)
+{
+    snprintf(key, size, leaf ? RGBI_SETTINGS_ROOT "/%s/%02x/" RGBI_SETTINGS_LEAF : RGBI_SETTINGS_ROOT "/%s/%02x",
+             rgbi->idScope->name, rgbi->id);
+}
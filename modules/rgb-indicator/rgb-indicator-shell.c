@@ -0,0 +1,221 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/shell/shell.h>
+
+#include "rgb-indicator-priv.h"
+
+/* Shell commands for runtime inspection of the indicator driver
+ *
+ *   rgbi stats <device> [reset]
+ *   rgbi set <device> <red> <green> <blue>
+ *   rgbi flash <device> <red> <green> <blue> <on_ms> <off_ms> [count]
+ *   rgbi off <device>
+ */
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+static const char *const histLabels[RGBI_HIST_BUCKETS] =
+{
+    "<32us", "<64us", "<128us", "<256us", "<512us", "<1ms", "<2ms", "<4ms", "<8ms", ">=8ms"
+};
+#endif
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static rgb_indicator_t *getIndicator(const struct shell *sh, const char *name);
+static int parseValues(const struct shell *sh, char **argv, size_t count, uint32_t *values, uint32_t max);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Commands
+ * --------------------------------------------------------------------------------------------- */
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+static void printHistogram(const struct shell *sh, const char *title, const uint32_t hist[RGBI_HIST_BUCKETS], uint32_t maxUs)
+{
+    shell_print(sh, "%s (max %u us)", title, maxUs);
+    for (size_t i = 0; i < RGBI_HIST_BUCKETS; i++)
+    {
+        if (hist[i] > 0)
+        {
+            shell_print(sh, "  %-7s %u", histLabels[i], hist[i]);
+        }
+    }
+}
+#endif
+
+
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    rgb_indicator_t *rgbi = getIndicator(sh, argv[1]);
+
+    if (rgbi == NULL)
+    {
+        return -ENODEV;
+    }
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+    rgbi_stats_t stats;
+    rgbi_schedStats_t schedStats;
+
+    if (argc > 2)
+    {
+        if (strcmp(argv[2], "reset") != 0)
+        {
+            shell_error(sh, "Unknown option: %s", argv[2]);
+            return -EINVAL;
+        }
+        rgbi_resetStats(rgbi);
+        rgbi_resetSchedStats();
+        shell_print(sh, "Counters cleared");
+        return 0;
+    }
+
+    rgbi_getStats(rgbi, &stats);
+    rgbi_getSchedStats(&schedStats);
+    shell_print(sh, "I2C: xfers %u, bytes %u, naks %u, retries %u",
+                stats.i2cXfers, stats.i2cBytes, stats.i2cNaks, stats.i2cRetries);
+    shell_print(sh, "Scheduler (all indicators): wakeups %u, edges %u, coalesced %u",
+                schedStats.wakeups, schedStats.edges, schedStats.coalesced);
+    printHistogram(sh, "Timer to handler latency", stats.wakeLatency, stats.wakeLatencyMaxUs);
+    printHistogram(sh, "Handler execution time", stats.handlerTime, stats.handlerTimeMaxUs);
+    return 0;
+#else
+    ARG_UNUSED(argc);
+    shell_error(sh, "Counters not enabled (CONFIG_RGBINDICATOR_STATS)");
+    return -ENOTSUP;
+#endif
+}
+
+
+static int cmd_set(const struct shell *sh, size_t argc, char **argv)
+{
+    rgb_indicator_t *rgbi = getIndicator(sh, argv[1]);
+    uint32_t rgb[3];
+    int ret;
+
+    ARG_UNUSED(argc);
+    if (rgbi == NULL)
+    {
+        return -ENODEV;
+    }
+    if (parseValues(sh, &argv[2], 3, rgb, UINT8_MAX) != 0)
+    {
+        return -EINVAL;
+    }
+
+    ret = rgbi_setColorFromPixels(rgbi, rgb[0], rgb[1], rgb[2]);
+    if (ret != 0)
+    {
+        shell_error(sh, "Set color failed, err=%d", ret);
+    }
+    return ret;
+}
+
+
+static int cmd_flash(const struct shell *sh, size_t argc, char **argv)
+{
+    rgb_indicator_t *rgbi = getIndicator(sh, argv[1]);
+    uint32_t vals[6] = { 0 };                                           // r, g, b, on, off, count
+    struct led_rgb pixels;
+
+    if (rgbi == NULL)
+    {
+        return -ENODEV;
+    }
+    if (parseValues(sh, &argv[2], 3, vals, UINT8_MAX) != 0 ||
+        parseValues(sh, &argv[5], 2, &vals[3], UINT16_MAX) != 0 ||
+        (argc > 7 && parseValues(sh, &argv[7], 1, &vals[5], UINT8_MAX) != 0))
+    {
+        return -EINVAL;
+    }
+
+    pixels.r = vals[0];
+    pixels.g = vals[1];
+    pixels.b = vals[2];
+    rgbi_flash(rgbi, &pixels, K_MSEC(vals[3]), K_MSEC(vals[4]), vals[5]);
+    return 0;
+}
+
+
+static int cmd_off(const struct shell *sh, size_t argc, char **argv)
+{
+    rgb_indicator_t *rgbi = getIndicator(sh, argv[1]);
+
+    ARG_UNUSED(argc);
+    if (rgbi == NULL)
+    {
+        return -ENODEV;
+    }
+    rgbi_cancel(rgbi);
+    return 0;
+}
+
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_rgbi,
+    SHELL_CMD_ARG(stats, NULL, "Show or reset counters: stats <device> [reset]", cmd_stats, 2, 1),
+    SHELL_CMD_ARG(set, NULL, "Set color: set <device> <red> <green> <blue>", cmd_set, 5, 0),
+    SHELL_CMD_ARG(flash, NULL, "Flash: flash <device> <red> <green> <blue> <on_ms> <off_ms> [count, 0=continuous]", cmd_flash, 7, 1),
+    SHELL_CMD_ARG(off, NULL, "Cancel flash/pattern and turn off: off <device>", cmd_off, 2, 0),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(rgbi, &sub_rgbi, "RGB indicator commands", NULL);
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Look up an indicator device by name
+ *
+ * @param sh Shell for error output
+ * @param name Device name
+ * @return rgb_indicator_t* Indicator, NULL if not an indicator device
+ */
+static rgb_indicator_t *getIndicator(const struct shell *sh, const char *name)
+{
+    const struct device *dev = device_get_binding(name);
+
+    if (!rgbi_isIndicatorDevice(dev) || !device_is_ready(dev))
+    {
+        shell_error(sh, "%s is not a ready RGB indicator device", name);
+        return NULL;
+    }
+    return rgbi_fromDevice(dev);
+}
+
+
+/**
+ * @brief Parse decimal arguments
+ *
+ * @param sh Shell for error output
+ * @param argv Arguments to parse
+ * @param count Number of arguments
+ * @param values Returns parsed values
+ * @param max Largest accepted value
+ * @return int 0=success
+ */
+static int parseValues(const struct shell *sh, char **argv, size_t count, uint32_t *values, uint32_t max)
+{
+    int err = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = shell_strtoul(argv[i], 10, &err);
+        if (err != 0 || values[i] > max)
+        {
+            shell_error(sh, "Invalid value %s (0-%u)", argv[i], max);
+            return -EINVAL;
+        }
+    }
+    return 0;
+}
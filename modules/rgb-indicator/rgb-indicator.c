@@ -5,22 +5,86 @@
  */
 
 #include <zephyr/kernel.h>
-#include <zephyr/drivers/i2c.h>
+#include <zephyr/init.h>
 #include <zephyr/sys_clock.h>
 
-#include "include/rgb-indicator.h"
+#include "rgb-indicator-priv.h"
+#include "trace-pins.h"                                                         // rgbi_handler, rgbi_write markers
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(rgb_indicator);
 
-const uint8_t dot_current[] = { 128, 128, 128 };                                // relative brightness of each RGB channel
+#if defined(CONFIG_RGBINDICATOR_GAMMA)
+static const uint8_t rgbi_gamma[256] =                                          // round(255 * (i / 255)^2.2), perceptual to PWM
+{
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+#endif
+
+#if defined(CONFIG_RGBINDICATOR_WORKQUEUE)
+K_THREAD_STACK_DEFINE(rgbi_workqStack, CONFIG_RGBINDICATOR_WORKQUEUE_STACK_SIZE);
+static struct k_work_q rgbi_workq;                                              // indicator owned workqueue, keeps I2C off system WQ
+#endif
+
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT)
+#define RGBI_EVT_INIT_DONE BIT(0)                                               // initEvent: chip configuration attempted
+#endif
+
+struct cmdWait                                                                  // blocking color caller waiting on the work handler
+{
+    struct k_sem done;
+    int result;
+};
 
 /* Private service function declarations
  * -------------------------------------------------------------------------------------------- */
-static int lp5817_init(const struct i2c_dt_spec *rgb_ctrllr);
-static void lp5817_setColor(const struct i2c_dt_spec *rgb_ctrllr, uint8_t red, uint8_t green, uint8_t blue);
-static void flashTimerExpiry(struct k_timer *flashTimer);                       // ISR for timer expiry
-static void flashDisplay_handler(struct k_work *work);                          // workqueue handler for flash actions
+static int configure(rgb_indicator_t *rgbi);                                    // settings, color scale, backend hardware
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT)
+static void init_handler(struct k_work *work);                                  // background chip configuration
+#endif
+static int awaitInit(rgb_indicator_t *rgbi);                                    // hold direct chip access until configured
+static inline bool isOnWorkq(void);                                             // caller is the indicator workqueue thread
+static inline void mapColor(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue, uint8_t outputs[3]);
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+static void setScale(rgb_indicator_t *rgbi, const uint8_t scale[3]);           // calibration applied after gamma
+static inline uint8_t correctLevel(uint8_t value, uint8_t scale);               // gamma table, then calibration scale
+#endif
+static int writeColor(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue);   // blocking backend write
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+static int writeColorAsync(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue, rgbi_callback_t callback, void *userData);
+#endif
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+static int flashHw(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd);               // sequence run by the backend hardware
+#endif
+static int setColorSync(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue);  // SET through the work handler
+static int applyCurrents(rgb_indicator_t *rgbi);                                // currents written by the work handler
+static void postCmd(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, rgbi_callback_t callback, void *userData, bool async);
+static void cmdComplete(rgb_indicator_t *rgbi, int result, void *userData);     // wakes setColorSync()
+static int cmdApply(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, bool sync);   // start/stop posted sequence
+static void flashStart(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd);
+static void flashStop(rgb_indicator_t *rgbi);
+static void flashExpiry(rgbi_timer_t *timer);                                   // scheduler expiry (work handler context)
+static void flashDisplay_handler(struct k_work *work);                          // workqueue handler for posted commands
+static void flashService(rgb_indicator_t *rgbi, atomic_val_t expiredGen);       // apply commands, advance sequence
+static void flashDisplay_update(rgb_indicator_t *rgbi);                         // advance flash/pattern state
+#if defined(CONFIG_RGBINDICATOR_STATS)
+static void statsRecord(uint32_t hist[RGBI_HIST_BUCKETS], uint32_t *maxUs, uint32_t cycles);
+#endif
 static inline bool isFlashing(rgb_indicator_t * indicator);                     // quick check for active flash session
 
 
@@ -29,27 +93,92 @@ static inline bool isFlashing(rgb_indicator_t * indicator);
  * --------------------------------------------------------------------------------------------- */
 
 /**
- * @brief Initialize RGB indicator device and driver
+ * @brief Initialize the indicator front end, called by a backend once its own state is set up
  * 
- * @param rgb_dev TI LP5817 RGB controller device 
  * @param rgbi RGB indicator struct holding display parameters
+ * @param backend Output driver operations
+ * @param config Channel map and currents
+ * @param id Indicator identity for settings and logs (LP5817 I2C address, PWM 0x80 + instance)
+ * @param idScope Device id is unique on (LP5817 I2C bus, PWM indicator device)
  * @return int 0 = success
  */
-int rgbi_init(const struct i2c_dt_spec *rgb_dev, rgb_indicator_t * rgbi)
+int rgbi_initIndicator(rgb_indicator_t *rgbi, const rgbi_backend_t *backend, const lp5817_config_t *config, uint8_t id,
+                       const struct device *idScope)
 {
-    int ret = -1;
+    rgbi->backend = backend;
+    rgbi->config = config;
+    rgbi->id = id;
+    rgbi->idScope = idScope;
+    rgbi->brightness = UINT8_MAX;
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+    rgbi_settingsInit(rgbi, config);                            // stored values are loaded with the backend configuration
+#endif
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+    setScale(rgbi, config->colorScale);
+#endif
+#if defined(CONFIG_RGBINDICATOR_STATS)
+    memset(&(rgbi->stats), 0, sizeof(rgbi->stats));
+#endif
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+    rgbi->hwSequence = false;
+#endif
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    rgbi->seq.pattern = NULL;
+#endif
+    rgbi->cmdPending = false;
+    rgbi->cmdCallback = NULL;
+    rgbi->cmdAsync = false;
+    rgbi->cmdApplying = false;
+    atomic_clear(&(rgbi->currentsPending));
+    rgbi->currentsResult = 0;
+    atomic_set(&(rgbi->generation), 1);                         // generation 0 means no expiry
+    rgbi->armedGen = 0;
+    rgbi->activeGen = 1;
+#if defined(CONFIG_RGBINDICATOR_ARBITER)
+    memset(rgbi->slots, 0, sizeof(rgbi->slots));
+    rgbi->activeMask = 0;
+    rgbi->arbWinner = -1;
+    memset(&(rgbi->arbPosted), 0, sizeof(rgbi->arbPosted));
+#endif
 
-    if (lp5817_init(rgb_dev) == 0)                              // initialize/validate LP5817 before building object
-    {
-        ret = 0;                                                // clear err return
-        rgbi->rgbdev = rgb_dev;
+    rgbi_schedInit(&(rgbi->flashTimer), flashExpiry);
+    k_work_init(&(rgbi->flashWork), flashDisplay_handler);
 
-        k_timer_init(&(rgbi->flashTimer), flashTimerExpiry, NULL);
-        k_timer_user_data_set(&(rgbi->flashTimer), rgbi);
-        k_work_init(&(rgbi->flashWork), flashDisplay_handler);
-    }
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT)
+    k_event_init(&(rgbi->initEvent));
+    k_work_init(&(rgbi->initWork), init_handler);
+    rgbi->initCycles = k_cycle_get_32();
+    return (rgbi_submitWork(&(rgbi->initWork)) < 0) ? -EIO : 0;     // queued ahead of any command work
+#else
+    return configure(rgbi);
+#endif
+}
 
-    return ret;
+
+/**
+ * @brief Wait for the indicator chip configuration to complete
+ * 
+ * @param rgbi The RGB indicator
+ * @param timeout How long to wait
+ * @return int 0=ready, -EAGAIN timed out, else chip configuration error
+ */
+int rgbi_waitReady(rgb_indicator_t *rgbi, k_timeout_t timeout)
+{
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT)
+    if (isOnWorkq())
+    {
+        timeout = K_NO_WAIT;                                    // configuration is queued behind the caller
+    }
+    if (k_event_wait(&(rgbi->initEvent), RGBI_EVT_INIT_DONE, false, timeout) == 0)
+    {
+        return -EAGAIN;
+    }
+    return rgbi->initResult;
+#else
+    ARG_UNUSED(rgbi);
+    ARG_UNUSED(timeout);
+    return 0;
+#endif
 }
 
 
@@ -58,10 +187,11 @@ int rgbi_init(const struct i2c_dt_spec *rgb_dev, rgb_indicator_t * rgbi)
  * 
  * @param rgbi Indicator device to control
  * @param channels RBG structure containing red, green, and blue channels 
+ * @return int 0 = success
  */
-void rgbi_setColor(rgb_indicator_t *rgbi, const struct led_rgb * channels)
+int rgbi_setColor(rgb_indicator_t *rgbi, const struct led_rgb * channels)
 {
-    lp5817_setColor(rgbi->rgbdev, channels->r, channels->g, channels->b);
+    return setColorSync(rgbi, channels->r, channels->g, channels->b);
 }
 
 
@@ -72,24 +202,186 @@ void rgbi_setColor(rgb_indicator_t *rgbi, const struct led_rgb * channels)
  * @param red The red channel intensity (scale is 0=off to 255=full intensity)
  * @param green The green channel intensity
  * @param blue The blue channel intensity
+ * @return int 0 = success
+ */
+int rgbi_setColorFromPixels(rgb_indicator_t *rgbi, rgbi_color red, rgbi_color green, rgbi_color blue)
+{
+    return setColorSync(rgbi, red, green, blue);
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+/**
+ * @brief Post a color update from a RGB struct, returns without waiting for the I2C transfer
+ * 
+ * @param rgbi Indicator device to control
+ * @param channels RBG structure containing red, green, and blue channels 
+ * @param callback Optional completion callback
+ * @param userData Context for callback
+ * @return int 0 = posted
+ */
+int rgbi_setColorAsync(rgb_indicator_t *rgbi, const struct led_rgb * channels, rgbi_callback_t callback, void *userData)
+{
+    return rgbi_setColorFromPixelsAsync(rgbi, channels->r, channels->g, channels->b, callback, userData);
+}
+
+
+/**
+ * @brief Post a color update using 3 channel values, returns without waiting for the I2C transfer
+ * 
+ * @param rgbi Indicator device to control
+ * @param red The red channel intensity (scale is 0=off to 255=full intensity)
+ * @param green The green channel intensity
+ * @param blue The blue channel intensity
+ * @param callback Optional completion callback
+ * @param userData Context for callback
+ * @return int 0 = posted
  */
-void rgbi_setColorFromPixels(rgb_indicator_t *rgbi, rgbi_color red, rgbi_color green, rgbi_color blue)
+int rgbi_setColorFromPixelsAsync(rgb_indicator_t *rgbi, rgbi_color red, rgbi_color green, rgbi_color blue, rgbi_callback_t callback, void *userData)
 {
-    lp5817_setColor(rgbi->rgbdev, red, green, blue);
+    rgbi_cmd_t cmd = { .op = RGBI_CMD_SET, .pixels = { .r = red, .g = green, .b = blue } };
+
+    postCmd(rgbi, &cmd, callback, userData, true);                     // handler posts the write, backend completes the callback
+    return 0;
 }
 
 
 /**
- * @brief Turn indicator off
+ * @brief Post indicator off, returns without waiting for the I2C transfer, stops any flash or pattern
  *
  * @param rgbi The RGB indicator to actuate
+ * @param callback Optional completion callback
+ * @param userData Context for callback
+ * @return int 0 = posted
+ */
+int rgbi_offAsync(rgb_indicator_t *rgbi, rgbi_callback_t callback, void *userData)
+{
+    return rgbi_setColorFromPixelsAsync(rgbi, 0, 0, 0, callback, userData);
+}
+
+
+/**
+ * @brief Let caller know if posted updates are still waiting to reach the chip
+ * 
+ * @param rgbi The RGB indicator
+ * @return true Command waiting for the work handler, transfer in flight or staged
+ * @return false No update outstanding
+ */
+bool rgbi_isUpdating(rgb_indicator_t *rgbi)
+{
+    if (rgbi->cmdPending || rgbi->cmdApplying)                          // backend has not seen it yet
+    {
+        return true;
+    }
+    return (rgbi->backend->isUpdating != NULL) && rgbi->backend->isUpdating(rgbi);
+}
+#endif
+
+
+/**
+ * @brief Set overall indicator brightness through the backend output currents (LP5817 dot current, PWM duty scale)
+ * 
+ * @param rgbi The RGB indicator to actuate
+ * @param brightness 0-255 scale applied to the configured dot currents
+ * @return int 0 = success
+ */
+int rgbi_setBrightness(rgb_indicator_t *rgbi, uint8_t brightness)
+{
+    int ret = awaitInit(rgbi);
+
+    if (ret != 0)
+    {
+        return ret;
+    }
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+    k_spinlock_key_t key = k_spin_lock(&(rgbi->calibLock));
+
+    rgbi->brightness = brightness;
+    k_spin_unlock(&(rgbi->calibLock), key);
+    rgbi_settingsChanged(rgbi);
+#else
+    rgbi->brightness = brightness;
+#endif
+    return applyCurrents(rgbi);
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+/**
+ * @brief Set the per-channel color calibration (white balance)
+ * 
+ * @param rgbi The RGB indicator
+ * @param red Red scale, 0-255 (255=unscaled)
+ * @param green Green scale
+ * @param blue Blue scale
+ * @return int 0=success, -EAGAIN not yet configured
+ */
+int rgbi_setColorScale(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue)
+{
+    const uint8_t scale[3] = { red, green, blue };
+    int ret = awaitInit(rgbi);                                          // configuration sets the stored scale
+
+    if (ret != 0)
+    {
+        return ret;
+    }
+    setScale(rgbi, scale);
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+    k_spinlock_key_t key = k_spin_lock(&(rgbi->calibLock));
+
+    memcpy(rgbi->calib.colorScale, scale, sizeof(scale));
+    k_spin_unlock(&(rgbi->calibLock), key);
+    rgbi_settingsChanged(rgbi);
+#endif
+    return 0;
+}
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+/**
+ * @brief Replace the board calibration (channel map, max and dot currents, color scale)
+ * 
+ * @param rgbi The RGB indicator
+ * @param calib New calibration (copied)
+ * @return int 0=success, -EINVAL bad channel map, else backend error
  */
-void rgbi_off(rgb_indicator_t *rgbi)
+int rgbi_setCalibration(rgb_indicator_t *rgbi, const lp5817_config_t *calib)
 {
-    if (!isFlashing(rgbi))                                       // do not change indicator if flash sequence underway
+    k_spinlock_key_t key;
+    int ret;
+
+    if (!rgbi_settingsValid(calib))
+    {
+        return -EINVAL;
+    }
+    ret = awaitInit(rgbi);
+    if (ret != 0)
     {
-        rgbi_setColorFromPixels(rgbi, 0, 0, 0);
+        return ret;
     }
+
+    key = k_spin_lock(&(rgbi->calibLock));
+    rgbi->calib = *calib;
+    k_spin_unlock(&(rgbi->calibLock), key);
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+    setScale(rgbi, calib->colorScale);
+#endif
+    rgbi_settingsChanged(rgbi);
+    return applyCurrents(rgbi);
+}
+#endif
+
+
+/**
+ * @brief Turn indicator off, same command as a black rgbi_setColor(): stops any flash or pattern
+ *
+ * @param rgbi The RGB indicator to actuate
+ * @return int 0 = success
+ */
+int rgbi_off(rgb_indicator_t *rgbi)
+{
+    return setColorSync(rgbi, 0, 0, 0);
 }
 
 
@@ -104,18 +396,102 @@ void rgbi_off(rgb_indicator_t *rgbi)
  */
 void rgbi_flash(rgb_indicator_t *rgbi, struct led_rgb * pixels, k_timeout_t onDuration, k_timeout_t offDuration, uint8_t count)
 {
-    rgbi->onDuration = onDuration;
-    rgbi->offDuration = offDuration;
-    rgbi->flashesAsked = count;                                        // number of ON pulses OR 0==continuous
-    rgbi->flashesPerformed = 0;
-    memcpy(&(rgbi->pixels), pixels, sizeof(struct led_rgb));           // copy pixels into object (for next flash ON event)
+    rgbi_cmd_t cmd =
+    {
+        .op = RGBI_CMD_FLASH,
+        .count = count,                                                // number of ON pulses OR 0==continuous
+        .pixels = *pixels,
+        .fadeIn = K_NO_WAIT,
+        .onDuration = onDuration,
+        .fadeOut = K_NO_WAIT,
+        .offDuration = offDuration,
+    };
 
-    rgbi_setColor(rgbi, pixels);                                       // start the sequence, the flashExpiry() callback will take it from here
-    k_timer_start(&(rgbi->flashTimer), rgbi->onDuration, K_NO_WAIT);
-    rgbi->flashState = 1;
+    rgbi_post(rgbi, &cmd);                                             // started by the work handler, see flashStart()
 }
 
 
+/**
+ * @brief Setup/initiate a flash sequence that runs until cancelled
+ * 
+ * @param rgbi The RGB indicator to actuate
+ * @param pixels The color set to display when flash indicates ON
+ * @param onDuration The amount of time the indicator is on
+ * @param offDuration The amount of time the indicator is off
+ */
+void rgbi_flash_continuous(rgb_indicator_t *rgbi, struct led_rgb pixels, k_timeout_t onDuration, k_timeout_t offDuration)
+{
+    rgbi_flash(rgbi, &pixels, onDuration, offDuration, 0);
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+/**
+ * @brief Setup/initiate a breathe (fading flash) sequence on the LP5817 animation engine
+ * 
+ * @param rgbi The RGB indicator to actuate
+ * @param pixels The color at the peak of each breath
+ * @param fadeIn Ramp time from off to full color
+ * @param onDuration Hold time at full color
+ * @param fadeOut Ramp time from full color to off
+ * @param offDuration Hold time off between breaths
+ * @param count Number of breaths, 0=continuous
+ * @return int 0=success, -ENOTSUP if not representable by the engine (or not a LP5817 indicator)
+ */
+int rgbi_breathe(rgb_indicator_t *rgbi, const struct led_rgb * pixels, k_timeout_t fadeIn, k_timeout_t onDuration, k_timeout_t fadeOut, k_timeout_t offDuration, uint8_t count)
+{
+    rgbi_cmd_t cmd =
+    {
+        .op = RGBI_CMD_BREATHE,
+        .count = count,
+        .pixels = *pixels,
+        .fadeIn = fadeIn,
+        .onDuration = onDuration,
+        .fadeOut = fadeOut,
+        .offDuration = offDuration,
+    };
+
+    if (rgbi->backend->seqFits == NULL || !rgbi->backend->seqFits(rgbi, &cmd))   // reject now, caller cannot see the apply result
+    {
+        return -ENOTSUP;
+    }
+    rgbi_post(rgbi, &cmd);
+    return 0;
+}
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+/**
+ * @brief Get a snapshot of the indicator performance counters
+ * 
+ * @param rgbi The RGB indicator
+ * @param stats Returns counters
+ */
+void rgbi_getStats(rgb_indicator_t *rgbi, rgbi_stats_t *stats)
+{
+    unsigned int key = irq_lock();                             // counters also updated from I2C completion ISR
+
+    *stats = rgbi->stats;
+    irq_unlock(key);
+}
+
+
+/**
+ * @brief Clear the indicator performance counters
+ * 
+ * @param rgbi The RGB indicator
+ */
+void rgbi_resetStats(rgb_indicator_t *rgbi)
+{
+    unsigned int key = irq_lock();
+
+    memset(&(rgbi->stats), 0, sizeof(rgbi->stats));
+    irq_unlock(key);
+}
+#endif
+
+
 /**
  * @brief Let caller know if the indicator in busy displaying a flash sequence
  * 
@@ -125,7 +501,12 @@ void rgbi_flash(rgb_indicator_t *rgbi, struct led_rgb * pixels, k_timeout_t onDu
  */
 bool rgbi_isBusy(rgb_indicator_t *rgbi)
 {
-    return isFlashing(rgbi);
+    k_spinlock_key_t key = k_spin_lock(&(rgbi->cmdLock));
+    bool busy = rgbi->cmdPending ?                                          // posted command decides
+                (rgbi->cmd.op != RGBI_CMD_CANCEL && rgbi->cmd.op != RGBI_CMD_SET) : isFlashing(rgbi);
+
+    k_spin_unlock(&(rgbi->cmdLock), key);
+    return busy;
 }
 
 
@@ -136,159 +517,647 @@ bool rgbi_isBusy(rgb_indicator_t *rgbi)
  */
 void rgbi_cancel(rgb_indicator_t *rgbi)
 {
-    k_timer_stop(&(rgbi->flashTimer));                         // stop timer, prevent expiry
-    rgbi->onDuration = K_NO_WAIT;                              // clear flashing: onDuration==0 indicates idle
-    rgbi_off(rgbi);                                            // idle state is LED OFF
+    rgbi_cmd_t cmd = { .op = RGBI_CMD_CANCEL };
+
+    rgbi_post(rgbi, &cmd);                                     // stopped by the work handler, see flashStop()
 }
 
 
 /* Private service functions definitions
  * --------------------------------------------------------------------------------------------- */
 
- /**
- * @brief Initialize TI LP5817 chip for use
+
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT)
+/**
+ * @brief Background chip configuration, releases callers waiting on the indicator
  * 
- * @param rgb_ctrl The device spec for the RGB LED controller 
- * @return int 0=success
+ * @param work Init work item
  */
-static int lp5817_init(const struct i2c_dt_spec *rgb_ctrllr)
+static void init_handler(struct k_work *work)
 {
-	int ret;
-    uint8_t cmd[2];
+    rgb_indicator_t *rgbi = CONTAINER_OF(work, rgb_indicator_t, initWork);
+
+    rgbi->initResult = configure(rgbi);
+    LOG_INF("Indicator 0x%02x configured in %u us, err=%d", rgbi->id, k_cyc_to_us_floor32(k_cycle_get_32() - rgbi->initCycles), rgbi->initResult);
+    k_event_post(&(rgbi->initEvent), RGBI_EVT_INIT_DONE);
+}
+#endif
 
-    /* Write CHIP_EN = 1 to enable controller
-     * Set max current (chip and ouputs)
-     * Enable outputs
-     * Send UPDATE_CMD to activate configuration
-     */
 
-    if (!device_is_ready(rgb_ctrllr->bus)) {
-        LOG_ERR("I2C bus %s is not ready!\n\r",rgb_ctrllr->bus->name);
-        return 0;
+/**
+ * @brief Wait (thread) or check (ISR, indicator workqueue) for the chip configuration before direct chip access
+ * 
+ * The configuration runs on the indicator workqueue, a work item waiting for it there would
+ * block the queue it is queued on.
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=configured, -EAGAIN not yet (ISR, indicator workqueue), else configuration error
+ */
+static int awaitInit(rgb_indicator_t *rgbi)
+{
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT)
+    return rgbi_waitReady(rgbi, (k_is_in_isr() || isOnWorkq()) ? K_NO_WAIT : K_FOREVER);
+#else
+    ARG_UNUSED(rgbi);
+    return 0;
+#endif
+}
+
+
+/**
+ * @brief Load stored settings, set the color scale and configure the backend hardware
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=success, else backend error
+ */
+static int configure(rgb_indicator_t *rgbi)
+{
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+    if (rgbi_settingsLoad(rgbi) == 0)                                   // stored calibration/brightness, before the outputs see them
+    {
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+        setScale(rgbi, rgbi->config->colorScale);
+#endif
     }
+#endif
+    return rgbi->backend->configure(rgbi);
+}
 
-    cmd[0] = LP5817_REG_CHIPENABLE;
-    cmd[1] = LP5817_CMD_CHIPENABLE;
-    ret = i2c_write_dt(rgb_ctrllr, cmd, sizeof(cmd));
+
+/**
+ * @brief Map red/green/blue to backend outputs per the board channel map
+ * 
+ * @param rgbi The RGB indicator
+ * @param red Red channel intensity
+ * @param green Green channel intensity
+ * @param blue Blue channel intensity
+ * @param outputs Returns intensities in output (register) order OUT0-OUT2
+ */
+static inline void mapColor(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue, uint8_t outputs[3])
+{
+    // LP5817 0x18, 0x19, 0x1a and PWM pwms[0-2] = red, green, blue. Board wiring may differ, see config channelMap
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+    uint8_t scale[3];
+    k_spinlock_key_t key = k_spin_lock(&(rgbi->scaleLock));
+
+    memcpy(scale, rgbi->colorScale, sizeof(scale));
+    k_spin_unlock(&(rgbi->scaleLock), key);
+    outputs[rgbi->config->channelMap[0]] = correctLevel(red, scale[0]);     // shared gamma table load and a scale per channel
+    outputs[rgbi->config->channelMap[1]] = correctLevel(green, scale[1]);
+    outputs[rgbi->config->channelMap[2]] = correctLevel(blue, scale[2]);
+#else
+    outputs[rgbi->config->channelMap[0]] = red;
+    outputs[rgbi->config->channelMap[1]] = green;
+    outputs[rgbi->config->channelMap[2]] = blue;
+#endif
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_COLOR_LUT)
+/**
+ * @brief Set the channel calibration scales applied after the gamma table
+ * 
+ * @param rgbi The RGB indicator
+ * @param scale Red, green, blue calibration 0-255
+ */
+static void setScale(rgb_indicator_t *rgbi, const uint8_t scale[3])
+{
+    k_spinlock_key_t key = k_spin_lock(&(rgbi->scaleLock));
+
+    memcpy(rgbi->colorScale, scale, sizeof(rgbi->colorScale));
+    k_spin_unlock(&(rgbi->scaleLock), key);
+}
+
+
+/**
+ * @brief Output intensity of a color value: gamma curve (shared ROM table), then calibration scale
+ * 
+ * A non-zero value with a non-zero scale never maps to 0, dim colors stay lit.
+ * 
+ * @param value Color value 0-255
+ * @param scale Channel calibration 0-255 (255=unscaled)
+ * @return uint8_t Output intensity
+ */
+static inline uint8_t correctLevel(uint8_t value, uint8_t scale)
+{
+#if defined(CONFIG_RGBINDICATOR_GAMMA)
+    uint16_t level = rgbi_gamma[value];
+#else
+    uint16_t level = value;
+#endif
+
+    level = (level * scale + UINT8_MAX / 2) / UINT8_MAX;                        // constant divisor, compiles to multiply and shift
+    return (value > 0 && scale > 0) ? MAX(level, 1) : level;
+}
+#endif
+
+
+/**
+ * @brief Write a color to the backend and wait for it to reach the outputs
+ * 
+ * @param rgbi The RGB indicator
+ * @param red Red channel intensity
+ * @param green Green channel intensity
+ * @param blue Blue channel intensity
+ * @return int 0=success, else backend error
+ */
+static int writeColor(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue)
+{
+    int ret;
+    uint8_t levels[3];
+
+    TPIN_ON(rgbi_write);
+    mapColor(rgbi, red, green, blue, levels);
+    ret = rgbi->backend->setOutputs(rgbi, levels);
+    TPIN_OFF(rgbi_write);
     if (ret != 0)
     {
-        LOG_ERR("Failed to write chip enable (%x) to LP5817@%x err=%d\r\n", cmd[0], rgb_ctrllr->addr, ret);
+    	LOG_ERR("Could not update indicator, err=%d", ret);
     }
+    return ret;
+}
 
-    cmd[0] = LP5817_REG_MAXCURRENT;
-    cmd[1] = LP5817_CMD_MAXCURRENT;
-    ret = i2c_write_dt(rgb_ctrllr, cmd, sizeof(cmd));
-    if (ret != 0)
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+/**
+ * @brief Post a color to the backend, backends without a transfer queue write it now and complete
+ * 
+ * The callback completes every post, failures included (work handler context).
+ * 
+ * @return int 0=posted, else backend error
+ */
+static int writeColorAsync(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue, rgbi_callback_t callback, void *userData)
+{
+    int ret;
+    uint8_t levels[3];
+
+    mapColor(rgbi, red, green, blue, levels);
+    if (rgbi->backend->setOutputsAsync != NULL)
+    {
+        return rgbi->backend->setOutputsAsync(rgbi, levels, callback, userData);
+    }
+    ret = rgbi->backend->setOutputs(rgbi, levels);
+    if (callback != NULL)
     {
-        LOG_ERR("Failed to set LP5817 chip-level max current\r\n");
+        callback(rgbi, ret, userData);
     }
+    return ret;
+}
+#endif
+
 
-    ret = 0;
-    for (size_t i = 0; i < 3; i++)
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+/**
+ * @brief Hand a flash/breathe sequence to the backend sequencer (LP5817 engine, nRF PWM loop)
+ * 
+ * @param rgbi The RGB indicator
+ * @param cmd Flash or breathe command
+ * @return int 0=hardware running the sequence, -ENOTSUP use timer driven flash, else backend error
+ */
+static int flashHw(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd)
+{
+    int ret;
+    uint8_t peak[3];
+    uint32_t runMs = 0;
+
+    if (rgbi->backend->seqStart == NULL)
     {
-        cmd[0] = LP5817_REG_DOTCURRENT_0 + i;
-        cmd[1] = dot_current[i];                                        // apply dot (channel) configured current (brightness adjustment)
-        ret += i2c_write_dt(rgb_ctrllr, cmd, sizeof(cmd));
+        return -ENOTSUP;
     }
+
+    rgbi_schedCancel(&(rgbi->flashTimer));                             // replacing any sequence underway
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    rgbi->seq.pattern = NULL;
+#endif
+    mapColor(rgbi, cmd->pixels.r, cmd->pixels.g, cmd->pixels.b, peak);
+    ret = rgbi->backend->seqStart(rgbi, cmd, peak, &runMs);
     if (ret != 0)
     {
-        LOG_ERR("Failed to set LP5817 DOT (channel) current\r\n");
+        if (ret != -ENOTSUP)
+        {
+            LOG_ERR("Failed to start hardware sequence, err=%d", ret);
+        }
+        return ret;
     }
 
-    cmd[0] = LP5817_REG_OUTENABLE;
-    cmd[1] = LP5817_CMD_OUTENABLE;
-    ret = i2c_write_dt(rgb_ctrllr, cmd, sizeof(cmd));
-    if (ret != 0)
+    rgbi->hwSequence = true;                                           // signals busy, see isFlashing()
+    rgbi->onDuration = cmd->onDuration;
+    rgbi->offDuration = cmd->offDuration;
+    rgbi->flashesAsked = cmd->count;
+    rgbi->flashesPerformed = 0;
+    rgbi->pixels = cmd->pixels;
+
+    if (cmd->count > 0)
     {
-        LOG_ERR("Failed to enable channels\r\n");
+        rgbi_armTimer(rgbi, K_MSEC(runMs));                             // single expiry at the end of the run
     }
+    return 0;
+}
+#endif
 
 
-    lp5817_setColor(rgb_ctrllr, 0, 0, 0);
+/**
+ * @brief Set indicator color from a timed sequence, posted without blocking the workqueue when async is enabled
+ */
+void rgbi_outputColor(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue)
+{
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    (void)writeColorAsync(rgbi, red, green, blue, NULL, NULL);
+#else
+    (void)writeColor(rgbi, red, green, blue);
+#endif
+}
 
-    cmd[0] = LP5817_REG_UPDATE;
-    cmd[1] = LP5817_CMD_UPDATE;
-    ret = i2c_write_dt(rgb_ctrllr, cmd, sizeof(cmd));
-    if (ret != 0)
+
+/**
+ * @brief Stop the backend sequencer if it is running a sequence
+ */
+void rgbi_stopEngine(rgb_indicator_t *rgbi)
+{
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+    if (rgbi->hwSequence)
     {
-        LOG_ERR("Failed to apply settings to LP5817\r\n");
+        rgbi->hwSequence = false;
+        rgbi->backend->seqStop(rgbi);                                   // return outputs to manual intensity control
     }
+#else
+    ARG_UNUSED(rgbi);
+#endif
+}
 
-    // uint8_t val;
-    // i2c_reg_read_byte_dt(rgb_ctrllr, LP5817_REG_OUTENABLE, &val);
-    // if (val != 0)
-    // {
-    //     LOG_WRN("Warning: LP5817 is not enabled\r\n");
-    // }
 
-    return ret;
+/**
+ * @brief Post a sequence command, constant time from any context
+ */
+void rgbi_post(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd)
+{
+    postCmd(rgbi, cmd, NULL, NULL, false);
+}
+
+
+/**
+ * @brief Arm the flash timer for the running sequence (work handler context)
+ */
+void rgbi_armTimer(rgb_indicator_t *rgbi, k_timeout_t delay)
+{
+    rgbi->armedGen = rgbi->activeGen;
+    (void)rgbi_schedArm(&(rgbi->flashTimer), delay);                   // sequence times are relative
+}
+
+
+/**
+ * @brief Post a solid color to the work handler and wait for its write (posted only from ISR)
+ * 
+ * The work handler owns the backend and the sequence state, the color replaces any sequence
+ * underway. On the indicator workqueue the handler runs in place, it cannot run behind its caller.
+ * 
+ * @param rgbi The RGB indicator
+ * @param red Red channel intensity
+ * @param green Green channel intensity
+ * @param blue Blue channel intensity
+ * @return int 0=written (or posted from ISR), -ECANCELED replaced before written, else backend error
+ */
+static int setColorSync(rgb_indicator_t *rgbi, uint8_t red, uint8_t green, uint8_t blue)
+{
+    rgbi_cmd_t cmd = { .op = RGBI_CMD_SET, .pixels = { .r = red, .g = green, .b = blue } };
+    struct cmdWait wait;
+    int ret;
+
+    if (k_is_in_isr())
+    {
+        postCmd(rgbi, &cmd, NULL, NULL, false);
+        return 0;
+    }
+    ret = awaitInit(rgbi);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    k_sem_init(&(wait.done), 0, 1);
+    postCmd(rgbi, &cmd, cmdComplete, &wait, false);
+    if (isOnWorkq())
+    {
+        flashService(rgbi, 0);
+    }
+    k_sem_take(&(wait.done), K_FOREVER);
+    return wait.result;
 }
 
 
-static void lp5817_setColor(const struct i2c_dt_spec *rgb_ctrllr, uint8_t red, uint8_t green, uint8_t blue)
+/**
+ * @brief Have the work handler write the output currents and wait for the write (posted only from ISR)
+ * 
+ * Brightness and calibration are not commands, they do not replace the command posted or the
+ * sequence underway. The backend only sees them from the work handler, which owns the outputs.
+ * 
+ * @param rgbi The RGB indicator
+ * @return int 0=written (or posted from ISR), else backend error
+ */
+static int applyCurrents(rgb_indicator_t *rgbi)
 {
-   	int ret;
-    uint8_t cmd[2];
+    struct k_work_sync sync;
 
-    // per TI documentation 0x18, 0x 19, 0x1a. But doesn't seem to be that way
-    // cmd[0] = LP5817_REG_INTENSITY0;      // red
-    // cmd[0] = LP5817_REG_INTENSITY1;      // green
-    // cmd[0] = LP5817_REG_INTENSITY2;      // blue
+    atomic_set(&(rgbi->currentsPending), 1);
+    if (isOnWorkq())
+    {
+        flashService(rgbi, 0);
+        return rgbi->currentsResult;
+    }
+    rgbi_submitWork(&(rgbi->flashWork));
+    if (k_is_in_isr())
+    {
+        return 0;
+    }
+    (void)k_work_flush(&(rgbi->flashWork), &sync);                       // the run after the submit wrote the currents
+    return rgbi->currentsResult;
+}
 
-    cmd[0] = LP5817_REG_INTENSITY2;
-    cmd[1] = red;
-    ret = i2c_write_dt(rgb_ctrllr, cmd, sizeof(cmd));
 
-    cmd[0] = LP5817_REG_INTENSITY0;
-    cmd[1] = green;
-    ret = i2c_write_dt(rgb_ctrllr, cmd, sizeof(cmd));
+/**
+ * @brief Post a command for the work handler, the latest command wins
+ * 
+ * @param rgbi The RGB indicator
+ * @param cmd Command (copied)
+ * @param callback Called with the apply result, or -ECANCELED when a newer command replaces it first
+ * @param userData Context for callback
+ * @param async SET posted by an async setter: the callback goes with the backend write (transfer result)
+ */
+static void postCmd(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, rgbi_callback_t callback, void *userData, bool async)
+{
+    rgbi_callback_t supersededCb;
+    void *supersededData;
+    k_spinlock_key_t key = k_spin_lock(&(rgbi->cmdLock));
 
-    cmd[0] = LP5817_REG_INTENSITY1;
-    cmd[1] = blue;
-    ret = i2c_write_dt(rgb_ctrllr, cmd, sizeof(cmd));
+    supersededCb = rgbi->cmdPending ? rgbi->cmdCallback : NULL;
+    supersededData = rgbi->cmdUserData;
+    rgbi->cmd = *cmd;                                                   // latest command wins
+    rgbi->cmdCallback = callback;
+    rgbi->cmdUserData = userData;
+    rgbi->cmdAsync = async;
+    rgbi->cmdPending = true;
+    atomic_inc(&(rgbi->generation));                                    // under lock, generation matches the slot contents
+    k_spin_unlock(&(rgbi->cmdLock), key);
 
-    if (ret != 0)
+    if (supersededCb != NULL)
     {
-    	LOG_ERR("Could not update indicator");
+        supersededCb(rgbi, -ECANCELED, supersededData);
     }
+    rgbi_submitWork(&(rgbi->flashWork));
+}
+
+
+/**
+ * @brief Completion of a command posted by setColorSync(), wakes the caller
+ */
+static void cmdComplete(rgb_indicator_t *rgbi, int result, void *userData)
+{
+    struct cmdWait *wait = (struct cmdWait *)userData;
 
+    ARG_UNUSED(rgbi);
+    wait->result = result;
+    k_sem_give(&(wait->done));
 }
 
 
 /**
- * @brief ISR to service end of flash duration
+ * @brief Scheduler expiry of the flash timer, runs on the indicator workqueue
  * 
- * @param flashTimer Timer object
+ * @param timer Flash timer node
  */
-static void flashTimerExpiry(struct k_timer *flashTimer)
+static void flashExpiry(rgbi_timer_t *timer)
 {
-    rgb_indicator_t * rgbi = (rgb_indicator_t *)k_timer_user_data_get(flashTimer);     // get rgb indicator object from timer
-    k_work_submit(&(rgbi->flashWork));                                                 // submit the work item to system WQ to update flash sequence
+    rgb_indicator_t *rgbi = CONTAINER_OF(timer, rgb_indicator_t, flashTimer);         // get rgb indicator object from timer
+
+    flashService(rgbi, rgbi->armedGen);                                                // dropped if sequence replaced
 }
 
 
 /**
- * @brief Handler to perform RGB indicator update (flash ON>>OFF or OFF>>ON)
+ * @brief Handler to apply commands and colors posted from any context
  * 
  * @param work workqueue item to process
  */
 static void flashDisplay_handler(struct k_work *work)
 {
-    rgb_indicator_t *rgbi = CONTAINER_OF(work, rgb_indicator_t, flashWork);            // get parent structure: rgb indicator struct
-    // rgb_indicator_t * indicator = (rgb_indicator_t *)k_timer_user_data_get(flashTimer);
+    flashService(CONTAINER_OF(work, rgb_indicator_t, flashWork), 0);                  // get parent structure: rgb indicator struct
+}
+
+
+/**
+ * @brief Apply posted commands and perform RGB indicator update (flash ON>>OFF or OFF>>ON)
+ * 
+ * Only this function changes sequence state or writes the outputs and currents, it runs from the
+ * command work item and from scheduler expiries, both on the indicator workqueue.
+ * 
+ * @param rgbi The RGB indicator
+ * @param expiredGen Generation the expired timer was armed for, 0=no expiry
+ */
+static void flashService(rgb_indicator_t *rgbi, atomic_val_t expiredGen)
+{
+    k_spinlock_key_t key;
+    rgbi_cmd_t cmd;
+    rgbi_callback_t callback = NULL;
+    void *userData = NULL;
+    bool haveCmd;
+    bool async = false;
+#if defined(CONFIG_RGBINDICATOR_STATS)
+    uint32_t start = k_cycle_get_32();
+#endif
+
+    TPIN_ON(rgbi_handler);
+    key = k_spin_lock(&(rgbi->cmdLock));
+    haveCmd = rgbi->cmdPending;
+    if (haveCmd)
+    {
+        cmd = rgbi->cmd;
+        callback = rgbi->cmdCallback;
+        userData = rgbi->cmdUserData;
+        async = rgbi->cmdAsync;
+        rgbi->cmdCallback = NULL;
+        rgbi->cmdPending = false;
+        rgbi->cmdApplying = true;                                       // rgbi_isUpdating() until the backend has it
+        rgbi->activeGen = atomic_get(&(rgbi->generation));             // expiries armed before this are now stale
+    }
+    k_spin_unlock(&(rgbi->cmdLock), key);
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    if (haveCmd && async)                                              // async setter: the backend completes the callback
+    {
+        flashStop(rgbi);
+        (void)writeColorAsync(rgbi, cmd.pixels.r, cmd.pixels.g, cmd.pixels.b, callback, userData);
+        haveCmd = false;
+    }
+#else
+    ARG_UNUSED(async);
+#endif
+    if (haveCmd)
+    {
+        int ret = cmdApply(rgbi, &cmd, callback != NULL);
+
+        if (callback != NULL)
+        {
+            callback(rgbi, ret, userData);
+        }
+    }
+    rgbi->cmdApplying = false;
+    if (atomic_cas(&(rgbi->currentsPending), 1, 0))                   // brightness/calibration changed
+    {
+        rgbi->currentsResult = rgbi->backend->setCurrents(rgbi);
+    }
+
+    if (expiredGen == rgbi->activeGen)                                 // expiry for the running sequence, else stale
+    {
+#if defined(CONFIG_RGBINDICATOR_STATS)
+        statsRecord(rgbi->stats.wakeLatency, &(rgbi->stats.wakeLatencyMaxUs), start - rgbi_schedWakeCycles());
+        flashDisplay_update(rgbi);
+        statsRecord(rgbi->stats.handlerTime, &(rgbi->stats.handlerTimeMaxUs), k_cycle_get_32() - start);
+#else
+        flashDisplay_update(rgbi);
+#endif
+    }
+    TPIN_OFF(rgbi_handler);
+}
+
+
+/**
+ * @brief Apply a posted command, replaces any sequence underway
+ * 
+ * @param rgbi The RGB indicator
+ * @param cmd Command to apply
+ * @param sync A caller waits: write a SET color now and return the result, else post it as the sequence edges
+ * @return int 0=applied, else SET write error (sync only)
+ */
+static int cmdApply(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd, bool sync)
+{
+    int ret = 0;
+
+    switch (cmd->op)
+    {
+        case RGBI_CMD_SET:
+            flashStop(rgbi);
+            if (sync)
+            {
+                ret = writeColor(rgbi, cmd->pixels.r, cmd->pixels.g, cmd->pixels.b);
+            }
+            else
+            {
+                rgbi_outputColor(rgbi, cmd->pixels.r, cmd->pixels.g, cmd->pixels.b);
+            }
+            break;
+
+        case RGBI_CMD_FLASH:
+            flashStart(rgbi, cmd);
+            break;
+
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+        case RGBI_CMD_BREATHE:
+            if (flashHw(rgbi, cmd) != 0)
+            {
+                flashStop(rgbi);
+                rgbi_outputColor(rgbi, 0, 0, 0);
+            }
+            break;
+#endif
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+        case RGBI_CMD_PLAY:
+            rgbi_seqStart(rgbi, cmd->pattern);
+            break;
+#endif
+
+        case RGBI_CMD_CANCEL:
+        default:
+            flashStop(rgbi);
+            rgbi_outputColor(rgbi, 0, 0, 0);                           // idle state is LED OFF
+            break;
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Start a timer driven flash sequence, or hand it to the backend sequencer when representable
+ * 
+ * @param rgbi The RGB indicator
+ * @param cmd Flash command
+ */
+static void flashStart(rgb_indicator_t *rgbi, const rgbi_cmd_t *cmd)
+{
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+    if (flashHw(rgbi, cmd) == 0)
+    {
+        return;                                                        // hardware runs the sequence, no timer edges
+    }
+    rgbi_stopEngine(rgbi);                                             // timer driven sequence replaces hardware sequence
+#endif
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    rgbi->seq.pattern = NULL;                                          // flash replaces pattern
+#endif
+    rgbi->onDuration = cmd->onDuration;
+    rgbi->offDuration = cmd->offDuration;
+    rgbi->flashesAsked = cmd->count;                                   // number of ON pulses OR 0==continuous
+    rgbi->flashesPerformed = 0;
+    rgbi->pixels = cmd->pixels;                                        // copy pixels into object (for next flash ON event)
+
+    rgbi_outputColor(rgbi, cmd->pixels.r, cmd->pixels.g, cmd->pixels.b);     // start the sequence, timer expiry takes it from here
+    rgbi_armTimer(rgbi, rgbi->onDuration);
+    rgbi->flashState = 1;
+}
+
+
+/**
+ * @brief Stop any sequence underway, outputs are left to the caller
+ * 
+ * @param rgbi The RGB indicator
+ */
+static void flashStop(rgb_indicator_t *rgbi)
+{
+    rgbi_schedCancel(&(rgbi->flashTimer));                             // stop timer, prevent expiry
+    rgbi_stopEngine(rgbi);
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    rgbi->seq.pattern = NULL;                                          // stop pattern
+#endif
+    rgbi->onDuration = K_NO_WAIT;                                      // clear flashing: onDuration==0 indicates idle
+}
+
+
+/**
+ * @brief Advance the flash, engine or pattern sequence on timer expiry
+ * 
+ * @param rgbi The RGB indicator
+ */
+static void flashDisplay_update(rgb_indicator_t *rgbi)
+{
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    if (rgbi->seq.pattern != NULL)                                         // pattern playing, advance to next frame
+    {
+        rgbi_seqRun(rgbi);
+        return;
+    }
+#endif
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+    if (rgbi->hwSequence)                                                  // single expiry at end of a hardware run sequence
+    {
+        (void)writeColor(rgbi, 0, 0, 0);                                   // ends dark as the timer path, levels show once stopped
+        rgbi_stopEngine(rgbi);
+        rgbi->onDuration = K_NO_WAIT;                                      // signal done
+        return;
+    }
+#endif
 
     if (rgbi->onDuration.ticks > 0)
     {
         if (rgbi->flashState)                                              // is ON currently
         {
-            rgbi_setColorFromPixels(rgbi, 0, 0, 0);                        // can't use rgbi_off inside flash sequence
+            rgbi_outputColor(rgbi, 0, 0, 0);                                  // can't use rgbi_off inside flash sequence
             rgbi->flashState = 0;
             rgbi->flashesPerformed++;                                      // completed an ON flash
 
             if (rgbi->flashesPerformed < rgbi->flashesAsked ||        // still flashes to perform
                 rgbi->flashesAsked == 0)                                   // OR IF continuous flash sequence
             {
-                k_timer_start(&(rgbi->flashTimer), rgbi->offDuration, K_NO_WAIT);    // wait out OFF (for next ON event)
+                rgbi_armTimer(rgbi, rgbi->offDuration);                    // wait out OFF (for next ON event)
             }
             else                                                                // done with flash sequence, reset
             {
@@ -300,10 +1169,11 @@ static void flashDisplay_handler(struct k_work *work)
         else                                                                    // indicator is OFF
         {
             rgbi->flashState = 1;
-            if (rgbi->flashesPerformed < rgbi->flashesAsked)
+            if (rgbi->flashesPerformed < rgbi->flashesAsked ||
+                rgbi->flashesAsked == 0)                                   // continuous flash sequence
             {
-                rgbi_setColor(rgbi, &(rgbi->pixels));                 // turn indicator ON
-                k_timer_start(&(rgbi->flashTimer), rgbi->onDuration, K_NO_WAIT);
+                rgbi_outputColor(rgbi, rgbi->pixels.r, rgbi->pixels.g, rgbi->pixels.b);   // turn indicator ON
+                rgbi_armTimer(rgbi, rgbi->onDuration);
             }
         }
     }
@@ -319,5 +1189,105 @@ static void flashDisplay_handler(struct k_work *work)
  */
 static inline bool isFlashing(rgb_indicator_t * rgbi)
 {
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    if (rgbi->seq.pattern != NULL)
+    {
+        return true;
+    }
+#endif
+#if defined(CONFIG_RGBINDICATOR_HWSEQ)
+    if (rgbi->hwSequence)
+    {
+        return true;
+    }
+#endif
     return rgbi->onDuration.ticks > 0;
 }
+
+
+/**
+ * @brief Determine if the caller runs on the workqueue indicator work is submitted to
+ * 
+ * @return true Caller is the indicator workqueue thread (system workqueue without it)
+ * @return false Other thread or ISR
+ */
+static inline bool isOnWorkq(void)
+{
+#if defined(CONFIG_RGBINDICATOR_WORKQUEUE)
+    return k_current_get() == k_work_queue_thread_get(&rgbi_workq);
+#else
+    return k_current_get() == k_work_queue_thread_get(&k_sys_work_q);
+#endif
+}
+
+
+/**
+ * @brief Submit indicator work to the module workqueue (if configured) or the system workqueue
+ */
+int rgbi_submitWork(struct k_work *work)
+{
+#if defined(CONFIG_RGBINDICATOR_WORKQUEUE)
+    return k_work_submit_to_queue(&rgbi_workq, work);
+#else
+    return k_work_submit(work);
+#endif
+}
+
+
+/**
+ * @brief Schedule delayed indicator work on the module workqueue (if configured) or the system workqueue
+ */
+int rgbi_scheduleWork(struct k_work_delayable *dwork, k_timeout_t delay)
+{
+#if defined(CONFIG_RGBINDICATOR_WORKQUEUE)
+    return k_work_schedule_for_queue(&rgbi_workq, dwork, delay);
+#else
+    return k_work_schedule(dwork, delay);
+#endif
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_WORKQUEUE)
+/**
+ * @brief Start the indicator workqueue thread at boot, ahead of any rgbi_init() call
+ * 
+ * @return int 0=success
+ */
+static int rgbi_workqInit(void)
+{
+    const struct k_work_queue_config cfg = { .name = "rgbi_workq" };
+
+    k_work_queue_init(&rgbi_workq);
+    k_work_queue_start(&rgbi_workq, rgbi_workqStack, K_THREAD_STACK_SIZEOF(rgbi_workqStack),
+                       CONFIG_RGBINDICATOR_WORKQUEUE_PRIORITY, &cfg);
+    return 0;
+}
+
+SYS_INIT(rgbi_workqInit, POST_KERNEL, 0);
+#endif
+
+
+#if defined(CONFIG_RGBINDICATOR_STATS)
+/**
+ * @brief Add a sample to a log2 latency histogram (bucket 0 <32us, each bucket doubles)
+ * 
+ * @param hist Histogram buckets
+ * @param maxUs Running maximum
+ * @param cycles Sample duration in hardware cycles
+ */
+static void statsRecord(uint32_t hist[RGBI_HIST_BUCKETS], uint32_t *maxUs, uint32_t cycles)
+{
+    uint32_t us = k_cyc_to_us_floor32(cycles);
+    uint32_t bucket = 0;
+
+    for (uint32_t limit = 32; bucket < RGBI_HIST_BUCKETS - 1 && us >= limit; limit <<= 1)
+    {
+        bucket++;
+    }
+    hist[bucket]++;
+    if (us > *maxUs)
+    {
+        *maxUs = us;
+    }
+}
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SPI_STREAM
+#define SPI_STREAM
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/spi.h>
+
+
+/* Application SPI (spi1, SPIM EasyDMA, GPIO chip select) streaming and batching
+ *
+ * Streaming repeats one read transfer (command bytes out, then a block in) into two statically
+ * allocated DMA buffers in turn. A completed block is handed to the consumer in place while the
+ * next block is transferred into the other buffer, the consumer releases the block to make the
+ * buffer available again. When the consumer holds both buffers the stream stalls (counted) until
+ * a release, no data is copied or dropped.
+ *
+ * Batching runs several small transactions in one transfer under a single CS assertion, for
+ * devices that accept back to back commands without a CS edge.
+ */
+
+/* Stream definition
+ */
+typedef struct _spis_streamConfig
+{
+    const uint8_t *cmd;                                 // bytes sent at the start of each block (read command), can be NULL
+    size_t cmdLen;
+    size_t blockLen;                                    // bytes read per block (max CONFIG_SPISTREAM_BLOCK_MAX)
+} spis_streamConfig_t;
+
+/* Transactions run under one CS assertion
+ */
+typedef struct _spis_batch
+{
+    struct spi_buf tx[CONFIG_SPISTREAM_BATCH_MAX];
+    struct spi_buf rx[CONFIG_SPISTREAM_BATCH_MAX];
+    uint8_t count;
+} spis_batch_t;
+
+/* Transfer counters since boot or spis_resetStats()
+ */
+typedef struct _spis_stats
+{
+    uint32_t blocks;                                    // stream blocks delivered
+    uint32_t batches;                                   // batches run
+    uint32_t transactions;                              // transactions in those batches
+    uint32_t bytes;                                     // bytes clocked (stream and batches)
+    uint32_t stalls;                                    // stream waited on the consumer to release a block
+    uint32_t errors;
+    uint32_t busyUs;                                    // time transfers were in progress
+    uint32_t elapsedUs;                                 // measurement window
+    uint32_t throughputBps;                             // bytes / elapsed, bytes per second
+} spis_stats_t;
+
+
+/**
+ * @brief Start streaming blocks
+ *
+ * @param config Stream definition (copied, cmd bytes must remain valid until spis_streamStop())
+ * @return int 0=streaming, -EBUSY already streaming, -EINVAL bad definition, -ENODEV bus not ready
+ */
+int spis_streamStart(const spis_streamConfig_t *config);
+
+
+/**
+ * @brief Stop streaming, waits for the transfer in progress
+ *
+ * @return int 0=stopped
+ *
+ * @note Blocks not yet released stay valid until released.
+ */
+int spis_streamStop(void);
+
+
+/**
+ * @brief Wait for the next stream block
+ *
+ * @param block Returns pointer to the block data (DMA buffer, no copy)
+ * @param timeout How long to wait
+ * @return int Block length, -EAGAIN timed out
+ *
+ * @note Single consumer. Release each block with spis_streamRelease().
+ */
+int spis_streamGet(const uint8_t **block, k_timeout_t timeout);
+
+
+/**
+ * @brief Return a block to the stream
+ *
+ * @param block Block from spis_streamGet()
+ */
+void spis_streamRelease(const uint8_t *block);
+
+
+/**
+ * @brief Clear a batch
+ *
+ * @param batch Batch to initialize
+ */
+void spis_batchInit(spis_batch_t *batch);
+
+
+/**
+ * @brief Add a transaction to a batch
+ *
+ * @param batch Batch
+ * @param tx Bytes to send (NULL=send fill bytes)
+ * @param rx Returns bytes received (NULL=discard)
+ * @param len Transaction length
+ * @return int 0=added, -ENOMEM batch full
+ */
+int spis_batchAdd(spis_batch_t *batch, const void *tx, void *rx, size_t len);
+
+
+/**
+ * @brief Run a batch under one CS assertion and wait for it to complete
+ *
+ * @param batch Batch to run
+ * @return int 0=success, -EBUSY streaming, else SPI error
+ *
+ * @note Thread context only.
+ */
+int spis_batchRun(spis_batch_t *batch);
+
+
+/**
+ * @brief Get a snapshot of the transfer counters
+ *
+ * @param stats Returns counters and throughput
+ */
+void spis_getStats(spis_stats_t *stats);
+
+
+/**
+ * @brief Restart the statistics window
+ */
+void spis_resetStats(void);
+
+#endif
@@ -0,0 +1,386 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/sys/atomic.h>
+
+#include "spi-stream.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(spis, CONFIG_SPISTREAM_LOG_LEVEL);
+
+#define SPIS_NODE DT_NODELABEL(spi1)
+#define SPIS_OPERATION (SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB | SPI_WORD_SET(8) | \
+                        ((CONFIG_SPISTREAM_MODE & 0x02) ? SPI_MODE_CPOL : 0) | ((CONFIG_SPISTREAM_MODE & 0x01) ? SPI_MODE_CPHA : 0))
+
+static const struct device *const spis_dev = DEVICE_DT_GET(SPIS_NODE);
+static const struct spi_config spis_spiConfig =
+{
+    .frequency = CONFIG_SPISTREAM_FREQUENCY,
+    .operation = SPIS_OPERATION,
+    .cs = { .gpio = GPIO_DT_SPEC_GET_BY_IDX(SPIS_NODE, cs_gpios, 0), .delay = 0 },
+};
+
+static uint8_t spis_dmaBuf[2][CONFIG_SPISTREAM_BLOCK_MAX] __aligned(4);        // ping-pong stream blocks, EasyDMA targets
+K_MSGQ_DEFINE(spis_ready, sizeof(uint8_t), 2, 1);                              // filled block indexes, to the consumer
+
+static struct
+{
+    struct k_spinlock lock;                             // guards stream state and statistics
+    struct k_work nextWork;                             // starts the next block (SPI driver can't be restarted from its callback)
+    struct k_sem idle;                                  // transfer in progress finished after stop
+    spis_streamConfig_t config;
+    struct spi_buf txBuf;
+    struct spi_buf rxBuf[2];                            // command (discarded), block
+    bool running;
+    bool busy;                                          // block transfer in progress
+    bool stalled;                                       // next buffer held by the consumer
+    uint8_t fillIdx;                                    // buffer the next block is read into
+    atomic_t held;                                      // bit per buffer: filled, not yet released
+    uint32_t startCycles;
+    uint32_t windowStart;
+    spis_stats_t stats;
+} spis;
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static void streamNext(struct k_work *work);
+static void streamDone(const struct device *dev, int result, void *userData);
+static void statsTransfer(uint32_t startCycles, size_t bytes, int result);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Start streaming blocks
+ */
+int spis_streamStart(const spis_streamConfig_t *config)
+{
+    uint8_t idx;
+
+    if (!device_is_ready(spis_dev))
+    {
+        return -ENODEV;
+    }
+    if (config->blockLen == 0 || config->blockLen > CONFIG_SPISTREAM_BLOCK_MAX || (config->cmdLen > 0 && config->cmd == NULL))
+    {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);
+    if (spis.running || spis.busy)
+    {
+        k_spin_unlock(&spis.lock, key);
+        return -EBUSY;
+    }
+    spis.config = *config;
+    spis.running = true;
+    spis.stalled = false;
+    spis.fillIdx = 0;
+    atomic_clear(&spis.held);
+    k_spin_unlock(&spis.lock, key);
+
+    while (k_msgq_get(&spis_ready, &idx, K_NO_WAIT) == 0)               // blocks left from the last stream
+    {
+    }
+
+    spis.txBuf.buf = (void *)config->cmd;
+    spis.txBuf.len = config->cmdLen;
+    spis.rxBuf[0].buf = NULL;
+    spis.rxBuf[0].len = config->cmdLen;
+    spis.rxBuf[1].len = config->blockLen;
+
+    k_sem_init(&spis.idle, 0, 1);
+    k_work_init(&spis.nextWork, streamNext);
+    k_work_submit(&spis.nextWork);
+    return 0;
+}
+
+
+/**
+ * @brief Stop streaming, waits for the transfer in progress
+ */
+int spis_streamStop(void)
+{
+    struct k_work_sync sync;
+    bool wasBusy;
+
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);
+    if (!spis.running)
+    {
+        k_spin_unlock(&spis.lock, key);
+        return 0;
+    }
+    spis.running = false;
+    k_spin_unlock(&spis.lock, key);
+
+    k_work_cancel_sync(&spis.nextWork, &sync);
+    key = k_spin_lock(&spis.lock);
+    wasBusy = spis.busy;
+    k_spin_unlock(&spis.lock, key);
+    if (wasBusy)
+    {
+        k_sem_take(&spis.idle, K_FOREVER);
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Wait for the next stream block
+ */
+int spis_streamGet(const uint8_t **block, k_timeout_t timeout)
+{
+    uint8_t idx;
+    int ret = k_msgq_get(&spis_ready, &idx, timeout);
+
+    if (ret != 0)
+    {
+        return -EAGAIN;
+    }
+    *block = spis_dmaBuf[idx];
+    return spis.config.blockLen;
+}
+
+
+/**
+ * @brief Return a block to the stream
+ */
+void spis_streamRelease(const uint8_t *block)
+{
+    uint8_t idx = (block == spis_dmaBuf[1]) ? 1 : 0;
+    bool resume;
+
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);                    // streamNext() tests held and sets stalled under the lock
+    atomic_clear_bit(&spis.held, idx);
+    resume = spis.stalled && spis.running;                              // cleared by streamNext() once it starts the block
+    k_spin_unlock(&spis.lock, key);
+
+    if (resume)
+    {
+        k_work_submit(&spis.nextWork);
+    }
+}
+
+
+/**
+ * @brief Clear a batch
+ */
+void spis_batchInit(spis_batch_t *batch)
+{
+    batch->count = 0;
+}
+
+
+/**
+ * @brief Add a transaction to a batch
+ */
+int spis_batchAdd(spis_batch_t *batch, const void *tx, void *rx, size_t len)
+{
+    if (batch->count >= CONFIG_SPISTREAM_BATCH_MAX)
+    {
+        return -ENOMEM;
+    }
+    batch->tx[batch->count].buf = (void *)tx;                           // NULL: SPIM clocks out the ORC fill byte
+    batch->tx[batch->count].len = len;
+    batch->rx[batch->count].buf = rx;
+    batch->rx[batch->count].len = len;
+    batch->count++;
+    return 0;
+}
+
+
+/**
+ * @brief Run a batch under one CS assertion and wait for it to complete
+ */
+int spis_batchRun(spis_batch_t *batch)
+{
+    const struct spi_buf_set txSet = { .buffers = batch->tx, .count = batch->count };
+    const struct spi_buf_set rxSet = { .buffers = batch->rx, .count = batch->count };
+    uint32_t start;
+    size_t bytes = 0;
+    int ret;
+
+    if (spis.running)
+    {
+        return -EBUSY;
+    }
+    if (batch->count == 0)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        bytes += batch->tx[i].len;
+    }
+
+    start = k_cycle_get_32();
+    ret = spi_transceive(spis_dev, &spis_spiConfig, &txSet, &rxSet);    // one CS assertion, one EasyDMA list per segment
+    statsTransfer(start, bytes, ret);
+
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);
+    spis.stats.batches++;
+    spis.stats.transactions += batch->count;
+    k_spin_unlock(&spis.lock, key);
+    return ret;
+}
+
+
+/**
+ * @brief Get a snapshot of the transfer counters
+ */
+void spis_getStats(spis_stats_t *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);
+
+    *stats = spis.stats;
+    k_spin_unlock(&spis.lock, key);
+
+    stats->elapsedUs = k_cyc_to_us_floor32(k_cycle_get_32() - spis.windowStart);
+    stats->throughputBps = (stats->elapsedUs > 0) ? (uint32_t)(((uint64_t)stats->bytes * 1000000U) / stats->elapsedUs) : 0;
+}
+
+
+/**
+ * @brief Restart the statistics window
+ */
+void spis_resetStats(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);
+
+    memset(&spis.stats, 0, sizeof(spis.stats));
+    spis.windowStart = k_cycle_get_32();
+    k_spin_unlock(&spis.lock, key);
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Start the next block into the free buffer (system workqueue)
+ *
+ * @param work Stream work item
+ */
+static void streamNext(struct k_work *work)
+{
+    const struct spi_buf_set txSet = { .buffers = &spis.txBuf, .count = (spis.config.cmdLen > 0) ? 1 : 0 };
+    const struct spi_buf_set rxSet = { .buffers = &spis.rxBuf[(spis.config.cmdLen > 0) ? 0 : 1], .count = (spis.config.cmdLen > 0) ? 2 : 1 };
+    uint8_t idx;
+    int ret;
+
+    ARG_UNUSED(work);
+
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);
+    if (!spis.running || spis.busy)
+    {
+        k_spin_unlock(&spis.lock, key);
+        return;
+    }
+    idx = spis.fillIdx;
+    if (atomic_test_bit(&spis.held, idx))
+    {
+        if (!spis.stalled)
+        {
+            spis.stalled = true;                                            // resumed by spis_streamRelease()
+            spis.stats.stalls++;
+        }
+        k_spin_unlock(&spis.lock, key);
+        return;
+    }
+    spis.stalled = false;
+    spis.busy = true;
+    k_spin_unlock(&spis.lock, key);
+
+    spis.rxBuf[1].buf = spis_dmaBuf[idx];
+    spis.startCycles = k_cycle_get_32();
+    ret = spi_transceive_cb(spis_dev, &spis_spiConfig, &txSet, &rxSet, streamDone, NULL);
+    if (ret != 0)
+    {
+        LOG_ERR("Stream transfer failed to start, err=%d, stream stopped", ret);
+        key = k_spin_lock(&spis.lock);
+        spis.busy = false;
+        spis.running = false;
+        spis.stats.errors++;
+        k_spin_unlock(&spis.lock, key);
+    }
+}
+
+
+/**
+ * @brief Block transfer complete: hand the block to the consumer, queue the next (SPI interrupt)
+ */
+static void streamDone(const struct device *dev, int result, void *userData)
+{
+    uint8_t idx;
+
+    ARG_UNUSED(dev);
+    ARG_UNUSED(userData);
+
+    statsTransfer(spis.startCycles, spis.config.cmdLen + spis.config.blockLen, result);
+
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);
+    idx = spis.fillIdx;
+    spis.busy = false;
+    if (result == 0)
+    {
+        atomic_set_bit(&spis.held, idx);
+        (void)k_msgq_put(&spis_ready, &idx, K_NO_WAIT);                 // can't fail: at most two blocks held
+        spis.fillIdx = idx ^ 1;
+        spis.stats.blocks++;
+    }
+    if (spis.running)
+    {
+        k_work_submit(&spis.nextWork);
+    }
+    else
+    {
+        k_sem_give(&spis.idle);
+    }
+    k_spin_unlock(&spis.lock, key);
+}
+
+
+/**
+ * @brief Add a transfer to the statistics
+ *
+ * @param startCycles Cycle count at transfer start
+ * @param bytes Bytes clocked
+ * @param result Transfer result
+ */
+static void statsTransfer(uint32_t startCycles, size_t bytes, int result)
+{
+    uint32_t busyUs = k_cyc_to_us_floor32(k_cycle_get_32() - startCycles);
+    k_spinlock_key_t key = k_spin_lock(&spis.lock);
+
+    spis.stats.busyUs += busyUs;
+    if (result == 0)
+    {
+        spis.stats.bytes += bytes;
+    }
+    else
+    {
+        spis.stats.errors++;
+    }
+    k_spin_unlock(&spis.lock, key);
+}
+
+
+static int spis_init(void)
+{
+    spis_resetStats();
+    return 0;
+}
+
+SYS_INIT(spis_init, APPLICATION, 0);
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SUPPLY_MON
+#define SUPPLY_MON
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+
+/* Supply/battery voltage monitor (SAADC channel labeled "supply", VDD on the MTC2 board)
+ *
+ * Samples are not read one at a time: each batch is a single ADC sequence of
+ * CONFIG_SUPPLYMON_BATCH samplings spaced CONFIG_SUPPLYMON_INTERVAL_MS apart, every sampling hardware
+ * oversampled (channel zephyr,oversampling, averaged in the SAADC), written by EasyDMA into a static
+ * buffer. The sampling timer and conversions are handled by the ADC driver, the monitor thread
+ * sleeps for the whole batch and wakes once to reduce it to a summary.
+ *
+ * The ADC driver stays locked for a sequence, so a batch spanning more than
+ * CONFIG_SUPPLYMON_ADC_HOLD_MAX_MS is read as several shorter sequences (one wakeup each) to let
+ * other ADC users in between.
+ *
+ * Summaries (min/avg/max of the batch, and a trend following the batch averages) go to a
+ * registered callback and are kept for smon_getSummary().
+ */
+
+/* Batch summary, millivolts at the monitored supply (see CONFIG_SUPPLYMON_SCALE_PERMILLE)
+ */
+typedef struct _smon_summary
+{
+    int32_t minMv;
+    int32_t avgMv;
+    int32_t maxMv;
+    int32_t trendMv;                                    // filtered batch averages, see CONFIG_SUPPLYMON_FILTER_SHIFT
+    uint16_t samples;                                   // samplings in the batch
+    uint32_t batch;                                     // batch number since start, 1=first
+} smon_summary_t;
+
+/**
+ * @brief Summary notification
+ *
+ * @param summary Batch summary (valid during the call)
+ * @param userData Context given to smon_setCallback()
+ *
+ * @note Called from the monitor thread.
+ */
+typedef void (*smon_callback_t)(const smon_summary_t *summary, void *userData);
+
+/* Monitor counters since boot or smon_resetStats()
+ */
+typedef struct _smon_stats
+{
+    uint32_t batches;                                   // summaries delivered
+    uint32_t samples;                                   // samplings converted (each oversampled in hardware)
+    uint32_t wakeups;                                   // monitor thread wakeups, one per ADC sequence
+    uint32_t errors;                                    // failed sequences
+} smon_stats_t;
+
+
+/**
+ * @brief Start monitoring (started at boot with CONFIG_SUPPLYMON_AUTOSTART)
+ *
+ * @return int 0=started, -EALREADY running, -ENODEV ADC not ready, else ADC channel setup error
+ */
+int smon_start(void);
+
+
+/**
+ * @brief Stop monitoring after the batch in progress
+ */
+void smon_stop(void);
+
+
+/**
+ * @brief Register the function receiving each summary
+ *
+ * @param callback Function to call, NULL to remove
+ * @param userData Context passed to callback
+ */
+void smon_setCallback(smon_callback_t callback, void *userData);
+
+
+/**
+ * @brief Get the latest summary
+ *
+ * @param summary Returns the summary
+ * @return int 0=success, -ENODATA no batch completed yet
+ */
+int smon_getSummary(smon_summary_t *summary);
+
+
+/**
+ * @brief Get a snapshot of the monitor counters
+ *
+ * @param stats Returns counters
+ */
+void smon_getStats(smon_stats_t *stats);
+
+
+/**
+ * @brief Clear the monitor counters
+ */
+void smon_resetStats(void);
+
+#endif
@@ -0,0 +1,319 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/adc.h>
+#include <zephyr/sys/atomic.h>
+
+#include "supply-mon.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(smon, CONFIG_SUPPLYMON_LOG_LEVEL);
+
+#define SMON_SEQ_SAMPLES MIN(CONFIG_SUPPLYMON_BATCH, CONFIG_SUPPLYMON_ADC_HOLD_MAX_MS / CONFIG_SUPPLYMON_INTERVAL_MS + 1)
+
+static const struct adc_dt_spec smon_adc = ADC_DT_SPEC_STRUCT(DT_PARENT(DT_NODELABEL(supply)), DT_REG_ADDR(DT_NODELABEL(supply)));
+
+static int16_t smon_buf[CONFIG_SUPPLYMON_BATCH];                               // one batch, EasyDMA target
+K_THREAD_STACK_DEFINE(smon_stack, CONFIG_SUPPLYMON_STACK_SIZE);
+static K_SEM_DEFINE(smon_go, 0, 1);                                             // wakes the stopped monitor thread
+
+static struct adc_sequence_options smon_options =
+{
+    .interval_us = CONFIG_SUPPLYMON_INTERVAL_MS * USEC_PER_MSEC,
+    .extra_samplings = SMON_SEQ_SAMPLES - 1,                                    // set per sequence, see readBatch()
+};
+
+static struct
+{
+    struct k_spinlock lock;                             // guards callback, summary and statistics
+    struct adc_sequence sequence;
+    struct k_thread thread;
+    atomic_t running;
+    bool channelReady;
+    bool haveSummary;
+    smon_callback_t callback;
+    void *userData;
+    smon_summary_t summary;
+    smon_stats_t stats;
+} smon;
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+static void smon_run(void *p1, void *p2, void *p3);                             // monitor thread
+static int readBatch(void);                                                     // batch in ADC sequences of SMON_SEQ_SAMPLES
+static void summarize(uint32_t batch, smon_summary_t *summary);
+static int32_t toMillivolts(int32_t raw);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Start monitoring
+ */
+int smon_start(void)
+{
+    int ret;
+
+    if (!adc_is_ready_dt(&smon_adc))
+    {
+        return -ENODEV;
+    }
+    if (!smon.channelReady)
+    {
+        ret = adc_channel_setup_dt(&smon_adc);
+        if (ret != 0)
+        {
+            LOG_ERR("Supply channel setup failed, err=%d", ret);
+            return ret;
+        }
+        smon.channelReady = true;
+    }
+    if (!atomic_cas(&smon.running, 0, 1))
+    {
+        return -EALREADY;
+    }
+    k_sem_give(&smon_go);
+    return 0;
+}
+
+
+/**
+ * @brief Stop monitoring after the batch in progress
+ */
+void smon_stop(void)
+{
+    atomic_clear(&smon.running);
+}
+
+
+/**
+ * @brief Register the function receiving each summary
+ */
+void smon_setCallback(smon_callback_t callback, void *userData)
+{
+    k_spinlock_key_t key = k_spin_lock(&smon.lock);
+
+    smon.callback = callback;
+    smon.userData = userData;
+    k_spin_unlock(&smon.lock, key);
+}
+
+
+/**
+ * @brief Get the latest summary
+ */
+int smon_getSummary(smon_summary_t *summary)
+{
+    int ret = -ENODATA;
+    k_spinlock_key_t key = k_spin_lock(&smon.lock);
+
+    if (smon.haveSummary)
+    {
+        *summary = smon.summary;
+        ret = 0;
+    }
+    k_spin_unlock(&smon.lock, key);
+    return ret;
+}
+
+
+/**
+ * @brief Get a snapshot of the monitor counters
+ */
+void smon_getStats(smon_stats_t *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&smon.lock);
+
+    *stats = smon.stats;
+    k_spin_unlock(&smon.lock, key);
+}
+
+
+/**
+ * @brief Clear the monitor counters
+ */
+void smon_resetStats(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&smon.lock);
+
+    memset(&smon.stats, 0, sizeof(smon.stats));
+    k_spin_unlock(&smon.lock, key);
+}
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Monitor thread: one batch per loop (one ADC sequence with the defaults), summary to the consumer
+ */
+static void smon_run(void *p1, void *p2, void *p3)
+{
+    smon_summary_t summary;
+    smon_callback_t callback;
+    void *userData;
+    uint32_t batch = 0;
+    int ret;
+
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (1)
+    {
+        if (!atomic_get(&smon.running))
+        {
+            k_sem_take(&smon_go, K_FOREVER);
+            batch = 0;                                                          // trend restarts with the next batch
+            continue;
+        }
+
+        ret = readBatch();
+        if (ret != 0)
+        {
+            LOG_ERR("Supply sampling failed, err=%d", ret);
+            k_sleep(K_MSEC(CONFIG_SUPPLYMON_INTERVAL_MS));
+            continue;
+        }
+
+        summarize(++batch, &summary);
+
+        k_spinlock_key_t key = k_spin_lock(&smon.lock);
+        smon.summary = summary;
+        smon.haveSummary = true;
+        smon.stats.batches++;
+        smon.stats.samples += summary.samples;
+        callback = smon.callback;
+        userData = smon.userData;
+        k_spin_unlock(&smon.lock, key);
+
+        LOG_DBG("Supply %d/%d/%d mV, trend %d mV", summary.minMv, summary.avgMv, summary.maxMv, summary.trendMv);
+        if (callback != NULL)
+        {
+            callback(&summary, userData);
+        }
+    }
+}
+
+
+/**
+ * @brief Take a batch into the buffer, in ADC sequences of at most SMON_SEQ_SAMPLES samplings
+ *
+ * The ADC driver is locked for the length of a sequence, other ADC users wait for it. A batch
+ * longer than CONFIG_SUPPLYMON_ADC_HOLD_MAX_MS is split, the thread sleeps between sequences with
+ * the ADC free and the next sequence keeps the sampling interval.
+ *
+ * @return int 0=success, else ADC error of the failed sequence
+ */
+static int readBatch(void)
+{
+    int64_t startMs = k_uptime_get();
+    size_t done = 0;
+    int ret = 0;
+
+    while (done < CONFIG_SUPPLYMON_BATCH && ret == 0)
+    {
+        size_t count = MIN(SMON_SEQ_SAMPLES, CONFIG_SUPPLYMON_BATCH - done);
+
+        if (done > 0)
+        {
+            k_sleep(K_TIMEOUT_ABS_MS(startMs + done * CONFIG_SUPPLYMON_INTERVAL_MS));   // next sampling time
+        }
+        smon_options.extra_samplings = count - 1;
+        smon.sequence.buffer = &smon_buf[done];
+        smon.sequence.buffer_size = count * sizeof(smon_buf[0]);
+        ret = adc_read_dt(&smon_adc, &smon.sequence);                           // sleeps through the sequence (driver timer and ISR)
+
+        k_spinlock_key_t key = k_spin_lock(&smon.lock);
+        smon.stats.wakeups++;
+        if (ret != 0)
+        {
+            smon.stats.errors++;
+        }
+        k_spin_unlock(&smon.lock, key);
+        done += count;
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Reduce the batch buffer to min/avg/max, update the trend
+ *
+ * Done on raw values, only the three results are converted (conversion is linear).
+ *
+ * @param batch Batch number, 1=first since start (seeds the trend)
+ * @param summary Returns the summary
+ */
+static void summarize(uint32_t batch, smon_summary_t *summary)
+{
+    int32_t minRaw = INT16_MAX;
+    int32_t maxRaw = INT16_MIN;
+    int32_t sum = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(smon_buf); i++)
+    {
+        minRaw = MIN(minRaw, smon_buf[i]);
+        maxRaw = MAX(maxRaw, smon_buf[i]);
+        sum += smon_buf[i];
+    }
+
+    summary->minMv = toMillivolts(minRaw);
+    summary->maxMv = toMillivolts(maxRaw);
+    summary->avgMv = toMillivolts(sum / (int32_t)ARRAY_SIZE(smon_buf));
+    summary->trendMv = (batch == 1) ? summary->avgMv :
+                       smon.summary.trendMv + (summary->avgMv - smon.summary.trendMv) / (1 << CONFIG_SUPPLYMON_FILTER_SHIFT);
+    summary->samples = ARRAY_SIZE(smon_buf);
+    summary->batch = batch;
+}
+
+
+/**
+ * @brief Convert a raw sample to millivolts at the monitored supply
+ *
+ * @param raw ADC result
+ * @return int32_t Millivolts, scaled by CONFIG_SUPPLYMON_SCALE_PERMILLE
+ */
+static int32_t toMillivolts(int32_t raw)
+{
+    int32_t mv = MAX(raw, 0);                                                   // single ended results can dip below 0
+
+    (void)adc_raw_to_millivolts_dt(&smon_adc, &mv);
+    return (int32_t)(((int64_t)mv * CONFIG_SUPPLYMON_SCALE_PERMILLE) / 1000);
+}
+
+
+static int smon_init(void)
+{
+    int ret = adc_sequence_init_dt(&smon_adc, &smon.sequence);                 // channel, resolution and oversampling from devicetree
+
+    if (ret != 0)
+    {
+        return ret;
+    }
+    smon.sequence.options = &smon_options;                                     // buffer set per sequence
+
+    k_thread_create(&smon.thread, smon_stack, K_THREAD_STACK_SIZEOF(smon_stack), smon_run,
+                    NULL, NULL, NULL, CONFIG_SUPPLYMON_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&smon.thread, "smon");
+
+#if defined(CONFIG_SUPPLYMON_AUTOSTART)
+    ret = smon_start();
+    if (ret != 0)
+    {
+        LOG_ERR("Supply monitor not started, err=%d", ret);
+    }
+#endif
+    return 0;
+}
+
+SYS_INIT(smon_init, APPLICATION, 0);
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TRACE_PINS
+#define TRACE_PINS
+
+#include <stdint.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util_macro.h>
+#if defined(CONFIG_TRACEPINS_NRF)
+#include <hal/nrf_gpio.h>
+#endif
+
+
+/* Trace pin markers
+ *
+ * Markers name a trace point, the "loouq,trace-pins" devicetree node assigns pins to the points of
+ * interest (child node per point, node name = marker name). Bracket a hot path with
+ *
+ *   TPIN_ON(rgbi_handler);
+ *   ...
+ *   TPIN_OFF(rgbi_handler);
+ *
+ * With CONFIG_TRACEPINS_NRF a marker is one OUTSET/OUTCLR register store, the pin is resolved at
+ * build time (no table, no call). Otherwise the GPIO driver is called, with CONFIG_TRACEPINS_RECORD
+ * (native_sim) every edge is also recorded to a timeline file. Markers without a pin assigned, and
+ * all markers without CONFIG_TRACEPINS, compile to nothing. Markers are safe in ISRs. Levels are
+ * raw, TPIN_TOGGLE is a read-modify-write and must not race other markers on the same pin.
+ */
+
+#define TPIN_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(loouq_trace_pins)
+#define TPIN_POINT(_name) DT_CHILD(TPIN_NODE, _name)
+
+/**
+ * @brief Trace point has a pin assigned (1) or not (0), usable in #if and COND_CODE_1
+ */
+#define TPIN_EXISTS(_name) DT_NODE_EXISTS(TPIN_POINT(_name))
+
+#define TPIN_ON(_name) TPIN_OP(_name, set)
+#define TPIN_OFF(_name) TPIN_OP(_name, clear)
+#define TPIN_TOGGLE(_name) TPIN_OP(_name, toggle)
+
+#if defined(CONFIG_TRACEPINS)
+#define TPIN_OP(_name, _op) COND_CODE_1(TPIN_EXISTS(_name), (TPIN_DRIVE(TPIN_POINT(_name), _op)), ((void)0))
+#else
+#define TPIN_OP(_name, _op) ((void)0)
+#endif
+
+#if defined(CONFIG_TRACEPINS_NRF)
+#define TPIN_NRF_PIN(_node) NRF_GPIO_PIN_MAP(DT_PROP(DT_GPIO_CTLR(_node, gpios), port), DT_GPIO_PIN(_node, gpios))
+#define TPIN_DRIVE(_node, _op) nrf_gpio_pin_##_op(TPIN_NRF_PIN(_node))
+#else
+#define TPIN_LEVEL_set 1
+#define TPIN_LEVEL_clear 0
+#define TPIN_LEVEL_toggle -1
+#define TPIN_DRIVE(_node, _op) tpin_drive(DT_NODE_CHILD_IDX(_node), TPIN_LEVEL_##_op)
+
+/**
+ * @brief Drive a trace pin through the GPIO driver (marker backend, use the TPIN_ macros)
+ *
+ * @param index Trace point (child index of the trace pins node)
+ * @param level 1=on, 0=off, -1=toggle
+ */
+void tpin_drive(uint8_t index, int level);
+#endif
+
+
+#if defined(CONFIG_TRACEPINS_RECORD)
+/**
+ * @brief Write recorded edges to the timeline file now (also done when the buffer fills and at exit)
+ */
+void tpin_flush(void);
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "trace-pins-native.h"
+
+
+int tpin_nativeOpen(const char *path)
+{
+    return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+
+void tpin_nativeWrite(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t written = write(fd, data, len);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;                                                             // timeline is best effort
+        }
+        data += written;
+        len -= (size_t)written;
+    }
+}
+
+
+void tpin_nativeClose(int fd)
+{
+    (void)close(fd);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TRACE_PINS_NATIVE
+#define TRACE_PINS_NATIVE
+
+#include <stddef.h>
+
+/* Host side of the native_sim edge recorder (built into the native_simulator runner, host libc).
+ * Embedded code has no host file access, these are the only calls crossing over.
+ */
+
+/**
+ * @brief Create (truncate) the timeline file
+ *
+ * @param path File path, relative to the working directory of the simulator
+ * @return int File descriptor, <0 on error
+ */
+int tpin_nativeOpen(const char *path);
+
+/**
+ * @brief Write to the timeline file
+ *
+ * @param fd File descriptor
+ * @param data Data
+ * @param len Data length
+ */
+void tpin_nativeWrite(int fd, const char *data, size_t len);
+
+/**
+ * @brief Close the timeline file
+ *
+ * @param fd File descriptor
+ */
+void tpin_nativeClose(int fd);
+
+#endif
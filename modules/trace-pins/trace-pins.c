@@ -0,0 +1,185 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#if defined(CONFIG_TRACEPINS_RECORD)
+#include <posix_native_task.h>
+#include "trace-pins-native.h"
+#endif
+
+#include "trace-pins.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(tpin, CONFIG_TRACEPINS_LOG_LEVEL);
+
+#define TPIN_SPEC(_node) GPIO_DT_SPEC_GET(_node, gpios)
+#define TPIN_NAME(_node) DT_NODE_FULL_NAME(_node)
+
+static const struct gpio_dt_spec tpin_pins[] = { DT_FOREACH_CHILD_SEP(TPIN_NODE, TPIN_SPEC, (,)) };
+
+#if !defined(CONFIG_TRACEPINS_NRF)
+static atomic_t tpin_levels;                                                    // bit per trace point, last level driven
+#endif
+
+#if defined(CONFIG_TRACEPINS_RECORD)
+static const char *const tpin_names[] = { DT_FOREACH_CHILD_SEP(TPIN_NODE, TPIN_NAME, (,)) };
+static char tpin_recBuf[CONFIG_TRACEPINS_RECORD_BUFFER];                       // formatted edges waiting for the file
+static size_t tpin_recLen;
+static int tpin_recFd = -1;
+static struct k_spinlock tpin_recLock;
+#endif
+
+BUILD_ASSERT(ARRAY_SIZE(tpin_pins) <= 32, "at most 32 trace points");
+
+
+/* Private service function declarations
+ * -------------------------------------------------------------------------------------------- */
+#if defined(CONFIG_TRACEPINS_RECORD)
+static void recordEdge(uint8_t index, int level);
+static void recordFlush(void);                                                  // tpin_recLock held
+static void recordExit(void);                                                   // native_sim exit
+#endif
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+#if !defined(CONFIG_TRACEPINS_NRF)
+/**
+ * @brief Drive a trace pin through the GPIO driver
+ */
+void tpin_drive(uint8_t index, int level)
+{
+    if (level < 0)
+    {
+        level = !(atomic_get(&tpin_levels) & BIT(index));
+    }
+    if (level)
+    {
+        atomic_or(&tpin_levels, BIT(index));
+    }
+    else
+    {
+        atomic_and(&tpin_levels, ~BIT(index));
+    }
+    (void)gpio_pin_set_raw(tpin_pins[index].port, tpin_pins[index].pin, level);
+#if defined(CONFIG_TRACEPINS_RECORD)
+    recordEdge(index, level);
+#endif
+}
+#endif
+
+
+#if defined(CONFIG_TRACEPINS_RECORD)
+/**
+ * @brief Write recorded edges to the timeline file now
+ */
+void tpin_flush(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&tpin_recLock);
+
+    recordFlush();
+    k_spin_unlock(&tpin_recLock, key);
+}
+#endif
+
+
+/* Private service functions definitions
+ * --------------------------------------------------------------------------------------------- */
+
+#if defined(CONFIG_TRACEPINS_RECORD)
+/**
+ * @brief Append an edge (time_ns,pin,level) to the timeline buffer
+ *
+ * @param index Trace point
+ * @param level Level driven
+ */
+static void recordEdge(uint8_t index, int level)
+{
+    uint64_t timeNs = k_cyc_to_ns_floor64(k_cycle_get_64());
+    k_spinlock_key_t key = k_spin_lock(&tpin_recLock);
+    int len;
+
+    if (sizeof(tpin_recBuf) - tpin_recLen < 64)
+    {
+        recordFlush();
+    }
+    len = snprintf(&tpin_recBuf[tpin_recLen], sizeof(tpin_recBuf) - tpin_recLen, "%llu,%s,%d\n",
+                   (unsigned long long)timeNs, tpin_names[index], level);
+    if (len > 0)
+    {
+        tpin_recLen += MIN((size_t)len, sizeof(tpin_recBuf) - tpin_recLen - 1);
+    }
+    k_spin_unlock(&tpin_recLock, key);
+}
+
+
+/**
+ * @brief Write the buffered edges to the host file (tpin_recLock held)
+ */
+static void recordFlush(void)
+{
+    if (tpin_recFd >= 0 && tpin_recLen > 0)
+    {
+        tpin_nativeWrite(tpin_recFd, tpin_recBuf, tpin_recLen);
+    }
+    tpin_recLen = 0;
+}
+
+
+/**
+ * @brief Write the edges left at exit and close the file
+ */
+static void recordExit(void)
+{
+    if (tpin_recFd >= 0)
+    {
+        recordFlush();
+        tpin_nativeClose(tpin_recFd);
+        tpin_recFd = -1;
+    }
+}
+
+NATIVE_TASK(recordExit, ON_EXIT, 100);
+#endif
+
+
+/**
+ * @brief Configure the trace pins as outputs, low
+ */
+static int tpin_init(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(tpin_pins); i++)
+    {
+        if (!gpio_is_ready_dt(&tpin_pins[i]) || gpio_pin_configure(tpin_pins[i].port, tpin_pins[i].pin, GPIO_OUTPUT_LOW) != 0)
+        {
+            LOG_ERR("Trace pin %zu not available", i);
+        }
+    }
+
+#if defined(CONFIG_TRACEPINS_RECORD)
+    tpin_recFd = tpin_nativeOpen(CONFIG_TRACEPINS_RECORD_FILE);
+    if (tpin_recFd < 0)
+    {
+        LOG_ERR("Trace pin timeline %s could not be created", CONFIG_TRACEPINS_RECORD_FILE);
+    }
+    else
+    {
+        static const char header[] = "time_ns,pin,level\n";
+
+        tpin_nativeWrite(tpin_recFd, header, sizeof(header) - 1);
+    }
+#endif
+    return 0;
+}
+
+SYS_INIT(tpin_init, PRE_KERNEL_2, 0);
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/i2c.h>
+
+#include "rgb-indicator.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+#define INDICATORS_MAX 32
+#define FLASH_ON_MS 50
+#define FLASH_OFF_MS 50
+#define FLASH_COUNT 10
+#define STAGGER_MS 1                                    // start offset between indicators, staggered cases
+#define POLL_MS 10
+
+typedef struct
+{
+    uint8_t indicators;
+    uint8_t staggerMs;
+    rgbi_schedStats_t sched;
+} benchCase_t;
+
+static const struct i2c_dt_spec rgbSpec = I2C_DT_SPEC_GET(DT_NODELABEL(rgbctrl));
+static rgb_indicator_t indicators[INDICATORS_MAX];      // all on the one emulated chip
+
+static benchCase_t cases[] =
+{
+    { .indicators = 1, .staggerMs = 0 },
+    { .indicators = 8, .staggerMs = 0 },
+    { .indicators = 8, .staggerMs = STAGGER_MS },
+    { .indicators = 32, .staggerMs = 0 },
+    { .indicators = 32, .staggerMs = STAGGER_MS },
+};
+
+
+static void runCase(benchCase_t *bench)
+{
+    struct led_rgb color = RGB(0, 64, 0);
+
+    rgbi_resetSchedStats();
+    for (uint8_t i = 0; i < bench->indicators; i++)
+    {
+        rgbi_flash(&indicators[i], &color, K_MSEC(FLASH_ON_MS), K_MSEC(FLASH_OFF_MS), FLASH_COUNT);
+        if (bench->staggerMs > 0)
+        {
+            k_msleep(bench->staggerMs);
+        }
+    }
+    for (uint8_t i = 0; i < bench->indicators; i++)
+    {
+        while (rgbi_isBusy(&indicators[i]))
+        {
+            k_msleep(POLL_MS);
+        }
+    }
+    rgbi_getSchedStats(&(bench->sched));
+}
+
+
+int main(void)
+{
+    size_t shared = sizeof(struct k_timer) + sizeof(struct k_work) + sizeof(sys_dlist_t) + sizeof(struct k_spinlock);
+
+    for (size_t i = 0; i < INDICATORS_MAX; i++)
+    {
+        if (rgbi_init(&rgbSpec, &indicators[i]) != 0 || rgbi_waitReady(&indicators[i], K_SECONDS(1)) != 0)
+        {
+            LOG_ERR("Indicator %zu init failed", i);
+            return 0;
+        }
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+    {
+        runCase(&cases[i]);
+    }
+
+    LOG_INF("Flash edges, %d x %d/%d ms flashes per indicator, coalescing window %d ms",
+            FLASH_COUNT, FLASH_ON_MS, FLASH_OFF_MS, CONFIG_RGBINDICATOR_SCHED_COALESCE_MS);
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+    {
+        const benchCase_t *bench = &cases[i];
+
+        LOG_INF("  %2u indicators, %-9s edges %4u, wakeups %4u (%u edges early), edges/wakeup %u.%02u",
+                bench->indicators, (bench->staggerMs > 0) ? "staggered" : "in step", bench->sched.edges,
+                bench->sched.wakeups, bench->sched.coalesced, bench->sched.edges / MAX(bench->sched.wakeups, 1),
+                (bench->sched.edges * 100 / MAX(bench->sched.wakeups, 1)) % 100);
+    }
+
+    LOG_INF("RAM: indicator %zu bytes, of which flash timer node %zu bytes (kernel timer %zu bytes)",
+            sizeof(rgb_indicator_t), sizeof(rgbi_timer_t), sizeof(struct k_timer));
+    LOG_INF("RAM: shared scheduler %zu bytes", shared);
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+    {
+        if (cases[i].staggerMs == 0)
+        {
+            size_t total = cases[i].indicators * sizeof(rgb_indicator_t) + shared;
+
+            LOG_INF("  %2u indicators: %zu bytes, %zu per indicator", cases[i].indicators, total, total / cases[i].indicators);
+        }
+    }
+    return 0;
+}
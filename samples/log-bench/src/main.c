@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+#define BURST_CALLS 32                                  // calls per case, fits the deferred log buffer
+#define DRAIN_SLEEP_MS 500                              // let the log output catch up between cases
+
+typedef struct
+{
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+} callCost_t;
+
+static const char *const caseNames[] = { "no args", "3 int args", "string arg" };
+
+
+static void record(callCost_t *cost, uint32_t cycles)
+{
+    cost->minCycles = MIN(cost->minCycles, cycles);
+    cost->maxCycles = MAX(cost->maxCycles, cycles);
+    cost->totalCycles += cycles;
+}
+
+
+static void runCase(size_t testCase, callCost_t *cost)
+{
+    uint32_t start;
+
+    cost->minCycles = UINT32_MAX;
+    cost->maxCycles = 0;
+    cost->totalCycles = 0;
+
+    for (int i = 0; i < BURST_CALLS; i++)
+    {
+        start = k_cycle_get_32();
+        switch (testCase)
+        {
+            case 0:
+                LOG_INF("bench message");
+                break;
+            case 1:
+                LOG_INF("bench %d %d %d", i, i * 2, i * 3);
+                break;
+            default:
+                LOG_INF("bench %s", caseNames[i % ARRAY_SIZE(caseNames)]);
+                break;
+        }
+        record(cost, k_cycle_get_32() - start);
+    }
+    k_msleep(DRAIN_SLEEP_MS);
+}
+
+
+int main(void)
+{
+    callCost_t costs[ARRAY_SIZE(caseNames)];
+
+    k_msleep(DRAIN_SLEEP_MS);                           // boot messages out of the way
+
+    for (size_t i = 0; i < ARRAY_SIZE(caseNames); i++)
+    {
+        runCase(i, &costs[i]);
+    }
+
+    LOG_INF("Log call cost, %s mode, %d calls per case (cycles @ %u Hz)",
+            IS_ENABLED(CONFIG_LOG_MODE_DEFERRED) ? "deferred" : "immediate", BURST_CALLS, sys_clock_hw_cycles_per_sec());
+    for (size_t i = 0; i < ARRAY_SIZE(caseNames); i++)
+    {
+        LOG_INF("  %-10s min %u, avg %u, max %u (avg %u ns)", caseNames[i], costs[i].minCycles,
+                (uint32_t)(costs[i].totalCycles / BURST_CALLS), costs[i].maxCycles,
+                (uint32_t)k_cyc_to_ns_floor64(costs[i].totalCycles / BURST_CALLS));
+    }
+    return 0;
+}
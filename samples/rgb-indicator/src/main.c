@@ -6,24 +6,22 @@
 
 #include <stdio.h>
 #include <zephyr/kernel.h>
-#include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/i2c.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(rgbi, LOG_LEVEL_INF);
 
 #include "rgb-indicator.h"
+#include "hx-handshake.h"
 
 #define LOOP_SLEEP_MS 1000
 #define COLOR_SLEEP_MS 500
+#define HX_RQST_LOOPS 10                                // loops between board requests to the host
+#define HX_ACK_TIMEOUT_MS 100
 
-#define HXRQST_NODE DT_NODELABEL(hxrqst)
-#define HXCTRL_NODE DT_NODELABEL(hxctrl)
 #define RGBCTRL_NODE DT_NODELABEL(rgbctrl)
 
-static const struct gpio_dt_spec hxrqst = GPIO_DT_SPEC_GET(HXRQST_NODE, gpios);
-static const struct gpio_dt_spec hxctrl = GPIO_DT_SPEC_GET(HXCTRL_NODE, gpios);
-static const struct i2c_dt_spec rgbctrl = I2C_DT_SPEC_GET(RGBCTRL_NODE);
+static const struct device *const rgbctrl = DEVICE_DT_GET(RGBCTRL_NODE);         // ti,lp5817 driver, initialized at boot
 
 // #define BMP_NODE DT_NODELABEL(bmp)
 // #define SHT_NODE DT_NODELABEL(sht)
@@ -53,18 +51,26 @@ static const struct led_rgb colors[] = {
     RGB(0, 0, 0)
 };
 
-rgb_indicator_t rgbi;
+static struct led_rgb hostColor = RGB(0, 100, 0);      /* green blink on host request */
+
+rgb_indicator_t *rgbi;
+
+static uint32_t uptimeUs(void)
+{
+    return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
 
 int main(void)
 {
     int ret;
     int loopcount = 0;
+    uint32_t mainUs = uptimeUs();                       // boot timing: indicator configuration runs in parallel with boot
+    uint32_t readyUs;
 
     printf("Hello %s, welcome to the IoT world and watch out for green flashes on the horizon! \r\n", CONFIG_BOARD_TARGET);
 
-    if (!gpio_is_ready_dt(&hxrqst) ||
-        !gpio_is_ready_dt(&hxctrl) ||
-        !device_is_ready(rgbctrl.bus) 
+    if (!device_is_ready(rgbctrl)
         // !device_is_ready(bmp_snsr.bus) ||
         // !device_is_ready(sht_snsr.bus)
        )
@@ -73,18 +79,12 @@ int main(void)
         return 0;
     }
 
-    ret  = gpio_pin_configure_dt(&hxrqst, GPIO_OUTPUT_ACTIVE) < 0 ? 1 : 0;
-    ret += gpio_pin_configure_dt(&hxctrl, GPIO_OUTPUT_ACTIVE) < 0 ? 1 : 0;
+    rgbi = rgbi_fromDevice(rgbctrl);
+    ret = rgbi_waitReady(rgbi, K_FOREVER);
+    readyUs = uptimeUs();
     if (ret != 0)
     {
-        LOG_ERR("Unable to configure I/O");
-        return 0;
-    }
-
-    ret = rgbi_init(&rgbctrl, &rgbi);
-    if (ret != 0)
-    {
-        printk("Failed to initalize the RGB indicator, err=%d\r\n", ret);
+        LOG_ERR("Indicator configuration failed, err=%d", ret);
     }
 
     // rgbi_setColor(&rgbi, &LED_OFF);
@@ -96,27 +96,32 @@ int main(void)
     // k_msleep(1000);
     // rgbi_setColor(&rgbi, &LED_OFF);
 
-    for (size_t i = 0; i < sizeof(colors)/3; i++)       // cycle through primary/secondary colors
+    for (size_t i = 0; i < ARRAY_SIZE(colors); i++)       // cycle through primary/secondary colors
     {
-        rgbi_setColor(&rgbi, &colors[i]);
+        rgbi_setColor(rgbi, &colors[i]);
+        if (i == 0)
+        {
+            LOG_INF("Boot timing: main %u us, indicator ready %u us, first color %u us", mainUs, readyUs, uptimeUs());
+        }
         k_msleep(COLOR_SLEEP_MS);
     }
 
     while (1)
     {
-        ret =  gpio_pin_toggle_dt(&hxrqst) < 0 ? 1 : 0;
-        ret += gpio_pin_toggle_dt(&hxctrl) < 0 ? 1 : 0;
-        if (ret != 0)
+        if (hxhs_waitHost(K_MSEC(LOOP_SLEEP_MS)) == 0)                   // idle until the host raises hxctrl (already acknowledged)
         {
-            LOG_ERR("I/O error on pin output");
-            return 0;
+            rgbi_flash(rgbi, &hostColor, K_MSEC(50), K_MSEC(50), 1);
+            LOG_INF("Host request");
+            continue;
         }
 
-         
-
         loopcount++;
-        printf("Loops: %d\n", loopcount);
-        k_msleep(LOOP_SLEEP_MS);
+        LOG_INF("Loops: %d", loopcount);
+        if (loopcount % HX_RQST_LOOPS == 0)
+        {
+            ret = hxhs_request(K_MSEC(HX_ACK_TIMEOUT_MS));
+            LOG_INF("Board request: %s", ret == 0 ? "acknowledged" : "no host response");
+        }
     }
     return 0;
 }
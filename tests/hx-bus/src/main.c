@@ -0,0 +1,449 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* HX bus scheduler on native_sim: write merge ordering against the LP5817 emulator, and a sensor
+ * read latency benchmark under continuous indicator flashing. The benchmark reads through the
+ * scheduler with CONFIG_RGBINDICATOR_HXBUS (loouq.hx_bus.scheduler) and straight from the I2C
+ * driver without it (loouq.hx_bus.direct), the indicator writes follow the same path. With
+ * CONFIG_RGBINDICATOR_ASYNC (loouq.hx_bus.async) the caller blocked time of the blocking and the
+ * posted color updates is compared, the emulated transfers take their bus time. The system
+ * workqueue latency under the same flashing is measured with the flash edges on the system
+ * workqueue and, with CONFIG_RGBINDICATOR_WORKQUEUE (loouq.hx_bus.direct.workqueue), on the
+ * indicator workqueue.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/emul.h>
+
+#include "hx-bus.h"
+#include "rgb-indicator.h"
+#include "emul_lp5817.h"
+
+#define BENCH_INDICATORS 8                              // flash edges of all indicators land together
+#define BENCH_MS 1000
+#define FLASH_MS 10
+#define SAMPLE_PERIOD_US 3100                           // drifts across the flash edges
+#define SENSOR_READ_LEN 6
+#define ASYNC_ROUNDS 32
+#define PROBE_PERIOD_US 1300                            // drifts across the flash edges
+
+static const struct i2c_dt_spec rgbSpec = I2C_DT_SPEC_GET(DT_NODELABEL(rgbctrl));
+static const struct i2c_dt_spec sensorSpec = I2C_DT_SPEC_GET(DT_NODELABEL(sensor));
+static const struct emul *lp5817 = EMUL_DT_GET(DT_NODELABEL(rgbctrl));
+static K_SEM_DEFINE(batchDone, 0, 1);
+
+static rgb_indicator_t indicators[BENCH_INDICATORS];
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+static rgb_indicator_t asyncRgbi;
+static atomic_t asyncDone;
+static atomic_t asyncErrors;
+#endif
+static int indicatorsResult;
+static volatile uint32_t sampleCycles;                  // sample timer expiry
+static uint32_t probeCycles;                            // probe timer expiry, probe work pending
+static uint32_t probeMaxUs;
+static uint64_t probeSumUs;
+static uint32_t probeRuns;
+
+static void sample_expiry(struct k_timer *timer);
+static K_TIMER_DEFINE(sampleTimer, sample_expiry, NULL);
+static void probe_handler(struct k_work *work);
+static K_WORK_DEFINE(probeWork, probe_handler);
+static void probe_expiry(struct k_timer *timer);
+static K_TIMER_DEFINE(probeTimer, probe_expiry, NULL);
+
+
+static void batchComplete(hxbus_xfer_t *xfer, int result, void *userData)
+{
+    ARG_UNUSED(xfer);
+    ARG_UNUSED(result);
+    ARG_UNUSED(userData);
+
+    k_sem_give(&batchDone);
+}
+
+
+/* Queue transactions together so the bus thread sees them in one dequeue, wait for the last
+ */
+static void runBatch(hxbus_xfer_t *xfers, size_t count)
+{
+    int ret = 0;
+
+    k_sched_lock();
+    for (size_t i = 0; i < count && ret == 0; i++)
+    {
+        ret = hxbus_submit(&xfers[i], K_FOREVER, (i == count - 1) ? batchComplete : NULL, NULL);
+    }
+    k_sched_unlock();
+    zassert_ok(ret, "submit failed");
+    zassert_ok(k_sem_take(&batchDone, K_SECONDS(1)), "batch did not complete");
+}
+
+
+ZTEST(hx_bus, test_merge_adjacent)
+{
+    const uint8_t vals[3] = { 1, 2, 3 };
+    hxbus_xfer_t xfers[3];
+    hxbus_stats_t stats;
+    emul_lp5817_stats_t bus;
+
+    for (size_t i = 0; i < ARRAY_SIZE(xfers); i++)
+    {
+        hxbus_initWrite(&xfers[i], rgbSpec.addr, LP5817_REG_INTENSITY0 + i, &vals[i], 1, HXBUS_PRIO_COSMETIC);
+    }
+    runBatch(xfers, ARRAY_SIZE(xfers));
+
+    hxbus_getStats(&stats);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(stats.merged, 2);
+    zassert_equal(bus.transactions, 1, "adjacent writes not sent as one burst");
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY2), 3);
+}
+
+
+ZTEST(hx_bus, test_merge_keeps_device_order)
+{
+    const uint8_t first = 1;
+    const uint8_t second = 2;
+    const uint8_t third[2] = { 3, 4 };
+    hxbus_xfer_t xfers[3];
+    hxbus_stats_t stats;
+
+    /* The third write extends the first but overlaps the second, merging it ahead of the second
+     * would leave the second's (older) value in INTENSITY2
+     */
+    hxbus_initWrite(&xfers[0], rgbSpec.addr, LP5817_REG_INTENSITY0, &first, 1, HXBUS_PRIO_COSMETIC);
+    hxbus_initWrite(&xfers[1], rgbSpec.addr, LP5817_REG_INTENSITY2, &second, 1, HXBUS_PRIO_COSMETIC);
+    hxbus_initWrite(&xfers[2], rgbSpec.addr, LP5817_REG_INTENSITY1, third, 2, HXBUS_PRIO_COSMETIC);
+    runBatch(xfers, ARRAY_SIZE(xfers));
+
+    hxbus_getStats(&stats);
+    zassert_equal(stats.merged, 0);
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY0), 1);
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY1), 3);
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY2), 4, "write merged ahead of an earlier overlapping write");
+}
+
+
+ZTEST(hx_bus, test_merge_not_past_read)
+{
+    const uint8_t first = 5;
+    const uint8_t second = 6;
+    uint8_t readBack[2] = { 0xff, 0xff };
+    hxbus_xfer_t xfers[3];
+    hxbus_stats_t stats;
+
+    hxbus_initWrite(&xfers[0], rgbSpec.addr, LP5817_REG_INTENSITY0, &first, 1, HXBUS_PRIO_COSMETIC);
+    hxbus_initRead(&xfers[1], rgbSpec.addr, LP5817_REG_INTENSITY0, readBack, sizeof(readBack), HXBUS_PRIO_COSMETIC);
+    hxbus_initWrite(&xfers[2], rgbSpec.addr, LP5817_REG_INTENSITY1, &second, 1, HXBUS_PRIO_COSMETIC);
+    runBatch(xfers, ARRAY_SIZE(xfers));
+
+    hxbus_getStats(&stats);
+    zassert_equal(stats.merged, 0);
+    zassert_equal(readBack[0], 5);
+    zassert_equal(readBack[1], 0, "write merged ahead of an earlier read");
+}
+
+
+ZTEST(hx_bus, test_merge_past_other_device)
+{
+    const uint8_t vals[3] = { 7, 8, 9 };
+    hxbus_xfer_t xfers[3];
+    hxbus_stats_t stats;
+
+    hxbus_initWrite(&xfers[0], rgbSpec.addr, LP5817_REG_INTENSITY0, &vals[0], 1, HXBUS_PRIO_COSMETIC);
+    hxbus_initWrite(&xfers[1], sensorSpec.addr, LP5817_REG_INTENSITY0, &vals[1], 1, HXBUS_PRIO_COSMETIC);
+    hxbus_initWrite(&xfers[2], rgbSpec.addr, LP5817_REG_INTENSITY1, &vals[2], 1, HXBUS_PRIO_COSMETIC);
+    runBatch(xfers, ARRAY_SIZE(xfers));
+
+    hxbus_getStats(&stats);
+    zassert_equal(stats.merged, 1, "other device's write stopped the merge");
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY1), 9);
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+static void asyncComplete(rgb_indicator_t *rgbi, int result, void *userData)
+{
+    ARG_UNUSED(rgbi);
+    ARG_UNUSED(userData);
+
+    atomic_inc(&asyncDone);
+    if (result != 0)
+    {
+        atomic_inc(&asyncErrors);
+    }
+}
+
+
+/* Caller blocked time of one color update, blocking or posted, the posted update is waited out
+ * before returning so each round starts on an idle bus
+ */
+static void timedUpdate(uint8_t level, bool posted, uint32_t *blockedUs)
+{
+    struct led_rgb color = RGB(level, 0, 0);
+    uint32_t start = k_cycle_get_32();
+
+    if (posted)
+    {
+        zassert_ok(rgbi_setColorAsync(&asyncRgbi, &color, asyncComplete, NULL));
+    }
+    else
+    {
+        zassert_ok(rgbi_setColor(&asyncRgbi, &color));
+    }
+    *blockedUs = k_cyc_to_us_ceil32(k_cycle_get_32() - start);
+
+    while (rgbi_isUpdating(&asyncRgbi))
+    {
+        k_msleep(1);
+    }
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY2), level, "red (OUT2) not written");
+}
+#endif
+
+
+ZTEST(hx_bus, test_async_caller_latency)
+{
+#if defined(CONFIG_RGBINDICATOR_ASYNC)
+    uint32_t syncMinUs = UINT32_MAX;
+    uint32_t syncMaxUs = 0;
+    uint64_t syncSumUs = 0;
+    uint32_t asyncMaxUs = 0;
+    uint64_t asyncSumUs = 0;
+    struct led_rgb flash = RGB(255, 255, 255);
+    struct led_rgb color = RGB(3, 0, 0);
+    emul_lp5817_stats_t bus;
+
+    zassert_ok(rgbi_init(&rgbSpec, &asyncRgbi));
+    zassert_ok(rgbi_waitReady(&asyncRgbi, K_SECONDS(1)));
+    atomic_clear(&asyncDone);
+    atomic_clear(&asyncErrors);
+    emul_lp5817_resetStats(lp5817);
+
+    for (int i = 0; i < ASYNC_ROUNDS; i++)
+    {
+        uint32_t us;
+
+        timedUpdate((uint8_t)(2 * i + 1), false, &us);
+        syncMinUs = MIN(syncMinUs, us);
+        syncMaxUs = MAX(syncMaxUs, us);
+        syncSumUs += us;
+
+        timedUpdate((uint8_t)(2 * i + 2), true, &us);
+        asyncMaxUs = MAX(asyncMaxUs, us);
+        asyncSumUs += us;
+    }
+    emul_lp5817_getStats(lp5817, &bus);
+
+    zassert_equal(atomic_get(&asyncDone), ASYNC_ROUNDS, "posted update not completed");
+    zassert_equal(atomic_get(&asyncErrors), 0);
+    zassert_equal(bus.transactions, 2 * ASYNC_ROUNDS);
+    zassert_true(asyncMaxUs < syncMinUs, "posted update blocked %u us, blocking update %u us", asyncMaxUs, syncMinUs);
+
+    rgbi_flash_continuous(&asyncRgbi, flash, K_MSEC(5), K_MSEC(5));
+    k_msleep(12);
+    zassert_ok(rgbi_setColorAsync(&asyncRgbi, &color, NULL, NULL));            // a command, replaces the flash
+    while (rgbi_isUpdating(&asyncRgbi))
+    {
+        k_msleep(1);
+    }
+    zassert_false(rgbi_isBusy(&asyncRgbi), "flash still running");
+    k_msleep(20);
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY2), color.r, "flash edge overwrote the posted color");
+
+    TC_PRINT("Caller blocked per color update, %u rounds, %u us bus time per update\n", ASYNC_ROUNDS,
+             (uint32_t)(bus.busTimeUs / bus.transactions));
+    TC_PRINT("  rgbi_setColor       avg %u us, min %u us, max %u us\n", (uint32_t)(syncSumUs / ASYNC_ROUNDS),
+             syncMinUs, syncMaxUs);
+    TC_PRINT("  rgbi_setColorAsync  avg %u us, max %u us\n", (uint32_t)(asyncSumUs / ASYNC_ROUNDS), asyncMaxUs);
+#else
+    ztest_test_skip();
+#endif
+}
+
+
+/* Start continuous flashing on all indicators (edges land together), or cancel it and let it end
+ */
+static void flashAll(bool start)
+{
+    struct led_rgb color = RGB(0, 0, 64);
+
+    for (size_t i = 0; i < BENCH_INDICATORS; i++)
+    {
+        if (start)
+        {
+            rgbi_flash_continuous(&indicators[i], color, K_MSEC(FLASH_MS), K_MSEC(FLASH_MS));
+        }
+        else
+        {
+            rgbi_cancel(&indicators[i]);
+        }
+    }
+    if (!start)
+    {
+        k_msleep(2 * FLASH_MS);
+    }
+}
+
+
+static void sample_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    sampleCycles = k_cycle_get_32();
+}
+
+
+static int sensorRead(uint8_t *buf)
+{
+#if defined(CONFIG_RGBINDICATOR_HXBUS)
+    hxbus_xfer_t xfer;
+
+    hxbus_initRead(&xfer, sensorSpec.addr, 0x00, buf, SENSOR_READ_LEN, HXBUS_PRIO_SENSOR);
+    return hxbus_transfer(&xfer, K_USEC(SAMPLE_PERIOD_US / 2));
+#else
+    return i2c_burst_read_dt(&sensorSpec, 0x00, buf, SENSOR_READ_LEN);
+#endif
+}
+
+
+ZTEST(hx_bus, test_sensor_jitter)
+{
+    uint8_t buf[SENSOR_READ_LEN];
+    uint32_t minUs = UINT32_MAX;
+    uint32_t maxUs = 0;
+    uint64_t sumUs = 0;
+    uint32_t samples = 0;
+    int64_t end;
+    emul_lp5817_stats_t bus;
+
+    zassert_ok(indicatorsResult, "indicators not initialized");
+    flashAll(true);
+    emul_lp5817_resetStats(lp5817);
+    hxbus_resetStats();
+
+    end = k_uptime_get() + BENCH_MS;
+    k_timer_start(&sampleTimer, K_USEC(SAMPLE_PERIOD_US), K_USEC(SAMPLE_PERIOD_US));
+    while (k_uptime_get() < end)
+    {
+        uint32_t us;
+
+        k_timer_status_sync(&sampleTimer);
+        zassert_ok(sensorRead(buf));
+        us = k_cyc_to_us_ceil32(k_cycle_get_32() - sampleCycles);
+        minUs = MIN(minUs, us);
+        maxUs = MAX(maxUs, us);
+        sumUs += us;
+        samples++;
+    }
+    k_timer_stop(&sampleTimer);
+    emul_lp5817_getStats(lp5817, &bus);
+    flashAll(false);
+
+    zassert_true(samples > 0);
+    TC_PRINT("Sensor read (%u bytes) every %u us, %u indicators flashing %u/%u ms, %s\n", SENSOR_READ_LEN,
+             SAMPLE_PERIOD_US, BENCH_INDICATORS, FLASH_MS, FLASH_MS,
+             IS_ENABLED(CONFIG_RGBINDICATOR_HXBUS) ? "HX bus scheduler" : "direct I2C");
+    TC_PRINT("  %u samples, latency min %u us, avg %u us, max %u us, jitter %u us\n", samples, minUs,
+             (uint32_t)(sumUs / samples), maxUs, maxUs - minUs);
+    TC_PRINT("  indicator writes %u, indicator bus time %u us in %u ms\n", bus.transactions,
+             (uint32_t)bus.busTimeUs, BENCH_MS);
+#if defined(CONFIG_RGBINDICATOR_HXBUS)
+    hxbus_stats_t stats;
+
+    hxbus_getStats(&stats);
+    TC_PRINT("  HX bus utilization %u%%, sensor wait %u-%u us, merged writes %u\n",
+             (uint32_t)((uint64_t)stats.busyUs * 100 / MAX(stats.elapsedUs, 1)),
+             stats.waitMinUs[HXBUS_PRIO_SENSOR], stats.waitMaxUs[HXBUS_PRIO_SENSOR], stats.merged);
+#endif
+}
+
+
+static void probe_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    if (k_work_submit(&probeWork) == 1)                                     // not already pending
+    {
+        probeCycles = k_cycle_get_32();
+    }
+}
+
+
+static void probe_handler(struct k_work *work)
+{
+    uint32_t us = k_cyc_to_us_ceil32(k_cycle_get_32() - probeCycles);
+
+    ARG_UNUSED(work);
+    probeMaxUs = MAX(probeMaxUs, us);
+    probeSumUs += us;
+    probeRuns++;
+}
+
+
+ZTEST(hx_bus, test_syswq_latency)
+{
+    emul_lp5817_stats_t bus;
+    struct k_work_sync sync;
+    uint32_t edgeBusUs;
+
+    zassert_ok(indicatorsResult, "indicators not initialized");
+    probeMaxUs = 0;
+    probeSumUs = 0;
+    probeRuns = 0;
+    flashAll(true);
+    emul_lp5817_resetStats(lp5817);
+
+    k_timer_start(&probeTimer, K_USEC(PROBE_PERIOD_US), K_USEC(PROBE_PERIOD_US));
+    k_msleep(BENCH_MS);
+    k_timer_stop(&probeTimer);
+    emul_lp5817_getStats(lp5817, &bus);
+    flashAll(false);
+    (void)k_work_flush(&probeWork, &sync);
+
+    zassert_true(probeRuns > 0 && bus.transactions > 0);
+    edgeBusUs = (uint32_t)(bus.busTimeUs / bus.transactions);
+    TC_PRINT("System workqueue latency, %u indicators flashing %u/%u ms on the %s workqueue\n", BENCH_INDICATORS,
+             FLASH_MS, FLASH_MS, IS_ENABLED(CONFIG_RGBINDICATOR_WORKQUEUE) ? "indicator" : "system");
+    TC_PRINT("  %u probes, latency avg %u us, max %u us, indicator write %u us bus time\n", probeRuns,
+             (uint32_t)(probeSumUs / probeRuns), probeMaxUs, edgeBusUs);
+#if defined(CONFIG_RGBINDICATOR_WORKQUEUE) && !defined(CONFIG_RGBINDICATOR_HXBUS)
+    zassert_true(probeMaxUs <= edgeBusUs, "system work waited %u us, longer than one indicator write", probeMaxUs);
+#endif
+}
+
+
+static void *setup(void)
+{
+    for (size_t i = 0; i < BENCH_INDICATORS && indicatorsResult == 0; i++)
+    {
+        indicatorsResult = rgbi_init(&rgbSpec, &indicators[i]);
+        if (indicatorsResult == 0)
+        {
+            indicatorsResult = rgbi_waitReady(&indicators[i], K_SECONDS(1));
+        }
+    }
+    return NULL;
+}
+
+
+static void before(void *fixture)
+{
+    const uint8_t off[3] = { 0, 0, 0 };
+    hxbus_xfer_t xfer;
+
+    ARG_UNUSED(fixture);
+
+    hxbus_initWrite(&xfer, rgbSpec.addr, LP5817_REG_INTENSITY0, off, sizeof(off), HXBUS_PRIO_COSMETIC);
+    (void)hxbus_transfer(&xfer, K_FOREVER);
+    emul_lp5817_resetStats(lp5817);
+    hxbus_resetStats();
+}
+
+ZTEST_SUITE(hx_bus, NULL, setup, before, NULL, NULL);
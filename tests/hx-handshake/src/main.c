@@ -0,0 +1,140 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* HX handshake on the native_sim GPIO emulator, the test drives HXCTRL as the host and reads
+ * HXRQST back. Emulated edges call the GPIO callback synchronously, so the level read right after
+ * gpio_emul_input_set() shows what the edge interrupt did.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+
+#include "hx-handshake.h"
+
+#define HOST_ACK_DELAY_MS 5                             // host side acknowledge delay, board request cases
+
+static const struct gpio_dt_spec rqst = GPIO_DT_SPEC_GET(DT_NODELABEL(hxrqst), gpios);
+static const struct gpio_dt_spec ctrl = GPIO_DT_SPEC_GET(DT_NODELABEL(hxctrl), gpios);
+
+static void hostAck_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(hostAck, hostAck_handler);
+static int rqstAtAck;                                   // HXRQST seen by the host before it acknowledged
+static int rqstAfterAck;                                // HXRQST once the acknowledge edge was taken
+static atomic_t callbacks;
+
+
+static void hostAck_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    rqstAtAck = gpio_emul_output_get(rqst.port, rqst.pin);
+    (void)gpio_emul_input_set(ctrl.port, ctrl.pin, 1);                      // acknowledge
+    rqstAfterAck = gpio_emul_output_get(rqst.port, rqst.pin);
+    (void)gpio_emul_input_set(ctrl.port, ctrl.pin, 0);                      // release, completes the request
+}
+
+
+static void hostCallback(void *userData)
+{
+    atomic_inc((atomic_t *)userData);
+}
+
+
+ZTEST(hx_handshake, test_host_request)
+{
+    hxhs_stats_t stats;
+    uint32_t start;
+    uint32_t ackCycles;
+
+    start = k_cycle_get_32();
+    zassert_ok(gpio_emul_input_set(ctrl.port, ctrl.pin, 1));
+    ackCycles = k_cycle_get_32() - start;
+
+    zassert_equal(gpio_emul_output_get(rqst.port, rqst.pin), 1, "host request not acknowledged");
+    zassert_true(hxhs_hostAsserted());
+    zassert_ok(hxhs_waitHost(K_NO_WAIT), "waiting thread not released");
+
+    zassert_ok(gpio_emul_input_set(ctrl.port, ctrl.pin, 0));
+    zassert_equal(gpio_emul_output_get(rqst.port, rqst.pin), 0, "acknowledge not released");
+
+    hxhs_getStats(&stats);
+    zassert_equal(stats.hostRequests, 1);
+    TC_PRINT("Host request to acknowledge: %u us\n", k_cyc_to_us_ceil32(ackCycles));
+}
+
+
+ZTEST(hx_handshake, test_host_callback)
+{
+    hxhs_setHostCallback(hostCallback, &callbacks);
+
+    zassert_ok(gpio_emul_input_set(ctrl.port, ctrl.pin, 1));
+    zassert_ok(gpio_emul_input_set(ctrl.port, ctrl.pin, 0));
+    zassert_ok(gpio_emul_input_set(ctrl.port, ctrl.pin, 1));
+    zassert_ok(gpio_emul_input_set(ctrl.port, ctrl.pin, 0));
+
+    zassert_equal(atomic_get(&callbacks), 2, "one notification per host request");
+    zassert_ok(hxhs_waitHost(K_NO_WAIT));
+    zassert_ok(hxhs_waitHost(K_NO_WAIT), "requests without a waiting thread are counted");
+}
+
+
+ZTEST(hx_handshake, test_board_request)
+{
+    hxhs_stats_t stats;
+
+    zassert_true(k_work_schedule(&hostAck, K_MSEC(HOST_ACK_DELAY_MS)) >= 0);
+    zassert_ok(hxhs_request(K_MSEC(100)));
+
+    zassert_equal(rqstAtAck, 1, "HXRQST not asserted for the request");
+    zassert_equal(rqstAfterAck, 0, "HXRQST not released on the acknowledge edge");
+    zassert_equal(gpio_emul_output_get(rqst.port, rqst.pin), 0);
+
+    hxhs_getStats(&stats);
+    zassert_equal(stats.boardRequests, 1);
+    zassert_equal(stats.timeouts, 0);
+    zassert_true(stats.ackLastUs >= (HOST_ACK_DELAY_MS - 1) * USEC_PER_MSEC, "ack latency %u us", stats.ackLastUs);
+}
+
+
+ZTEST(hx_handshake, test_board_timeout)
+{
+    hxhs_stats_t stats;
+
+    zassert_equal(hxhs_request(K_MSEC(10)), -ETIMEDOUT);
+    zassert_equal(gpio_emul_output_get(rqst.port, rqst.pin), 0, "request not withdrawn");
+
+    hxhs_getStats(&stats);
+    zassert_equal(stats.timeouts, 1);
+    zassert_equal(stats.boardRequests, 0);
+}
+
+
+ZTEST(hx_handshake, test_busy_during_host_request)
+{
+    zassert_ok(gpio_emul_input_set(ctrl.port, ctrl.pin, 1));
+    zassert_equal(hxhs_request(K_MSEC(10)), -EBUSY, "board request started over a host request");
+    zassert_ok(gpio_emul_input_set(ctrl.port, ctrl.pin, 0));
+
+    zassert_equal(gpio_emul_output_get(rqst.port, rqst.pin), 0);
+}
+
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    (void)gpio_emul_input_set(ctrl.port, ctrl.pin, 0);
+    while (hxhs_waitHost(K_NO_WAIT) == 0)
+    {
+    }
+    hxhs_setHostCallback(NULL, NULL);
+    atomic_clear(&callbacks);
+    hxhs_resetStats();
+}
+
+ZTEST_SUITE(hx_handshake, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host MTC2 multiplexor emulator for the native_sim tests: a single control byte register, each
+ * write is counted so the tests can see which transactions paid for a segment select.
+ */
+
+#define DT_DRV_COMPAT loouq_hx_mux
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+
+#include "emul_hx_mux.h"
+
+struct hxmux_emulData
+{
+    uint8_t control;
+    uint32_t writes;
+    uint32_t failCount;
+};
+
+
+uint32_t emul_hxmux_controlWrites(const struct emul *target)
+{
+    struct hxmux_emulData *data = target->data;
+
+    return data->writes;
+}
+
+
+uint8_t emul_hxmux_control(const struct emul *target)
+{
+    struct hxmux_emulData *data = target->data;
+
+    return data->control;
+}
+
+
+void emul_hxmux_reset(const struct emul *target)
+{
+    struct hxmux_emulData *data = target->data;
+
+    data->writes = 0;
+}
+
+
+void emul_hxmux_failNext(const struct emul *target, uint32_t count)
+{
+    struct hxmux_emulData *data = target->data;
+
+    data->failCount = count;
+}
+
+
+static int hxmux_emulTransfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+    struct hxmux_emulData *data = target->data;
+
+    ARG_UNUSED(addr);
+
+    if (data->failCount > 0)
+    {
+        data->failCount--;
+        return -EIO;                                                    // address NAK
+    }
+    for (int m = 0; m < num_msgs; m++)
+    {
+        if ((msgs[m].flags & I2C_MSG_RW_MASK) == I2C_MSG_READ)
+        {
+            memset(msgs[m].buf, data->control, msgs[m].len);
+        }
+        else if (msgs[m].len > 0)
+        {
+            data->control = msgs[m].buf[msgs[m].len - 1];
+            data->writes++;
+        }
+    }
+    return 0;
+}
+
+
+static int hxmux_emulInit(const struct emul *target, const struct device *parent)
+{
+    struct hxmux_emulData *data = target->data;
+
+    ARG_UNUSED(parent);
+    data->control = 0;
+    data->writes = 0;
+    data->failCount = 0;
+    return 0;
+}
+
+
+static const struct i2c_emul_api hxmux_emulApi =
+{
+    .transfer = hxmux_emulTransfer,
+};
+
+
+#define HXMUX_EMUL(n)                                                                               \
+    static struct hxmux_emulData hxmux_emulData_##n;                                                \
+    EMUL_DT_INST_DEFINE(n, hxmux_emulInit, &hxmux_emulData_##n, NULL, &hxmux_emulApi, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(HXMUX_EMUL)
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EMUL_HX_MUX_H
+#define EMUL_HX_MUX_H
+
+#include <stdint.h>
+#include <zephyr/drivers/emul.h>
+
+/**
+ * @brief Control byte writes received since boot or the last reset
+ */
+uint32_t emul_hxmux_controlWrites(const struct emul *target);
+
+
+/**
+ * @brief Control byte last written
+ */
+uint8_t emul_hxmux_control(const struct emul *target);
+
+
+/**
+ * @brief Clear the control write counter
+ */
+void emul_hxmux_reset(const struct emul *target);
+
+
+/**
+ * @brief NAK the next control writes
+ *
+ * @param target Emulator
+ * @param count Writes to fail
+ */
+void emul_hxmux_failNext(const struct emul *target, uint32_t count);
+
+#endif  // EMUL_HX_MUX_H
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* HX multiplexor segment selection on native_sim: control byte writes counted by the multiplexor
+ * emulator against the transactions run, with select and segment transfer faults injected.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/emul.h>
+
+#include "hx-mux.h"
+#include "rgb-indicator.h"
+#include "emul_hx_mux.h"
+#include "emul_lp5817.h"
+
+#define TARGET_ADDR DT_REG_ADDR(DT_NODELABEL(target))
+#define TARGET_REG LP5817_REG_INTENSITY0
+#define RUN_LENGTH 4                                    // transactions per segment visit
+
+static const struct device *mux = DEVICE_DT_GET(DT_NODELABEL(hxmux));
+static const struct device *seg0 = DEVICE_DT_GET(DT_NODELABEL(hxseg0));
+static const struct device *seg1 = DEVICE_DT_GET(DT_NODELABEL(hxseg1));
+static const struct emul *muxEmul = EMUL_DT_GET(DT_NODELABEL(hxmux));
+static const struct emul *target = EMUL_DT_GET(DT_NODELABEL(target));
+
+
+static int segWrite(const struct device *seg, uint8_t val)
+{
+    return i2c_reg_write_byte(seg, TARGET_ADDR, TARGET_REG, val);
+}
+
+
+ZTEST(hx_mux, test_select_cached)
+{
+    const struct device *visits[] = { seg0, seg1, seg1, seg0 };             // seg1 twice: no switch between
+    hxmux_stats_t stats;
+    uint32_t transfers = 0;
+
+    for (size_t v = 0; v < ARRAY_SIZE(visits); v++)
+    {
+        for (int i = 0; i < RUN_LENGTH; i++)
+        {
+            zassert_ok(segWrite(visits[v], (uint8_t)(v * RUN_LENGTH + i)));
+            transfers++;
+        }
+    }
+
+    hxmux_getStats(mux, &stats);
+    zassert_equal(emul_hxmux_controlWrites(muxEmul), 3, "one select per segment switch");
+    zassert_equal(emul_hxmux_control(muxEmul), BIT(0));
+    zassert_equal(stats.transfers, transfers);
+    zassert_equal(stats.selectWrites, 3);
+    zassert_equal(stats.selectsSkipped, transfers - 3);
+    zassert_equal(emul_lp5817_getReg(target, TARGET_REG), transfers - 1);
+    TC_PRINT("%u transfers, %u select writes, %u avoided\n", stats.transfers, stats.selectWrites, stats.selectsSkipped);
+}
+
+
+ZTEST(hx_mux, test_transfer_error_drops_cache)
+{
+    hxmux_stats_t stats;
+
+    zassert_ok(segWrite(seg0, 1));
+    zassert_equal(emul_hxmux_controlWrites(muxEmul), 1);
+
+    emul_lp5817_failNext(target, 1);
+    zassert_not_equal(segWrite(seg0, 2), 0, "fault not reported");
+    zassert_ok(segWrite(seg0, 3));
+    zassert_equal(emul_hxmux_controlWrites(muxEmul), 2, "selection trusted after a failed transfer");
+
+    zassert_ok(segWrite(seg0, 4));
+    zassert_equal(emul_hxmux_controlWrites(muxEmul), 2, "cache not restored by the select");
+    hxmux_getStats(mux, &stats);
+    zassert_equal(stats.errors, 0, "segment fault counted as a select error");
+}
+
+
+ZTEST(hx_mux, test_select_error_drops_cache)
+{
+    hxmux_stats_t stats;
+
+    zassert_ok(segWrite(seg1, 1));
+    emul_hxmux_failNext(muxEmul, 1);
+    zassert_not_equal(segWrite(seg0, 2), 0, "select fault not reported");
+    zassert_equal(emul_lp5817_getReg(target, TARGET_REG), 1, "transfer ran without its segment");
+
+    zassert_ok(segWrite(seg0, 3));
+    zassert_equal(emul_hxmux_control(muxEmul), BIT(0));
+    hxmux_getStats(mux, &stats);
+    zassert_equal(stats.errors, 1);
+}
+
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    zassume_true(device_is_ready(seg0) && device_is_ready(seg1), "segments not ready");
+    emul_hxmux_failNext(muxEmul, 0);
+    emul_lp5817_failNext(target, 0);
+    (void)hxmux_deselect(mux);                                              // selection unknown to the cache
+    emul_hxmux_reset(muxEmul);
+    hxmux_resetStats(mux);
+}
+
+ZTEST_SUITE(hx_mux, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ISM330DHCX FIFO emulator for the ISense tests. With the accelerometer ODR set and the FIFO in
+ * continuous mode the FIFO fills at the rate the driver expects (accel + gyro word per sample, a
+ * timestamp word every 8 samples), capped at the part's 3 KB and flagging the overrun. FIFO words
+ * carry a sequence number (bytes 1-4, little endian) so a consumer can spot a lost or repeated
+ * word. Each transaction busy waits its 100kHz bus time, the HX bus is shared with the LP5817.
+ */
+
+#define DT_DRV_COMPAT loouq_ism330_emul
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "emul_ism330.h"
+#include "isense.h"
+
+#define ISM330_EMUL_REG_COUNT 0x80
+#define ISM330_EMUL_WHO_AM_I_REG 0x0f
+#define ISM330_EMUL_WHO_AM_I 0x6b
+#define ISM330_EMUL_FIFO_STATUS1 0x3a
+#define ISM330_EMUL_FIFO_STATUS2 0x3b
+#define ISM330_EMUL_FIFO_DATA_FIRST 0x78                // TAG, burst reads roll back here after 0x7e
+#define ISM330_EMUL_FIFO_DATA_LAST 0x7e
+#define ISM330_EMUL_FIFO_WORDS (3072 / ISENSE_WORD_SIZE)
+#define ISM330_EMUL_FIFO_CONTINUOUS 0x06
+#define ISM330_EMUL_FIFO_OVR 0x40                       // FIFO_STATUS2
+
+#define ISM330_EMUL_BUS_HZ 100000                       // HX bus, shared with the standard mode LP5817
+#define ISM330_EMUL_BITS_PER_BYTE 9                     // 8 data + ACK
+#define ISM330_EMUL_FRAME_BITS 2                        // START/RESTART + STOP per message
+#define ISM330_EMUL_FAIL_MAX 4
+
+static const uint32_t ism330_odrMilliHz[] = { 0, 12500, 26000, 52000, 104000, 208000, 416000, 833000, 1666000, 3332000, 6667000 };
+
+struct ism330_emulData
+{
+    struct k_spinlock lock;
+    uint8_t regs[ISM330_EMUL_REG_COUNT];
+    uint8_t pointer;                                    // register address pointer, auto-increments
+    int64_t originUs;                                   // FIFO fill start (rate or mode written)
+    uint32_t taken;                                     // words read or lost since originUs
+    uint32_t nextSeq;
+    bool overrun;
+    uint16_t status;                                    // FIFO_STATUS1/2 latched for the read underway
+    uint8_t word[ISENSE_WORD_SIZE];                     // FIFO word being read out
+    int fail[ISM330_EMUL_FAIL_MAX];
+    size_t failCount;
+    size_t failNext;
+    emul_ism330_stats_t stats;
+};
+
+struct ism330_emulConfig
+{
+    uint16_t addr;
+};
+
+
+/* ------------------------------------------------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------------------------------------------- */
+
+uint8_t emul_ism330_getReg(const struct emul *target, uint8_t reg)
+{
+    struct ism330_emulData *data = target->data;
+
+    return (reg < ISM330_EMUL_REG_COUNT) ? data->regs[reg] : 0;
+}
+
+
+void emul_ism330_getStats(const struct emul *target, emul_ism330_stats_t *stats)
+{
+    struct ism330_emulData *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+    *stats = data->stats;
+    k_spin_unlock(&(data->lock), key);
+}
+
+
+void emul_ism330_resetStats(const struct emul *target)
+{
+    struct ism330_emulData *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+    memset(&(data->stats), 0, sizeof(data->stats));
+    k_spin_unlock(&(data->lock), key);
+}
+
+
+void emul_ism330_failWrites(const struct emul *target, const int *errors, size_t count)
+{
+    struct ism330_emulData *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+    data->failCount = MIN(count, ISM330_EMUL_FAIL_MAX);
+    for (size_t i = 0; i < data->failCount; i++)
+    {
+        data->fail[i] = errors[i];
+    }
+    data->failNext = 0;
+    k_spin_unlock(&(data->lock), key);
+}
+
+
+/* Emulator
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Words in the FIFO now, words past the capacity are lost and flag the overrun (lock held)
+ */
+static uint32_t ism330_emulLevel(struct ism330_emulData *data)
+{
+    uint8_t odr = data->regs[EMUL_ISM330_REG_CTRL1_XL] >> 4;
+    uint64_t produced;
+    uint32_t level;
+
+    if ((data->regs[EMUL_ISM330_REG_FIFO_CTRL4] & 0x07) != ISM330_EMUL_FIFO_CONTINUOUS || odr == 0 ||
+        odr >= ARRAY_SIZE(ism330_odrMilliHz))
+    {
+        return 0;
+    }
+    produced = (uint64_t)(k_ticks_to_us_floor64(k_uptime_ticks()) - data->originUs) * ism330_odrMilliHz[odr] * 17 /
+               (8ULL * 1000U * 1000000U);
+    level = (uint32_t)(produced - data->taken);
+    if (level > ISM330_EMUL_FIFO_WORDS)
+    {
+        data->stats.overrunWords += level - ISM330_EMUL_FIFO_WORDS;
+        data->nextSeq += level - ISM330_EMUL_FIFO_WORDS;                // lost words keep their numbers
+        data->taken += level - ISM330_EMUL_FIFO_WORDS;
+        data->overrun = true;
+        level = ISM330_EMUL_FIFO_WORDS;
+    }
+    return level;
+}
+
+
+/**
+ * @brief Register read, the FIFO registers are computed
+ */
+static uint8_t ism330_emulRead(struct ism330_emulData *data, uint8_t reg)
+{
+    switch (reg)
+    {
+        case ISM330_EMUL_FIFO_STATUS1:
+            data->status = ism330_emulLevel(data);
+            if (data->overrun)
+            {
+                data->status |= ISM330_EMUL_FIFO_OVR << 8;
+                data->overrun = false;
+            }
+            return data->status & 0xff;
+
+        case ISM330_EMUL_FIFO_STATUS2:
+            return data->status >> 8;
+
+        case ISM330_EMUL_FIFO_DATA_FIRST:
+            memset(data->word, 0, sizeof(data->word));
+            if (ism330_emulLevel(data) > 0)
+            {
+                data->word[0] = ((data->nextSeq & 1) ? ISENSE_TAG_ACCEL : ISENSE_TAG_GYRO) << 3;
+                sys_put_le32(data->nextSeq++, &(data->word[1]));
+                data->taken++;
+                data->stats.fifoWords++;
+            }
+            else
+            {
+                data->stats.emptyWords++;
+            }
+            return data->word[0];
+
+        default:
+            if (reg > ISM330_EMUL_FIFO_DATA_FIRST && reg <= ISM330_EMUL_FIFO_DATA_LAST)
+            {
+                return data->word[reg - ISM330_EMUL_FIFO_DATA_FIRST];
+            }
+            return (reg < ISM330_EMUL_REG_COUNT) ? data->regs[reg] : 0;
+    }
+}
+
+
+/**
+ * @brief Register write, a rate or FIFO mode change restarts the fill
+ */
+static void ism330_emulWrite(struct ism330_emulData *data, uint8_t reg, uint8_t val)
+{
+    if (reg >= ISM330_EMUL_REG_COUNT || reg == ISM330_EMUL_WHO_AM_I_REG)
+    {
+        return;
+    }
+    data->regs[reg] = val;
+    if (reg == EMUL_ISM330_REG_CTRL1_XL || reg == EMUL_ISM330_REG_FIFO_CTRL4)
+    {
+        data->originUs = k_ticks_to_us_floor64(k_uptime_ticks());
+        data->taken = 0;
+        data->overrun = false;
+    }
+}
+
+
+static int ism330_emulTransfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+    struct ism330_emulData *data = target->data;
+    uint64_t busTimeUs = 0;
+    int ret = 0;
+    k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+    ARG_UNUSED(addr);
+
+    data->stats.transactions++;
+    if (num_msgs == 1 && (msgs[0].flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE && data->failNext < data->failCount)
+    {
+        ret = data->fail[data->failNext++];
+        busTimeUs = (ISM330_EMUL_BITS_PER_BYTE + ISM330_EMUL_FRAME_BITS) * 1000000ULL / ISM330_EMUL_BUS_HZ;
+        num_msgs = 0;                                                   // address NAK, nothing transferred
+    }
+
+    for (int m = 0; m < num_msgs; m++)
+    {
+        struct i2c_msg *msg = &msgs[m];
+        uint32_t i = 0;
+
+        busTimeUs += ((1 + msg->len) * ISM330_EMUL_BITS_PER_BYTE + ISM330_EMUL_FRAME_BITS) * 1000000ULL / ISM330_EMUL_BUS_HZ;
+        if ((msg->flags & I2C_MSG_RW_MASK) == I2C_MSG_READ)
+        {
+            for (; i < msg->len; i++)
+            {
+                msg->buf[i] = ism330_emulRead(data, data->pointer++);
+                if (data->pointer > ISM330_EMUL_FIFO_DATA_LAST)
+                {
+                    data->pointer = ISM330_EMUL_FIFO_DATA_FIRST;
+                }
+            }
+            continue;
+        }
+
+        if (msg->len > 0 && (m == 0 || (msg->flags & I2C_MSG_RESTART)))  // first byte of a write sets the pointer
+        {
+            data->pointer = msg->buf[i++];
+        }
+        for (; i < msg->len; i++)
+        {
+            ism330_emulWrite(data, data->pointer++, msg->buf[i]);
+        }
+    }
+    data->stats.busTimeUs += busTimeUs;
+    k_spin_unlock(&(data->lock), key);
+
+    k_busy_wait((uint32_t)busTimeUs);                                   // HX bus thread holds the bus meanwhile
+    return ret;
+}
+
+
+static int ism330_emulInit(const struct emul *target, const struct device *parent)
+{
+    struct ism330_emulData *data = target->data;
+
+    ARG_UNUSED(parent);
+    memset(data->regs, 0, sizeof(data->regs));
+    data->regs[ISM330_EMUL_WHO_AM_I_REG] = ISM330_EMUL_WHO_AM_I;
+    data->pointer = 0;
+    data->originUs = 0;
+    data->taken = 0;
+    data->nextSeq = 0;
+    data->overrun = false;
+    data->failCount = 0;
+    data->failNext = 0;
+    memset(&(data->stats), 0, sizeof(data->stats));
+    return 0;
+}
+
+
+static const struct i2c_emul_api ism330_emulApi =
+{
+    .transfer = ism330_emulTransfer,
+};
+
+
+#define ISM330_EMUL(n)                                                                              \
+    static struct ism330_emulData ism330_emulData_##n;                                              \
+    static const struct ism330_emulConfig ism330_emulConfig_##n =                                   \
+    {                                                                                               \
+        .addr = DT_INST_REG_ADDR(n),                                                                \
+    };                                                                                              \
+    EMUL_DT_INST_DEFINE(n, ism330_emulInit, &ism330_emulData_##n, &ism330_emulConfig_##n,           \
+                        &ism330_emulApi, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(ISM330_EMUL)
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EMUL_ISM330_H
+#define EMUL_ISM330_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <zephyr/drivers/emul.h>
+
+#define EMUL_ISM330_REG_CTRL1_XL 0x10
+#define EMUL_ISM330_REG_FIFO_CTRL4 0x0a
+
+typedef struct _emul_ism330_stats
+{
+    uint32_t transactions;
+    uint32_t fifoWords;                                 // FIFO words read
+    uint32_t emptyWords;                                // words read past the FIFO level
+    uint32_t overrunWords;                              // words lost to a full FIFO
+    uint64_t busTimeUs;                                 // modeled 100kHz bus time
+} emul_ism330_stats_t;
+
+
+/**
+ * @brief Register value as last written
+ */
+uint8_t emul_ism330_getReg(const struct emul *target, uint8_t reg);
+
+
+/**
+ * @brief Bus counters since boot or the last reset
+ */
+void emul_ism330_getStats(const struct emul *target, emul_ism330_stats_t *stats);
+
+
+/**
+ * @brief Clear the bus counters
+ */
+void emul_ism330_resetStats(const struct emul *target);
+
+
+/**
+ * @brief Fail the next register writes, one error per write (reads are not affected)
+ *
+ * @param target Emulator
+ * @param errors Error returned by each failing write
+ * @param count Number of errors, at most 4
+ */
+void emul_ism330_failWrites(const struct emul *target, const int *errors, size_t count);
+
+#endif  // EMUL_ISM330_H
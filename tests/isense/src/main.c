@@ -0,0 +1,165 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ISense streaming on native_sim against the ISM330DHCX FIFO emulator: throughput and callback
+ * CPU benchmark, stop while a FIFO drain chain is on the HX bus, stop error reporting. The
+ * emulator transfers take their 100kHz bus time. native_sim runs code in zero simulated time, the
+ * callback CPU counter reads near 0 here, on the board it is the streaming cost.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "hx-bus.h"
+#include "isense.h"
+#include "emul_ism330.h"
+
+#define BENCH_MS 2000
+#define BENCH_ODR ISENSE_ODR_208HZ
+#define BENCH_ODR_MILLIHZ 208000
+#define BENCH_WATERMARK 64
+#define CLAIM_WORDS 32
+#define STOP_ROUNDS 16
+#define STOP_WATERMARK 32                               // drain chain: status read + 4 bursts of 8 words
+
+static const struct emul *ism330 = EMUL_DT_GET(DT_NODELABEL(isense_ism));
+static const isense_config_t benchConfig = { .odr = BENCH_ODR, .watermark = BENCH_WATERMARK, .bmpPeriodMs = 0 };
+
+
+/* Consume the stream for a while, count words and sequence gaps
+ */
+static void consume(uint32_t ms, uint32_t *words, uint32_t *gaps)
+{
+    int64_t end = k_uptime_get() + ms;
+    uint32_t expectSeq = 0;
+    bool first = true;
+
+    *words = 0;
+    *gaps = 0;
+    while (k_uptime_get() < end)
+    {
+        const uint8_t *claimed;
+        size_t count;
+
+        if (isense_wait(K_MSEC(100)) != 0)
+        {
+            continue;
+        }
+        while ((count = isense_claim(&claimed, CLAIM_WORDS)) > 0)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                uint32_t seq = sys_get_le32(&claimed[i * ISENSE_WORD_SIZE + 1]);
+
+                if (!first && seq != expectSeq)
+                {
+                    (*gaps) += seq - expectSeq;
+                }
+                first = false;
+                expectSeq = seq + 1;
+            }
+            *words += count;
+            isense_release(count);
+        }
+    }
+}
+
+
+ZTEST(isense, test_stream_throughput)
+{
+    isense_stats_t stats;
+    emul_ism330_stats_t bus;
+    hxbus_stats_t hx;
+    uint32_t words;
+    uint32_t gaps;
+    uint32_t expected = (uint32_t)((uint64_t)BENCH_ODR_MILLIHZ * 17 / 8 * BENCH_MS / 1000000U);
+
+    zassert_ok(isense_start(&benchConfig));
+    hxbus_resetStats();
+    emul_ism330_resetStats(ism330);
+    consume(BENCH_MS, &words, &gaps);
+    isense_getStats(&stats);
+    emul_ism330_getStats(ism330, &bus);
+    hxbus_getStats(&hx);
+    zassert_ok(isense_stop());
+
+    zassert_equal(gaps, bus.overrunWords, "words lost or repeated besides FIFO overruns");
+    zassert_equal(stats.fifoOverruns, 0, "FIFO overflowed, drain too slow");
+    zassert_equal(bus.emptyWords, 0, "read past the FIFO level");
+    zassert_within(words, expected, expected / 10 + BENCH_WATERMARK, "%u words, expected %u", words, expected);
+
+    TC_PRINT("ODR %u mHz, watermark %u, burst %u words, %u ms\n", BENCH_ODR_MILLIHZ, BENCH_WATERMARK,
+             CONFIG_ISENSE_BURST_WORDS, BENCH_MS);
+    TC_PRINT("  %u words (%u B/s), %u bursts, ring drops %u, FIFO overruns %u\n", words,
+             words * ISENSE_WORD_SIZE * 1000U / BENCH_MS, stats.bursts, stats.ringDrops, stats.fifoOverruns);
+    TC_PRINT("  callback CPU %u us (%u us per 1000 words)\n", stats.cpuUs,
+             (uint32_t)((uint64_t)stats.cpuUs * 1000U / MAX(words, 1)));
+    TC_PRINT("  sensor bus time %u us (%u%% of 100kHz bus), HX bus utilization %u%%\n", (uint32_t)bus.busTimeUs,
+             (uint32_t)(bus.busTimeUs * 100U / (BENCH_MS * 1000U)),
+             (uint32_t)((uint64_t)hx.busyUs * 100 / MAX(hx.elapsedUs, 1)));
+}
+
+
+ZTEST(isense, test_stop_ends_chain)
+{
+    const isense_config_t config = { .odr = BENCH_ODR, .watermark = STOP_WATERMARK, .bmpPeriodMs = 0 };
+    uint32_t pollMs = STOP_WATERMARK * 1000000U / (BENCH_ODR_MILLIHZ * 17 / 8);
+    emul_ism330_stats_t busBefore;
+    emul_ism330_stats_t busAfter;
+    const uint8_t *claimed;
+    size_t count;
+
+    for (int round = 0; round < STOP_ROUNDS; round++)
+    {
+        zassert_ok(isense_start(&config), "round %d: restart refused", round);
+        k_msleep(pollMs + 2 * (round % 8));                                 // lands before, in and after the chain
+        zassert_ok(isense_stop());
+
+        emul_ism330_getStats(ism330, &busBefore);
+        k_msleep(2 * pollMs);
+        emul_ism330_getStats(ism330, &busAfter);
+        zassert_equal(busAfter.transactions, busBefore.transactions, "round %d: transfer after stop", round);
+        zassert_equal(emul_ism330_getReg(ism330, EMUL_ISM330_REG_FIFO_CTRL4), 0, "FIFO not in bypass");
+        zassert_equal(emul_ism330_getReg(ism330, EMUL_ISM330_REG_CTRL1_XL), 0, "accel not powered down");
+
+        while ((count = isense_claim(&claimed, CLAIM_WORDS)) > 0)
+        {
+            isense_release(count);
+        }
+    }
+}
+
+
+ZTEST(isense, test_stop_first_error)
+{
+    const int errors[2] = { -EIO, -ETIMEDOUT };
+
+    zassert_ok(isense_start(&benchConfig));
+    emul_ism330_failWrites(ism330, errors, ARRAY_SIZE(errors));
+    zassert_equal(isense_stop(), -EIO, "first error not returned");
+    zassert_ok(isense_stop(), "stopped twice");
+}
+
+
+static void before(void *fixture)
+{
+    const uint8_t *claimed;
+    size_t count;
+
+    ARG_UNUSED(fixture);
+
+    (void)isense_stop();
+    emul_ism330_failWrites(ism330, NULL, 0);
+    while ((count = isense_claim(&claimed, CLAIM_WORDS)) > 0)
+    {
+        isense_release(count);
+    }
+    emul_ism330_resetStats(ism330);
+}
+
+ZTEST_SUITE(isense, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* PWM indicator backend on the native_sim fake PWM controller. The fake records every
+ * pwm_set_cycles() call, the cases check the pulse width per output (level x dot-current x
+ * brightness of the 1000 cycle period) and report the calls and caller latency of the API. On
+ * native_sim the outputs go through the Zephyr PWM API and flashes are timer driven, the nRF
+ * sequencer path needs the board.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fff.h>
+#include <zephyr/drivers/led.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/drivers/pwm/pwm_fake.h>
+
+#include "rgb-indicator.h"
+
+DEFINE_FFF_GLOBALS;
+
+#define PERIOD_NS 1000000U                              // PWM_USEC(1000), boards/native_sim.overlay
+#define FAKE_HZ 1000000U
+#define FLASH_MS 10
+#define FLASH_COUNT 2
+#define SETTLE_MS 10                                    // longer than any queued edge or posted command takes
+
+static const struct device *rgbDev = DEVICE_DT_GET(DT_NODELABEL(rgbpwm));
+static const uint8_t dotCurrent[3] = DT_PROP(DT_NODELABEL(rgbpwm), dot_current);
+static rgb_indicator_t *rgbi;
+static uint32_t initPulse[3];                           // pulses rgbi_init() left, before the first case resets the fake
+
+
+/* Pulse width in cycles the backend should set for a level on an output
+ */
+static uint32_t expectCycles(size_t output, uint8_t level, uint8_t brightness)
+{
+    uint32_t duty = (uint32_t)level * dotCurrent[output] * brightness / UINT8_MAX;
+    uint64_t pulseNs = (uint64_t)PERIOD_NS * duty / (UINT8_MAX * UINT8_MAX);
+
+    return (uint32_t)(pulseNs * FAKE_HZ / NSEC_PER_SEC);
+}
+
+
+/* Last pulse set on a channel since the fake was reset, UINT32_MAX if none
+ */
+static uint32_t lastPulse(uint32_t channel)
+{
+    unsigned int calls = MIN(fake_pwm_set_cycles_fake.call_count, FFF_ARG_HISTORY_LEN);
+
+    for (unsigned int i = calls; i > 0; i--)
+    {
+        if (fake_pwm_set_cycles_fake.arg1_history[i - 1] == channel)
+        {
+            return fake_pwm_set_cycles_fake.arg3_history[i - 1];
+        }
+    }
+    return UINT32_MAX;
+}
+
+
+/* Expected outputs, channel map red=output 2, green=output 0, blue=output 1
+ */
+static void assertOutputs(uint8_t red, uint8_t green, uint8_t blue, uint8_t brightness)
+{
+    zassert_equal(lastPulse(0), expectCycles(0, green, brightness), "output 0 (green)");
+    zassert_equal(lastPulse(1), expectCycles(1, blue, brightness), "output 1 (blue)");
+    zassert_equal(lastPulse(2), expectCycles(2, red, brightness), "output 2 (red)");
+}
+
+
+static bool waitIdle(uint32_t timeoutMs)
+{
+    int64_t end = k_uptime_get() + timeoutMs;
+
+    while (rgbi_isBusy(rgbi))
+    {
+        if (k_uptime_get() > end)
+        {
+            return false;
+        }
+        k_msleep(1);
+    }
+    return true;
+}
+
+
+ZTEST(rgb_indicator_pwm, test_init)
+{
+    zassert_equal(initPulse[0], 0, "output 0 not off");
+    zassert_equal(initPulse[1], 0, "output 1 not off");
+    zassert_equal(initPulse[2], 0, "output 2 not off");
+}
+
+
+ZTEST(rgb_indicator_pwm, test_set_color)
+{
+    uint32_t start;
+    uint32_t cycles;
+
+    start = k_cycle_get_32();
+    zassert_ok(rgbi_setColorFromPixels(rgbi, 10, 20, 200));
+    cycles = k_cycle_get_32() - start;
+    assertOutputs(10, 20, 200, UINT8_MAX);
+    zassert_equal(fake_pwm_set_cycles_fake.call_count, 3, "one PWM update per output");
+    TC_PRINT("%-28s pwm calls %u, caller %u us\n", "rgbi_setColorFromPixels", fake_pwm_set_cycles_fake.call_count,
+             k_cyc_to_us_ceil32(cycles));
+
+    RESET_FAKE(fake_pwm_set_cycles);
+    zassert_ok(rgbi_off(rgbi));
+    assertOutputs(0, 0, 0, UINT8_MAX);
+}
+
+
+ZTEST(rgb_indicator_pwm, test_brightness)
+{
+    zassert_ok(rgbi_setColorFromPixels(rgbi, 255, 255, 255));
+    assertOutputs(255, 255, 255, UINT8_MAX);
+    zassert_equal(lastPulse(0), FAKE_HZ / USEC_PER_SEC * (PERIOD_NS / NSEC_PER_USEC), "full level not a full period");
+
+    RESET_FAKE(fake_pwm_set_cycles);
+    zassert_ok(rgbi_setBrightness(rgbi, 128));
+    assertOutputs(255, 255, 255, 128);
+
+    zassert_ok(rgbi_setBrightness(rgbi, UINT8_MAX));
+    zassert_ok(rgbi_off(rgbi));
+}
+
+
+ZTEST(rgb_indicator_pwm, test_flash_count)
+{
+    struct led_rgb color = RGB(0, 64, 0);
+    unsigned int onEdges = 0;
+    unsigned int calls;
+
+    rgbi_flash(rgbi, &color, K_MSEC(FLASH_MS), K_MSEC(FLASH_MS), FLASH_COUNT);
+    zassert_true(waitIdle(4 * FLASH_COUNT * FLASH_MS), "flash did not end");
+    k_msleep(SETTLE_MS);
+
+    calls = MIN(fake_pwm_set_cycles_fake.call_count, FFF_ARG_HISTORY_LEN);
+    for (unsigned int i = 0; i < calls; i++)
+    {
+        if (fake_pwm_set_cycles_fake.arg1_history[i] == 0 && fake_pwm_set_cycles_fake.arg3_history[i] != 0)
+        {
+            onEdges++;
+        }
+    }
+    zassert_equal(onEdges, FLASH_COUNT, "one on edge per flash");
+    assertOutputs(0, 0, 0, UINT8_MAX);
+    TC_PRINT("%-28s pwm calls %u\n", "rgbi_flash x2 sequence", fake_pwm_set_cycles_fake.call_count);
+}
+
+
+ZTEST(rgb_indicator_pwm, test_led_blink_color)
+{
+    const uint8_t red[3] = { 200, 0, 0 };
+    const uint8_t black[3] = { 0, 0, 0 };
+
+    zassert_ok(led_blink(rgbDev, 0, FLASH_MS, FLASH_MS));                  // no LED API color yet: white
+    k_msleep(FLASH_MS / 2);
+    assertOutputs(255, 255, 255, UINT8_MAX);
+
+    zassert_ok(led_set_color(rgbDev, 0, ARRAY_SIZE(red), red));
+    zassert_ok(led_set_color(rgbDev, 0, ARRAY_SIZE(black), black));
+    zassert_false(rgbi_isBusy(rgbi), "black did not end the blink");
+    assertOutputs(0, 0, 0, UINT8_MAX);
+
+    RESET_FAKE(fake_pwm_set_cycles);
+    zassert_ok(led_blink(rgbDev, 0, FLASH_MS, FLASH_MS));                  // last non-black color
+    k_msleep(FLASH_MS / 2);
+    assertOutputs(200, 0, 0, UINT8_MAX);
+}
+
+
+static void *setup(void)
+{
+    rgbi = rgbi_fromDevice(rgbDev);
+    if (rgbi != NULL && rgbi_waitReady(rgbi, K_SECONDS(1)) == 0)
+    {
+        for (uint32_t ch = 0; ch < ARRAY_SIZE(initPulse); ch++)
+        {
+            initPulse[ch] = lastPulse(ch);
+        }
+    }
+    return NULL;
+}
+
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    zassume_true(device_is_ready(rgbDev), "PWM indicator not ready");
+    zassume_not_null(rgbi);
+    rgbi_cancel(rgbi);
+    (void)waitIdle(SETTLE_MS);
+    RESET_FAKE(fake_pwm_set_cycles);
+}
+
+ZTEST_SUITE(rgb_indicator_pwm, NULL, setup, before, NULL, NULL);
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Indicator service on native_sim against the LP5817 emulator: channel state to display mapping
+ * and priority, coalescing of publication bursts into frames, and the publisher cost with the
+ * indicator idle and under load. The emulated transfers take their 100kHz bus time, a publish
+ * that waited on an indicator write would show it.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "rgb-indicator.h"
+#include "rgb-indicator-service.h"
+#include "emul_lp5817.h"
+
+#define FRAME_MS CONFIG_RGBINDICATOR_SERVICE_FRAME_MS
+#define SETTLE_MS (2 * FRAME_MS)                        // a change reaches the chip within a frame
+#define BURST 8                                         // publications per burst, within the service queue
+#define PUBLISH_ROUNDS 32
+#define LOAD_MS 500
+
+enum { CELL_OFF, CELL_CONNECTED, CELL_ROAMING, CELL_SEARCHING };
+enum { FAULT_NONE, FAULT_ACTIVE };
+
+struct statusMsg
+{
+    uint8_t state;
+};
+
+ZBUS_CHAN_DEFINE(cell_chan, struct statusMsg, NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(.state = CELL_OFF));
+ZBUS_CHAN_DEFINE(fault_chan, struct statusMsg, NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(.state = FAULT_NONE));
+
+static const rgbi_svcState_t cellStates[] =
+{
+    [CELL_OFF] = RGBI_SVC_OFF(),
+    [CELL_CONNECTED] = RGBI_SVC_COLOR(RGB(0, 100, 0)),
+    [CELL_ROAMING] = RGBI_SVC_COLOR(RGB(0, 0, 100)),
+    [CELL_SEARCHING] = RGBI_SVC_FLASH(RGB(0, 0, 100), 2, 2, 0),         // an edge every 2ms
+};
+
+static const rgbi_svcState_t faultStates[] =
+{
+    [FAULT_NONE] = RGBI_SVC_OFF(),
+    [FAULT_ACTIVE] = RGBI_SVC_COLOR(RGB(100, 0, 0)),
+};
+
+static const rgbi_svcBinding_t bindings[] =
+{
+    { &cell_chan, 10, cellStates, ARRAY_SIZE(cellStates) },
+    { &fault_chan, 30, faultStates, ARRAY_SIZE(faultStates) },
+};
+
+static const struct i2c_dt_spec rgbSpec = I2C_DT_SPEC_GET(DT_NODELABEL(rgbctrl));
+static const struct emul *lp5817 = EMUL_DT_GET(DT_NODELABEL(rgbctrl));
+static rgb_indicator_t rgbi;
+static int startResult;
+
+
+/* Expected intensity registers, default rgbi_init() channel map: red=OUT2, green=OUT0, blue=OUT1
+ */
+static void assertOutputs(uint8_t red, uint8_t green, uint8_t blue)
+{
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY0), green, "OUT0 (green)");
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY1), blue, "OUT1 (blue)");
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY2), red, "OUT2 (red)");
+}
+
+
+/* Publish a state, returns the time the publisher spent in the call
+ */
+static void publish(const struct zbus_channel *chan, uint8_t state, uint32_t *us)
+{
+    struct statusMsg msg = { .state = state };
+    uint32_t start = k_cycle_get_32();
+
+    zassert_ok(zbus_chan_pub(chan, &msg, K_MSEC(FRAME_MS)));
+    *us = k_cyc_to_us_ceil32(k_cycle_get_32() - start);
+}
+
+
+ZTEST(rgb_indicator_service, test_state_display)
+{
+    uint32_t us;
+
+    publish(&cell_chan, CELL_CONNECTED, &us);
+    k_msleep(SETTLE_MS);
+    assertOutputs(0, 100, 0);
+
+    publish(&fault_chan, FAULT_ACTIVE, &us);
+    k_msleep(SETTLE_MS);
+    assertOutputs(100, 0, 0);                                               // higher priority binding shows
+
+    publish(&cell_chan, CELL_ROAMING, &us);
+    k_msleep(SETTLE_MS);
+    assertOutputs(100, 0, 0);                                               // lower priority change stays hidden
+
+    publish(&fault_chan, FAULT_NONE, &us);
+    k_msleep(SETTLE_MS);
+    assertOutputs(0, 0, 100);                                               // released, latest cell state resumes
+}
+
+
+ZTEST(rgb_indicator_service, test_burst_coalesced)
+{
+    rgbi_svcStats_t stats;
+    emul_lp5817_stats_t bus;
+    uint32_t us;
+
+    emul_lp5817_resetStats(lp5817);
+    rgbi_svcResetStats();
+    for (int i = 0; i < BURST; i++)
+    {
+        publish(&cell_chan, (i & 1) ? CELL_ROAMING : CELL_CONNECTED, &us);
+    }
+    k_msleep(SETTLE_MS);
+
+    rgbi_svcGetStats(&stats);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(stats.notifications, BURST);
+    zassert_true(stats.frames <= 2, "%u frames for one burst", stats.frames);       // first change at once, the rest a frame later
+    zassert_equal(stats.coalesced, BURST - 1 - (stats.frames - 1));
+    zassert_true(bus.transactions <= stats.frames, "%u writes for %u frames", bus.transactions, stats.frames);
+    assertOutputs(0, 0, 100);                                                       // latest state shown
+    TC_PRINT("Burst of %u publications: %u frames, %u coalesced, %u indicator writes\n", BURST, stats.frames,
+             stats.coalesced, bus.transactions);
+}
+
+
+/* Publish rounds of bursts on the fault channel, returns the longest and the average publish
+ */
+static void publishRounds(uint32_t periodMs, uint32_t *maxUs, uint32_t *avgUs)
+{
+    uint64_t sumUs = 0;
+    uint32_t us;
+
+    *maxUs = 0;
+    for (int round = 0; round < PUBLISH_ROUNDS; round++)
+    {
+        for (int i = 0; i < BURST; i++)
+        {
+            publish(&fault_chan, FAULT_NONE, &us);                          // unchanged state, no display change
+            *maxUs = MAX(*maxUs, us);
+            sumUs += us;
+        }
+        k_msleep(periodMs);
+    }
+    *avgUs = (uint32_t)(sumUs / (PUBLISH_ROUNDS * BURST));
+}
+
+
+ZTEST(rgb_indicator_service, test_publish_cost)
+{
+    emul_lp5817_stats_t bus;
+    uint32_t idleMaxUs;
+    uint32_t idleAvgUs;
+    uint32_t loadMaxUs;
+    uint32_t loadAvgUs;
+    uint32_t us;
+
+    publishRounds(SETTLE_MS, &idleMaxUs, &idleAvgUs);                       // indicator quiet between bursts
+
+    publish(&cell_chan, CELL_SEARCHING, &us);
+    k_msleep(SETTLE_MS);
+    emul_lp5817_resetStats(lp5817);
+    publishRounds(LOAD_MS / PUBLISH_ROUNDS, &loadMaxUs, &loadAvgUs);        // flash edge writes every 2ms
+    emul_lp5817_getStats(lp5817, &bus);
+    publish(&cell_chan, CELL_OFF, &us);
+    k_msleep(SETTLE_MS);
+
+    zassert_true(bus.transactions > LOAD_MS / 8, "indicator not loaded, %u writes", bus.transactions);
+    zassert_true(loadMaxUs < bus.busTimeUs / bus.transactions, "publish waited %u us, on an indicator write", loadMaxUs);
+    TC_PRINT("zbus_chan_pub, bursts of %u: idle avg %u us max %u us, flashing avg %u us max %u us\n", BURST, idleAvgUs,
+             idleMaxUs, loadAvgUs, loadMaxUs);
+    TC_PRINT("  %u indicator writes, %u us bus time each\n", bus.transactions, (uint32_t)(bus.busTimeUs / bus.transactions));
+}
+
+
+static void *setup(void)
+{
+    startResult = rgbi_init(&rgbSpec, &rgbi);
+    if (startResult == 0)
+    {
+        startResult = rgbi_waitReady(&rgbi, K_SECONDS(1));
+    }
+    if (startResult == 0)
+    {
+        startResult = rgbi_svcStart(&rgbi, bindings, ARRAY_SIZE(bindings));
+    }
+    return NULL;
+}
+
+
+static void before(void *fixture)
+{
+    struct statusMsg off = { .state = 0 };
+
+    ARG_UNUSED(fixture);
+
+    zassume_ok(startResult, "service not started");
+    (void)zbus_chan_pub(&fault_chan, &off, K_FOREVER);
+    (void)zbus_chan_pub(&cell_chan, &off, K_FOREVER);
+    k_msleep(SETTLE_MS);
+    emul_lp5817_resetStats(lp5817);
+    rgbi_svcResetStats();
+}
+
+ZTEST_SUITE(rgb_indicator_service, NULL, setup, before, NULL, NULL);
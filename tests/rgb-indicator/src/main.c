@@ -0,0 +1,786 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Indicator driver on the LP5817 emulator (native_sim). Each case checks the chip register state
+ * and reports the bus cost of the API calls: I2C transactions, bytes on the bus (address byte per
+ * message included) and the modeled 100kHz bus time, plus the caller latency. native_sim runs code
+ * in zero simulated time, caller latency counts the waits a call makes, the bus time is what a
+ * blocking call costs on the board.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/emul.h>
+
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+#include <stdio.h>
+#include <zephyr/settings/settings.h>
+#endif
+#if defined(CONFIG_RGBINDICATOR_PM)
+#include <zephyr/pm/device_runtime.h>
+#endif
+
+#include "rgb-indicator.h"
+#include "emul_lp5817.h"
+
+#define FLASH_ON_MS 20
+#define FLASH_OFF_MS 20
+#define FLASH_COUNT 3
+#define FLASH_RUN_MS (FLASH_COUNT * FLASH_ON_MS + (FLASH_COUNT - 1) * FLASH_OFF_MS)    // ends on the last OFF edge
+#define SETTLE_MS 10                                    // longer than any queued edge or posted command takes
+#define RACE_ROUNDS 64
+#define STRESS_THREADS 3
+#define STRESS_MS 500
+#define STRESS_STACK_SIZE 1024
+#define ENGINE_STEP_MS 90                               // LP5817 animation engine time code 1
+#define STEP_MS 20
+#define FRAME_TOL_MS (CONFIG_RGBINDICATOR_SCHED_COALESCE_MS + 2)    // early window + 1ms polling either side
+
+static const struct i2c_dt_spec rgbSpec = I2C_DT_SPEC_GET(DT_NODELABEL(rgbctrl));
+static const struct emul *lp5817 = EMUL_DT_GET(DT_NODELABEL(rgbctrl));
+static rgb_indicator_t rgbi;
+
+static uint32_t initCallCycles;                         // rgbi_init() return, configuration may continue in background
+static uint32_t initReadyCycles;                        // rgbi_init() to configuration done
+static emul_lp5817_stats_t initBus;
+static int initResult;
+
+static void cancel_expiry(struct k_timer *timer);
+static K_TIMER_DEFINE(cancelTimer, cancel_expiry, NULL);
+
+static void stress_expiry(struct k_timer *timer);
+static K_TIMER_DEFINE(stressTimer, stress_expiry, NULL);
+static K_THREAD_STACK_ARRAY_DEFINE(stressStacks, STRESS_THREADS, STRESS_STACK_SIZE);
+static struct k_thread stressThreads[STRESS_THREADS];
+static atomic_t stressStop;
+static atomic_t stressPosts;                           // thread posts
+static atomic_t stressErrors;                          // rgbi_setColor() other than 0 or -ECANCELED
+static volatile uint32_t stressIsrRound;
+static volatile uint32_t stressIsrOp;                  // last ISR post: 0=set, 1=flash x2, 2=cancel
+static struct led_rgb stressIsrColor;                  // last ISR set color
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+RGBI_PATTERN_DEFINE(slowFade,                           // 10 levels over 1s: a frame per 100ms
+    RGBI_STEP_SET(0, 0, 0, 0),
+    RGBI_STEP_FADE(10, 0, 0, 1000)
+);
+
+RGBI_PATTERN_DEFINE(fastFade,                           // 200 levels over 400ms: capped at one frame per FRAME_MS
+    RGBI_STEP_SET(0, 0, 0, 0),
+    RGBI_STEP_FADE(200, 0, 0, 400)
+);
+
+RGBI_PATTERN_DEFINE(nestedRepeat,
+    RGBI_STEP_REPEAT(2),
+        RGBI_STEP_REPEAT(3),
+            RGBI_STEP_SET(10, 0, 0, STEP_MS),
+            RGBI_STEP_SET(0, 0, 0, STEP_MS),
+        RGBI_STEP_END_REPEAT(),
+        RGBI_STEP_SET(0, 20, 0, STEP_MS),
+        RGBI_STEP_SET(0, 20, 0, STEP_MS),               // same color, frame dropped
+    RGBI_STEP_END_REPEAT()
+);
+#endif
+
+
+/* Expected intensity registers, default rgbi_init() channel map: red=OUT2, green=OUT0, blue=OUT1
+ */
+static void assertOutputs(uint8_t red, uint8_t green, uint8_t blue)
+{
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY0), green, "OUT0 (green)");
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY1), blue, "OUT1 (blue)");
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY2), red, "OUT2 (red)");
+}
+
+
+static void report(const char *call, const emul_lp5817_stats_t *bus, uint32_t callerCycles)
+{
+    TC_PRINT("%-28s xfers %3u, bytes %4u, bus %6llu us, caller %5u us\n", call, bus->transactions,
+             bus->messages + bus->bytesWritten + bus->bytesRead, (unsigned long long)bus->busTimeUs, k_cyc_to_us_ceil32(callerCycles));
+}
+
+
+static bool waitIdle(uint32_t timeoutMs)
+{
+    int64_t end = k_uptime_get() + timeoutMs;
+
+    while (rgbi_isBusy(&rgbi))
+    {
+        if (k_uptime_get() > end)
+        {
+            return false;
+        }
+        k_msleep(1);
+    }
+    return true;
+}
+
+
+static void cancel_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    rgbi_cancel(&rgbi);                                 // ISR context, races the flash edges
+}
+
+
+ZTEST(rgb_indicator, test_init)
+{
+    zassert_ok(initResult, "chip configuration failed");
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_CHIPENABLE), LP5817_CMD_CHIPENABLE);
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_OUTENABLE), LP5817_CMD_OUTENABLE);
+    zassert_true(initBus.updateCmds >= 1, "configuration not latched");
+    assertOutputs(0, 0, 0);
+
+    report("rgbi_init", &initBus, initCallCycles);
+    TC_PRINT("%-28s %u us\n", "rgbi_init to ready", k_cyc_to_us_ceil32(initReadyCycles));
+}
+
+
+ZTEST(rgb_indicator, test_set_color)
+{
+    struct led_rgb color = RGB(10, 20, 30);
+    emul_lp5817_stats_t bus;
+    uint32_t start;
+
+    start = k_cycle_get_32();
+    zassert_ok(rgbi_setColor(&rgbi, &color));
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_setColor", &bus, k_cycle_get_32() - start);
+    assertOutputs(10, 20, 30);
+    zassert_equal(bus.transactions, 1, "three intensities in one burst");
+    zassert_equal(bus.bytesWritten, 4);
+
+    emul_lp5817_resetStats(lp5817);
+    start = k_cycle_get_32();
+    zassert_ok(rgbi_setColor(&rgbi, &color));
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_setColor unchanged", &bus, k_cycle_get_32() - start);
+    zassert_equal(bus.transactions, 0, "unchanged color reached the bus");
+
+    emul_lp5817_resetStats(lp5817);
+    start = k_cycle_get_32();
+    zassert_ok(rgbi_setColorFromPixels(&rgbi, 40, 20, 30));
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_setColorFromPixels red", &bus, k_cycle_get_32() - start);
+    assertOutputs(40, 20, 30);
+    zassert_equal(bus.bytesWritten, 2, "only the changed register is written");
+
+    emul_lp5817_resetStats(lp5817);
+    start = k_cycle_get_32();
+    zassert_ok(rgbi_off(&rgbi));
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_off", &bus, k_cycle_get_32() - start);
+    assertOutputs(0, 0, 0);
+}
+
+
+ZTEST(rgb_indicator, test_write_coalescing)
+{
+    static const struct
+    {
+        struct led_rgb color;
+        uint32_t transactions;
+        uint32_t bytesWritten;                          // register address + dirty intensity span
+    } updates[] =
+    {
+        { RGB(10, 20, 30), 1, 4 },
+        { RGB(10, 20, 30), 0, 0 },                      // unchanged
+        { RGB(10, 21, 30), 1, 2 },                      // OUT0 only
+        { RGB(10, 21, 31), 1, 2 },                      // OUT1 only
+        { RGB(11, 22, 31), 1, 4 },                      // OUT0 + OUT2, span includes unchanged OUT1
+        { RGB(12, 22, 31), 1, 2 },                      // OUT2 only
+        { RGB(0, 0, 0), 1, 4 },
+    };
+    emul_lp5817_stats_t bus;
+    uint32_t transactions = 0;
+
+    zassert_ok(rgbi_off(&rgbi));
+    for (size_t i = 0; i < ARRAY_SIZE(updates); i++)
+    {
+        emul_lp5817_resetStats(lp5817);
+        zassert_ok(rgbi_setColor(&rgbi, &updates[i].color));
+        emul_lp5817_getStats(lp5817, &bus);
+        assertOutputs(updates[i].color.r, updates[i].color.g, updates[i].color.b);
+        zassert_equal(bus.transactions, updates[i].transactions, "update %zu: %u transactions", i, bus.transactions);
+        zassert_equal(bus.bytesWritten, updates[i].bytesWritten, "update %zu: %u bytes", i, bus.bytesWritten);
+        transactions += bus.transactions;
+    }
+    TC_PRINT("%zu updates: %u transactions (3 per update unshadowed: %zu)\n", ARRAY_SIZE(updates), transactions,
+             3 * ARRAY_SIZE(updates));
+}
+
+
+ZTEST(rgb_indicator, test_write_retry)
+{
+    rgbi_stats_t stats;
+
+    emul_lp5817_failNext(lp5817, 1);
+    zassert_ok(rgbi_setColorFromPixels(&rgbi, 1, 2, 3), "single NAK not retried");
+    assertOutputs(1, 2, 3);
+
+    rgbi_getStats(&rgbi, &stats);
+    zassert_equal(stats.i2cNaks, 1);
+    zassert_equal(stats.i2cRetries, 1);
+
+    emul_lp5817_failNext(lp5817, CONFIG_RGBINDICATOR_I2C_RETRIES + 1);
+    zassert_not_equal(rgbi_setColorFromPixels(&rgbi, 4, 5, 6), 0, "persistent NAK not reported");
+    zassert_ok(rgbi_setColorFromPixels(&rgbi, 4, 5, 6), "failed write not resent");
+    assertOutputs(4, 5, 6);
+}
+
+
+ZTEST(rgb_indicator, test_flash_count)
+{
+    struct led_rgb color = RGB(0, 64, 0);
+    emul_lp5817_stats_t bus;
+    int64_t started;
+    int64_t elapsed;
+    uint32_t start;
+
+    started = k_uptime_get();
+    start = k_cycle_get_32();
+    rgbi_flash(&rgbi, &color, K_MSEC(FLASH_ON_MS), K_MSEC(FLASH_OFF_MS), FLASH_COUNT);
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_flash (post)", &bus, k_cycle_get_32() - start);
+    zassert_true(rgbi_isBusy(&rgbi), "posted flash not busy");
+
+    zassert_true(waitIdle(2 * FLASH_RUN_MS), "flash did not end");
+    elapsed = k_uptime_get() - started;
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_flash x3 sequence", &bus, 0);
+
+    assertOutputs(0, 0, 0);
+    zassert_equal(bus.transactions, 2 * FLASH_COUNT, "one write per edge");
+    zassert_true(elapsed >= FLASH_RUN_MS - 2 * FLASH_COUNT * CONFIG_RGBINDICATOR_SCHED_COALESCE_MS,      // edges may fire a window early
+                 "sequence ran short, %lld ms", elapsed);
+
+    emul_lp5817_resetStats(lp5817);
+    k_msleep(FLASH_ON_MS + FLASH_OFF_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(bus.transactions, 0, "edge after the sequence ended");
+}
+
+
+ZTEST(rgb_indicator, test_flash_continuous)
+{
+    struct led_rgb color = RGB(64, 0, 64);
+    emul_lp5817_stats_t bus;
+    uint32_t start;
+
+    rgbi_flash_continuous(&rgbi, color, K_MSEC(FLASH_ON_MS / 2), K_MSEC(FLASH_OFF_MS / 2));
+    k_msleep(10 * (FLASH_ON_MS + FLASH_OFF_MS) / 2);
+    zassert_true(rgbi_isBusy(&rgbi), "continuous flash ended");
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_true(bus.transactions >= 16, "only %u edges in 10 periods", bus.transactions);
+    report("rgbi_flash_continuous x10", &bus, 0);
+
+    emul_lp5817_resetStats(lp5817);
+    start = k_cycle_get_32();
+    rgbi_cancel(&rgbi);
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_cancel (post)", &bus, k_cycle_get_32() - start);
+
+    zassert_true(waitIdle(SETTLE_MS), "cancel not applied");
+    k_msleep(FLASH_ON_MS + FLASH_OFF_MS);
+    assertOutputs(0, 0, 0);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_true(bus.transactions <= 1, "edges after cancel");
+}
+
+
+ZTEST(rgb_indicator, test_set_color_replaces_flash)
+{
+    struct led_rgb flash = RGB(255, 255, 255);
+    emul_lp5817_stats_t bus;
+
+    rgbi_flash_continuous(&rgbi, flash, K_MSEC(FLASH_ON_MS / 2), K_MSEC(FLASH_OFF_MS / 2));
+    k_msleep(FLASH_ON_MS / 4);
+    zassert_ok(rgbi_setColorFromPixels(&rgbi, 5, 6, 7), "color not written");
+    assertOutputs(5, 6, 7);                             // written before the call returned
+    zassert_false(rgbi_isBusy(&rgbi), "flash still running");
+
+    emul_lp5817_resetStats(lp5817);
+    k_msleep(FLASH_ON_MS + FLASH_OFF_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(bus.transactions, 0, "flash edge overwrote the color");
+    assertOutputs(5, 6, 7);
+}
+
+
+ZTEST(rgb_indicator, test_off_stops_flash)
+{
+    struct led_rgb flash = RGB(255, 255, 255);
+    emul_lp5817_stats_t bus;
+
+    rgbi_flash_continuous(&rgbi, flash, K_MSEC(FLASH_ON_MS / 2), K_MSEC(FLASH_OFF_MS / 2));
+    k_msleep(FLASH_ON_MS / 4);                                              // ON phase
+    zassert_ok(rgbi_off(&rgbi));
+    assertOutputs(0, 0, 0);
+    zassert_false(rgbi_isBusy(&rgbi), "flash still running");
+
+    emul_lp5817_resetStats(lp5817);
+    k_msleep(FLASH_ON_MS + FLASH_OFF_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(bus.transactions, 0, "flash edge after rgbi_off");
+    assertOutputs(0, 0, 0);
+}
+
+
+ZTEST(rgb_indicator, test_cancel_race)
+{
+    struct led_rgb color = RGB(255, 255, 255);
+    emul_lp5817_stats_t bus;
+
+    for (int round = 0; round < RACE_ROUNDS; round++)
+    {
+        rgbi_flash_continuous(&rgbi, color, K_MSEC(1), K_MSEC(1));
+        if (round & 1)
+        {
+            k_timer_start(&cancelTimer, K_USEC(250 * (round % 8)), K_NO_WAIT);         // ISR cancel, lands on or between edges
+            k_msleep(3);
+        }
+        else
+        {
+            k_busy_wait(250 * (round % 8));
+            rgbi_cancel(&rgbi);                                                        // thread cancel
+        }
+    }
+    zassert_true(waitIdle(SETTLE_MS), "cancel not applied");
+    k_msleep(SETTLE_MS);
+
+    assertOutputs(0, 0, 0);
+    emul_lp5817_resetStats(lp5817);
+    k_msleep(SETTLE_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(bus.transactions, 0, "stale edge turned the indicator back on");
+    zassert_false(rgbi_isBusy(&rgbi));
+}
+
+/* Stress: posting threads at different priorities and a timer ISR hammer the command slot. Once the
+ * threads are joined the ISR posts last, its final command must be what the registers show and the
+ * indicator must go idle with no stale edge.
+ */
+static void stressPoster(void *p1, void *p2, void *p3)
+{
+    uint32_t seed = (uint32_t)(uintptr_t)p1 + 1;
+    uint8_t level = (uint8_t)(0x20 * ((uintptr_t)p1 + 1));
+    struct led_rgb color = RGB(level, 0, 0);
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (!atomic_get(&stressStop))
+    {
+        int result;
+
+        seed = seed * 1103515245U + 12345U;                                     // LCG, op and pause per round
+        switch ((seed >> 16) % 4)
+        {
+            case 0:
+                result = rgbi_setColor(&rgbi, &color);                          // blocks until written or replaced
+                if (result != 0 && result != -ECANCELED)
+                {
+                    atomic_inc(&stressErrors);
+                }
+                break;
+            case 1:
+                rgbi_flash_continuous(&rgbi, color, K_MSEC(1), K_MSEC(1));
+                break;
+            case 2:
+                rgbi_flash(&rgbi, &color, K_MSEC(1), K_MSEC(1), 2);
+                break;
+            default:
+                rgbi_cancel(&rgbi);
+                break;
+        }
+        atomic_inc(&stressPosts);
+        k_usleep((seed >> 8) % 500);
+    }
+}
+
+
+static void stress_expiry(struct k_timer *timer)
+{
+    struct led_rgb color = RGB(0, 0, 0);
+
+    ARG_UNUSED(timer);
+
+    stressIsrRound++;
+    color.g = (uint8_t)(1 + stressIsrRound % 200);
+    stressIsrOp = stressIsrRound % 3;
+    switch (stressIsrOp)
+    {
+        case 0:
+            stressIsrColor = color;
+            (void)rgbi_setColor(&rgbi, &color);                                 // ISR: posted, not waited for
+            break;
+        case 1:
+            rgbi_flash(&rgbi, &color, K_MSEC(1), K_MSEC(1), 2);
+            break;
+        default:
+            rgbi_cancel(&rgbi);
+            break;
+    }
+}
+
+
+ZTEST(rgb_indicator, test_stress_posting)
+{
+    emul_lp5817_stats_t bus;
+    uint32_t isrRounds;
+
+    atomic_clear(&stressStop);
+    atomic_clear(&stressPosts);
+    atomic_clear(&stressErrors);
+    stressIsrRound = 0;
+    k_timer_start(&stressTimer, K_USEC(700), K_USEC(700));
+    for (int i = 0; i < STRESS_THREADS; i++)
+    {
+        k_thread_create(&stressThreads[i], stressStacks[i], K_THREAD_STACK_SIZEOF(stressStacks[i]), stressPoster,
+                        (void *)(uintptr_t)i, NULL, NULL, K_PRIO_PREEMPT(2 + 3 * i), 0, K_NO_WAIT);
+    }
+    k_msleep(STRESS_MS);
+
+    atomic_set(&stressStop, 1);
+    for (int i = 0; i < STRESS_THREADS; i++)
+    {
+        zassert_ok(k_thread_join(&stressThreads[i], K_MSEC(STRESS_MS)), "poster %d stuck", i);
+    }
+    isrRounds = stressIsrRound;
+    while (stressIsrRound == isrRounds)                                         // ISR posts after the last thread post
+    {
+        k_msleep(1);
+    }
+    k_timer_stop(&stressTimer);
+
+    zassert_equal(atomic_get(&stressErrors), 0, "rgbi_setColor failed under contention");
+    zassert_true(waitIdle(SETTLE_MS), "indicator stuck busy");
+    k_msleep(SETTLE_MS);
+    switch (stressIsrOp)
+    {
+        case 0:
+            assertOutputs(stressIsrColor.r, stressIsrColor.g, stressIsrColor.b);
+            break;
+        default:
+            assertOutputs(0, 0, 0);                                             // flash ended, or cancelled
+            break;
+    }
+    emul_lp5817_resetStats(lp5817);
+    k_msleep(SETTLE_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(bus.transactions, 0, "stale edge after the last command");
+    zassert_false(rgbi_isBusy(&rgbi));
+    TC_PRINT("%ld thread posts, %u ISR posts in %u ms, last ISR op %u\n", atomic_get(&stressPosts), stressIsrRound,
+             STRESS_MS, stressIsrOp);
+}
+
+
+ZTEST(rgb_indicator, test_flash_engine)
+{
+#if defined(CONFIG_RGBINDICATOR_AUTONOMOUS)
+    struct led_rgb color = RGB(0, 64, 0);
+    emul_lp5817_stats_t bus;
+
+    zassert_ok(rgbi_setColorFromPixels(&rgbi, 10, 20, 30));                       // showing before the flash
+    emul_lp5817_resetStats(lp5817);
+    rgbi_flash(&rgbi, &color, K_MSEC(ENGINE_STEP_MS + 5), K_MSEC(ENGINE_STEP_MS), FLASH_COUNT);    // within tolerance of a step
+    k_msleep(SETTLE_MS);
+    zassert_true(emul_lp5817_isAnimating(lp5817), "flash not run on the engine");
+
+    zassert_true(waitIdle(4 * FLASH_COUNT * ENGINE_STEP_MS), "flash did not end");
+    k_msleep(SETTLE_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_flash x3 engine", &bus, 0);
+    zassert_false(emul_lp5817_isAnimating(lp5817));
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_AUTOENABLE), 0, "outputs left on the engine");
+    assertOutputs(0, 0, 0);                                                         // not the color from before the flash
+
+    rgbi_flash(&rgbi, &color, K_MSEC(2 * ENGINE_STEP_MS + 40), K_MSEC(ENGINE_STEP_MS), 1);    // 18% off the nearest step
+    k_msleep(SETTLE_MS);
+    zassert_false(emul_lp5817_isAnimating(lp5817), "flash time rounded past the tolerance");
+    assertOutputs(0, 64, 0);
+    zassert_true(waitIdle(8 * ENGINE_STEP_MS), "flash did not end");
+    assertOutputs(0, 0, 0);
+#else
+    ztest_test_skip();
+#endif
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+/* Play a fade from off, poll the red output and check each frame's level and time
+ */
+static void runFade(const rgbi_step_t *pattern, uint8_t levels, uint32_t fadeMs, uint32_t frames)
+{
+    uint32_t frameMs = fadeMs / frames;
+    emul_lp5817_stats_t bus;
+    int64_t last;
+    int64_t end;
+    uint32_t seen = 0;
+    uint8_t red = 0;
+
+    zassert_ok(rgbi_off(&rgbi));
+    emul_lp5817_resetStats(lp5817);
+    zassert_ok(rgbi_play(&rgbi, pattern));
+    last = k_uptime_get();
+    end = last + 2 * fadeMs;
+
+    while (seen < frames && k_uptime_get() < end)
+    {
+        uint8_t now;
+
+        k_msleep(1);
+        now = emul_lp5817_getReg(lp5817, LP5817_REG_INTENSITY2);
+        if (now != red)
+        {
+            int64_t at = k_uptime_get();
+
+            zassert_true(now > red, "fade stepped back, %u after %u", now, red);
+            zassert_within(at - last, frameMs, FRAME_TOL_MS, "frame %u after %lld ms, expected %u", seen, at - last, frameMs);
+            last = at;
+            red = now;
+            seen++;
+        }
+    }
+    zassert_true(waitIdle(SETTLE_MS), "pattern did not end");
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_play fade", &bus, 0);
+    assertOutputs(levels, 0, 0);
+    zassert_equal(seen, frames, "%u frames output", seen);
+    zassert_equal(bus.transactions, frames, "write per output frame only");
+}
+#endif
+
+
+ZTEST(rgb_indicator, test_pattern_fade)
+{
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    runFade(slowFade, 10, 1000, 10);                                                 // frame per level
+    runFade(fastFade, 200, 400, 400 / CONFIG_RGBINDICATOR_SEQUENCER_FRAME_MS);       // frame rate capped
+    TC_PRINT("Pattern cursor %zu bytes per indicator\n", sizeof(rgbi_seqCursor_t));
+#else
+    ztest_test_skip();
+#endif
+}
+
+
+ZTEST(rgb_indicator, test_pattern_repeat)
+{
+#if defined(CONFIG_RGBINDICATOR_SEQUENCER)
+    const uint32_t steps = 2 * (3 * 2 + 2);
+    emul_lp5817_stats_t bus;
+    int64_t started;
+    int64_t elapsed;
+
+    zassert_ok(rgbi_off(&rgbi));
+    emul_lp5817_resetStats(lp5817);
+    started = k_uptime_get();
+    zassert_ok(rgbi_play(&rgbi, nestedRepeat));
+    zassert_true(waitIdle(2 * steps * STEP_MS), "pattern did not end");
+    elapsed = k_uptime_get() - started;
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_play nested repeat", &bus, 0);
+
+    assertOutputs(0, 20, 0);                                                        // left at the last color
+    zassert_equal(bus.transactions, 2 * (3 * 2 + 1), "repeated color written again");
+    zassert_true(elapsed >= steps * (STEP_MS - CONFIG_RGBINDICATOR_SCHED_COALESCE_MS), "pattern ran short, %lld ms", elapsed);
+#else
+    ztest_test_skip();
+#endif
+}
+
+
+ZTEST(rgb_indicator, test_pm_standby)
+{
+#if defined(CONFIG_RGBINDICATOR_PM)
+    struct led_rgb color = RGB(10, 0, 0);
+    bool busPm = pm_device_runtime_usage(rgbSpec.bus) >= 0;             // controller has runtime PM (not the native_sim emulator)
+    emul_lp5817_stats_t bus;
+
+    zassert_ok(rgbi_setColor(&rgbi, &color));
+    zassert_true(!busPm || pm_device_runtime_usage(rgbSpec.bus) == 1, "HX bus not held while lit");
+
+    emul_lp5817_resetStats(lp5817);
+    zassert_ok(rgbi_off(&rgbi));
+    k_msleep(CONFIG_RGBINDICATOR_PM_STANDBY_MS / 2);
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_CHIPENABLE), LP5817_CMD_CHIPENABLE, "standby before the dark time");
+    k_msleep(CONFIG_RGBINDICATOR_PM_STANDBY_MS / 2 + SETTLE_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_off + standby", &bus, 0);
+    zassert_equal(emul_lp5817_getReg(lp5817, LP5817_REG_CHIPENABLE), 0, "not in standby");
+    zassert_equal(bus.chipDisables, 1);
+    zassert_equal(bus.transactions, 2, "off and standby writes only");
+    zassert_true(!busPm || pm_device_runtime_usage(rgbSpec.bus) == 0, "HX bus held in standby");
+
+    emul_lp5817_resetStats(lp5817);
+    k_msleep(CONFIG_RGBINDICATOR_PM_STANDBY_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(bus.transactions, 0, "bus traffic in standby");
+
+    zassert_ok(rgbi_setColor(&rgbi, &color));
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_setColor from standby", &bus, 0);
+    assertOutputs(10, 0, 0);
+    zassert_equal(bus.chipEnables, 1);
+    zassert_equal(bus.transactions, 2, "wake is more than one write");
+    zassert_equal(bus.bytesWritten, 2 + 2, "wake restored retained registers");
+    zassert_equal(bus.updateCmds, 0, "retained configuration latched again");
+
+    emul_lp5817_resetStats(lp5817);
+    rgbi_flash(&rgbi, &color, K_MSEC(FLASH_ON_MS), K_MSEC(FLASH_OFF_MS), FLASH_COUNT);
+    zassert_true(waitIdle(2 * FLASH_RUN_MS), "flash did not end");
+    emul_lp5817_getStats(lp5817, &bus);
+    zassert_equal(bus.chipDisables + bus.chipEnables, 0, "flash OFF phase cycled the chip");
+    k_msleep(CONFIG_RGBINDICATOR_PM_STANDBY_MS + SETTLE_MS);
+    emul_lp5817_getStats(lp5817, &bus);
+    report("rgbi_flash x3 + standby", &bus, 0);
+    zassert_equal(bus.chipDisables, 1, "no standby after the flash");
+    TC_PRINT("HX bus runtime PM %s\n", busPm ? "checked" : "not supported by the controller, not checked");
+#else
+    ztest_test_skip();
+#endif
+}
+
+
+ZTEST(rgb_indicator, test_arbiter_same_request)
+{
+#if defined(CONFIG_RGBINDICATOR_ARBITER)
+    static rgbi_slot_t slot;
+    struct led_rgb color = RGB(0, 0, 64);
+    struct led_rgb other = RGB(0, 64, 0);
+
+    zassert_ok(rgbi_slotInit(&rgbi, &slot, 1));
+    rgbi_slotFlash(&slot, &color, K_MSEC(FLASH_ON_MS), K_MSEC(FLASH_OFF_MS), 0, K_FOREVER);
+    k_msleep(FLASH_ON_MS / 2);
+    assertOutputs(0, 0, 64);
+    rgbi_slotFlash(&slot, &color, K_MSEC(FLASH_ON_MS), K_MSEC(FLASH_OFF_MS), 0, K_FOREVER);     // same request again
+    k_msleep(FLASH_ON_MS / 2 + FLASH_OFF_MS / 4);
+    assertOutputs(0, 0, 0);                             // still ON if the repeat was posted and restarted the flash
+
+    rgbi_slotColor(&slot, &other, K_FOREVER);
+    k_msleep(SETTLE_MS);
+    assertOutputs(0, 64, 0);
+    rgbi_slotRelease(&slot);
+    k_msleep(SETTLE_MS);
+    assertOutputs(0, 0, 0);
+#else
+    ztest_test_skip();
+#endif
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT) && !defined(CONFIG_RGBINDICATOR_WORKQUEUE)
+static rgb_indicator_t lateRgbi;                        // initialized by a system workqueue item
+static int lateInitResult;
+static int lateSetResult;
+
+static void lateInit_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    lateInitResult = rgbi_init(&rgbSpec, &lateRgbi);
+    lateSetResult = rgbi_setColorFromPixels(&lateRgbi, 1, 1, 1);   // configuration is queued behind this item
+}
+
+static K_WORK_DEFINE(lateInit, lateInit_handler);
+#endif
+
+
+ZTEST(rgb_indicator, test_init_from_workqueue)
+{
+#if defined(CONFIG_RGBINDICATOR_DEFERRED_INIT) && !defined(CONFIG_RGBINDICATOR_WORKQUEUE)
+    struct k_work_sync sync;
+
+    k_work_submit(&lateInit);
+    (void)k_work_flush(&lateInit, &sync);
+    zassert_ok(rgbi_waitReady(&lateRgbi, K_SECONDS(1)), "configuration blocked by the waiting work item");
+    zassert_ok(lateInitResult);
+    zassert_equal(lateSetResult, -EAGAIN, "work item waited on its own queue");
+    zassert_ok(rgbi_setColorFromPixels(&lateRgbi, 0, 0, 0));
+#else
+    ztest_test_skip();
+#endif
+}
+
+
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+static int storedRecord(const char *key, size_t len, settings_read_cb readCb, void *cbArg, void *param)
+{
+    uint8_t *brightness = param;
+    uint8_t rec[32];
+    const char *next;
+
+    if (settings_name_steq(key, "cal", &next) && next == NULL && len > 0 && len <= sizeof(rec) &&
+        readCb(cbArg, rec, len) == (ssize_t)len)
+    {
+        *brightness = rec[len - 1];                     // record ends with the brightness
+    }
+    return 0;
+}
+#endif
+
+
+ZTEST(rgb_indicator, test_settings_key)
+{
+#if defined(CONFIG_RGBINDICATOR_SETTINGS)
+    char subtree[SETTINGS_MAX_NAME_LEN + 1];
+    uint8_t stored = 0;
+    uint8_t unscoped = 0;
+
+    zassert_ok(rgbi_setBrightness(&rgbi, 77));
+    zassert_ok(rgbi_settingsFlush(&rgbi));
+
+    snprintf(subtree, sizeof(subtree), "rgbi/%s/%02x", rgbSpec.bus->name, rgbSpec.addr);
+    zassert_ok(settings_load_subtree_direct(subtree, storedRecord, &stored));
+    zassert_equal(stored, 77, "record not stored under %s", subtree);
+    zassert_ok(settings_load_subtree_direct("rgbi/2d", storedRecord, &unscoped));
+    zassert_equal(unscoped, 0, "record stored without the bus");
+
+    zassert_ok(rgbi_setBrightness(&rgbi, UINT8_MAX));
+    zassert_ok(rgbi_settingsFlush(&rgbi));
+#else
+    ztest_test_skip();
+#endif
+}
+
+
+static void *setup(void)
+{
+    uint32_t start;
+
+    emul_lp5817_resetStats(lp5817);
+    start = k_cycle_get_32();
+    initResult = rgbi_init(&rgbSpec, &rgbi);
+    initCallCycles = k_cycle_get_32() - start;
+    if (initResult == 0)
+    {
+        initResult = rgbi_waitReady(&rgbi, K_SECONDS(1));
+    }
+    initReadyCycles = k_cycle_get_32() - start;
+    emul_lp5817_getStats(lp5817, &initBus);
+    return NULL;
+}
+
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    zassume_ok(initResult, "indicator not initialized");
+    rgbi_cancel(&rgbi);
+    (void)waitIdle(SETTLE_MS);
+#if defined(CONFIG_RGBINDICATOR_PM)
+    (void)rgbi_setColorFromPixels(&rgbi, 1, 1, 1);      // start awake, standby is CONFIG_RGBINDICATOR_PM_STANDBY_MS away
+    (void)rgbi_off(&rgbi);
+#endif
+    k_msleep(1);
+    emul_lp5817_resetStats(lp5817);
+    rgbi_resetStats(&rgbi);
+}
+
+ZTEST_SUITE(rgb_indicator, NULL, setup, before, NULL, NULL);
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* SPI stream on a loopback controller (native_sim, src/spi_loopback.c). Every stream block is
+ * filled with the controller's transfer number, consecutive blocks must count up by one. The
+ * throughput case reports the stream rate against the configured SPI clock, the slow consumer
+ * case releases blocks from thread and ISR context across the whole transfer window so a release
+ * that races the stall is seen as a stream that never resumes.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/spi.h>
+
+#include "spi-stream.h"
+#include "spi_loopback.h"
+
+#define BLOCK_LEN 1024
+#define STREAM_BLOCKS 100
+#define RACE_BLOCKS 200
+#define BLOCK_US ((uint32_t)(((uint64_t)(BLOCK_LEN + sizeof(readCmd)) * 8 * USEC_PER_SEC) / CONFIG_SPISTREAM_FREQUENCY))
+#define GET_TIMEOUT_MS 100                              // many block times, a stream that stalls for good fails the get
+
+static const struct device *spiDev = DEVICE_DT_GET(DT_NODELABEL(spi1));
+static const uint8_t readCmd[4] = { 0x03, 0x00, 0x00, 0x00 };
+static const spis_streamConfig_t streamConfig = { .cmd = readCmd, .cmdLen = sizeof(readCmd), .blockLen = BLOCK_LEN };
+
+static void release_expiry(struct k_timer *timer);
+static K_TIMER_DEFINE(releaseTimer, release_expiry, NULL);
+static const uint8_t *releaseBlock;                     // released by the timer ISR
+
+
+static void release_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    spis_streamRelease(releaseBlock);
+}
+
+
+/* Next block, checks it follows the previous one
+ */
+static void getBlock(const uint8_t **block, int *seq)
+{
+    int len = spis_streamGet(block, K_MSEC(GET_TIMEOUT_MS));
+
+    zassert_equal(len, BLOCK_LEN, "no block, stream stalled (%d)", len);
+    zassert_equal((*block)[0], (*block)[BLOCK_LEN - 1], "block torn");
+    if (*seq >= 0)
+    {
+        zassert_equal((*block)[0], (uint8_t)(*seq + 1), "block dropped or repeated");
+    }
+    *seq = (*block)[0];
+}
+
+
+ZTEST(spi_stream, test_stream_throughput)
+{
+    spis_stats_t stats;
+    int seq = -1;
+
+    zassert_ok(spis_streamStart(&streamConfig));
+    for (int i = 0; i < STREAM_BLOCKS; i++)
+    {
+        const uint8_t *block;
+
+        getBlock(&block, &seq);
+        spis_streamRelease(block);
+    }
+    zassert_ok(spis_streamStop());
+    spis_getStats(&stats);
+
+    zassert_true(stats.blocks >= STREAM_BLOCKS);
+    zassert_equal(stats.errors, 0);
+    TC_PRINT("Stream %u x %u bytes at %u Hz: %u B/s (clock limit %u B/s), bus busy %u%%, stalls %u\n",
+             stats.blocks, BLOCK_LEN, CONFIG_SPISTREAM_FREQUENCY, stats.throughputBps, CONFIG_SPISTREAM_FREQUENCY / 8,
+             (uint32_t)((uint64_t)stats.busyUs * 100 / MAX(stats.elapsedUs, 1)), stats.stalls);
+}
+
+
+ZTEST(spi_stream, test_slow_consumer)
+{
+    const uint8_t *held = NULL;
+    spis_stats_t stats;
+    int seq = -1;
+
+    zassert_ok(spis_streamStart(&streamConfig));
+    for (int i = 0; i < RACE_BLOCKS; i++)
+    {
+        const uint8_t *block;
+
+        getBlock(&block, &seq);                         // both buffers held: the next transfer stalls
+
+        if (held != NULL)
+        {
+            uint32_t delayUs = (i * 37) % (2 * BLOCK_US);
+
+            if (i & 1)
+            {
+                releaseBlock = held;
+                k_timer_start(&releaseTimer, K_USEC(delayUs), K_NO_WAIT);      // ISR release
+            }
+            else
+            {
+                k_busy_wait(delayUs);
+                spis_streamRelease(held);                                       // thread release
+            }
+        }
+        held = block;
+        k_timer_status_sync(&releaseTimer);                                    // no-op unless armed above
+    }
+    spis_streamRelease(held);
+    zassert_ok(spis_streamStop());
+    spis_getStats(&stats);
+
+    zassert_true(stats.stalls > 0, "consumer never held the stream back");
+    zassert_equal(stats.errors, 0);
+    TC_PRINT("Slow consumer: %u blocks, %u stalls, %u B/s\n", stats.blocks, stats.stalls, stats.throughputBps);
+}
+
+
+ZTEST(spi_stream, test_batch)
+{
+    const uint8_t txA[3] = { 0x11, 0x22, 0x33 };
+    const uint8_t txB[2] = { 0x44, 0x55 };
+    uint8_t rxA[3] = { 0 };
+    uint8_t rxB[2] = { 0 };
+    uint8_t rxC[4] = { 0 };
+    spis_batch_t batch;
+    spis_stats_t stats;
+    uint32_t transfers;
+
+    spis_batchInit(&batch);
+    zassert_ok(spis_batchAdd(&batch, txA, rxA, sizeof(rxA)));
+    zassert_ok(spis_batchAdd(&batch, txB, rxB, sizeof(rxB)));
+    zassert_ok(spis_batchAdd(&batch, NULL, rxC, sizeof(rxC)));
+
+    transfers = spi_loopback_transfers(spiDev);
+    zassert_ok(spis_batchRun(&batch));
+    zassert_equal(spi_loopback_transfers(spiDev), transfers + 1, "batch not run under one CS assertion");
+    zassert_mem_equal(rxA, txA, sizeof(txA));
+    zassert_mem_equal(rxB, txB, sizeof(txB));
+    zassert_equal(rxC[0], (uint8_t)transfers, "read-only transaction not clocked");
+
+    spis_getStats(&stats);
+    zassert_equal(stats.batches, 1);
+    zassert_equal(stats.transactions, 3);
+    zassert_equal(stats.bytes, sizeof(txA) + sizeof(txB) + sizeof(rxC));
+
+    zassert_ok(spis_streamStart(&streamConfig));
+    zassert_equal(spis_batchRun(&batch), -EBUSY, "batch run over a stream");
+    zassert_ok(spis_streamStop());
+}
+
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    zassume_true(device_is_ready(spiDev), "loopback controller not ready");
+    spis_resetStats();
+}
+
+ZTEST_SUITE(spi_stream, NULL, NULL, before, NULL, NULL);
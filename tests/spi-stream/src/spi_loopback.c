@@ -0,0 +1,201 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* SPI loopback controller for the native_sim tests. Received bytes echo the sent bytes, bytes
+ * clocked past the sent data (stream block payload) read as the low byte of the transfer sequence
+ * number, so a consumer can spot a dropped or repeated block. A transfer takes the time its bytes
+ * need at the configured clock: busy wait for the blocking call, a kernel timer completing the
+ * asynchronous call from ISR context as the SPIM END interrupt does on the board.
+ */
+
+#define DT_DRV_COMPAT loouq_spi_loopback
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/spi.h>
+
+#include "spi_loopback.h"
+
+typedef struct _loopbackCursor
+{
+    const struct spi_buf_set *set;                      // can be NULL
+    size_t buf;
+    size_t off;
+} loopbackCursor_t;
+
+struct loopbackData
+{
+    const struct device *dev;
+    struct k_timer timer;                               // completes the asynchronous transfer
+    spi_callback_t callback;                            // NULL when no asynchronous transfer in flight
+    void *userData;
+    uint32_t transfers;
+};
+
+
+/**
+ * @brief Step a cursor one byte through a buffer set
+ *
+ * @param cursor Position in the set
+ * @param pos Returns the byte address, NULL for a buffer without data (fill or discard)
+ * @return true if a byte was taken, false at the end of the set
+ */
+static bool cursorNext(loopbackCursor_t *cursor, uint8_t **pos)
+{
+    while (cursor->set != NULL && cursor->buf < cursor->set->count)
+    {
+        const struct spi_buf *buf = &cursor->set->buffers[cursor->buf];
+
+        if (cursor->off < buf->len)
+        {
+            *pos = (buf->buf != NULL) ? (uint8_t *)buf->buf + cursor->off : NULL;
+            cursor->off++;
+            return true;
+        }
+        cursor->buf++;
+        cursor->off = 0;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Clock the buffers through the loop
+ *
+ * @return Bus time of the transfer in microseconds
+ */
+static uint32_t loopbackRun(struct loopbackData *data, const struct spi_config *config,
+                            const struct spi_buf_set *txBufs, const struct spi_buf_set *rxBufs)
+{
+    loopbackCursor_t tx = { .set = txBufs };
+    loopbackCursor_t rx = { .set = rxBufs };
+    uint8_t fill = (uint8_t)data->transfers;
+    size_t bytes = 0;
+
+    while (true)
+    {
+        uint8_t *txPos = NULL;
+        uint8_t *rxPos = NULL;
+        bool haveTx = cursorNext(&tx, &txPos);
+        bool haveRx = cursorNext(&rx, &rxPos);
+
+        if (!haveTx && !haveRx)
+        {
+            break;
+        }
+        if (rxPos != NULL)
+        {
+            *rxPos = (txPos != NULL) ? *txPos : fill;
+        }
+        bytes++;
+    }
+    data->transfers++;
+    return (uint32_t)(((uint64_t)bytes * 8 * USEC_PER_SEC) / MAX(config->frequency, 1));
+}
+
+
+static int loopback_transceive(const struct device *dev, const struct spi_config *config,
+                               const struct spi_buf_set *txBufs, const struct spi_buf_set *rxBufs)
+{
+    struct loopbackData *data = dev->data;
+    unsigned int key = irq_lock();
+    uint32_t us;
+
+    if (data->callback != NULL)
+    {
+        irq_unlock(key);
+        return -EBUSY;
+    }
+    us = loopbackRun(data, config, txBufs, rxBufs);
+    irq_unlock(key);
+
+    k_busy_wait(us);
+    return 0;
+}
+
+
+#if defined(CONFIG_SPI_ASYNC)
+static int loopback_transceiveAsync(const struct device *dev, const struct spi_config *config,
+                                    const struct spi_buf_set *txBufs, const struct spi_buf_set *rxBufs,
+                                    spi_callback_t callback, void *userData)
+{
+    struct loopbackData *data = dev->data;
+    unsigned int key = irq_lock();
+    uint32_t us;
+
+    if (data->callback != NULL || callback == NULL)
+    {
+        irq_unlock(key);
+        return (callback == NULL) ? -EINVAL : -EBUSY;
+    }
+    us = loopbackRun(data, config, txBufs, rxBufs);
+    data->callback = callback;
+    data->userData = userData;
+    irq_unlock(key);
+
+    k_timer_start(&data->timer, K_USEC(us), K_NO_WAIT);
+    return 0;
+}
+#endif
+
+
+static int loopback_release(const struct device *dev, const struct spi_config *config)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(config);
+
+    return 0;
+}
+
+
+static void loopback_expiry(struct k_timer *timer)
+{
+    struct loopbackData *data = CONTAINER_OF(timer, struct loopbackData, timer);
+    unsigned int key = irq_lock();
+    spi_callback_t callback = data->callback;
+    void *userData = data->userData;
+
+    data->callback = NULL;                              // callback may start the next transfer
+    irq_unlock(key);
+
+    if (callback != NULL)
+    {
+        callback(data->dev, 0, userData);
+    }
+}
+
+
+uint32_t spi_loopback_transfers(const struct device *dev)
+{
+    return ((struct loopbackData *)dev->data)->transfers;
+}
+
+
+static int loopback_init(const struct device *dev)
+{
+    struct loopbackData *data = dev->data;
+
+    data->dev = dev;
+    k_timer_init(&data->timer, loopback_expiry, NULL);
+    return 0;
+}
+
+
+static const struct spi_driver_api loopbackApi = {
+    .transceive = loopback_transceive,
+#if defined(CONFIG_SPI_ASYNC)
+    .transceive_async = loopback_transceiveAsync,
+#endif
+    .release = loopback_release,
+};
+
+#define LOOPBACK_DEFINE(inst)                                                                       \
+    static struct loopbackData loopbackData_##inst;                                                 \
+    DEVICE_DT_INST_DEFINE(inst, loopback_init, NULL, &loopbackData_##inst, NULL, POST_KERNEL,       \
+                          CONFIG_SPI_INIT_PRIORITY, &loopbackApi);
+
+DT_INST_FOREACH_STATUS_OKAY(LOOPBACK_DEFINE)
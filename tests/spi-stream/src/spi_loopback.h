@@ -0,0 +1,17 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SPI_LOOPBACK_H
+#define SPI_LOOPBACK_H
+
+#include <zephyr/device.h>
+
+/**
+ * @brief Transfers (CS assertions) run by the loopback controller since boot
+ */
+uint32_t spi_loopback_transfers(const struct device *dev);
+
+#endif  // SPI_LOOPBACK_H
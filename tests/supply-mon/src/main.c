@@ -0,0 +1,227 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Supply monitor on native_sim against the ADC emulator: batch summaries and trend from a known
+ * input ramp, stop and restart, and the monitor thread wakeup count against the samples taken.
+ * The thread switch-ins are counted from the tracing hooks, independent of the monitor counters.
+ * The split variant limits the ADC hold time so each batch takes several sequences.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/adc.h>
+#include <zephyr/drivers/adc/adc_emul.h>
+#include <zephyr/sys/atomic.h>
+
+#include "supply-mon.h"
+
+#define BATCH CONFIG_SUPPLYMON_BATCH
+#define INTERVAL_MS CONFIG_SUPPLYMON_INTERVAL_MS
+#define BATCH_MS ((BATCH - 1) * INTERVAL_MS)            // first sampling at the sequence start
+#define SEQ_SAMPLES MIN(BATCH, CONFIG_SUPPLYMON_ADC_HOLD_MAX_MS / INTERVAL_MS + 1)
+#define SEQUENCES DIV_ROUND_UP(BATCH, SEQ_SAMPLES)      // ADC sequences per batch
+#define TICK_MS (1 + MSEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+#define WAIT_MS (2 * BATCH_MS + INTERVAL_MS)
+#define RAMP_BASE_MV 1000                               // ADC input, first sampling of every batch
+#define RAMP_STEP_MV 10                                 // added per sampling within a batch
+#define STEP_MV 200                                     // input step from batch 3
+#define STEP_BATCH 3
+#define BENCH_BATCHES 8
+#define SUMMARIES_MAX 8
+
+#define REPORTED(mv) ((int32_t)(mv) * CONFIG_SUPPLYMON_SCALE_PERMILLE / 1000)
+
+static const struct device *adc = DEVICE_DT_GET(DT_PARENT(DT_NODELABEL(supply)));
+static const uint8_t channel = DT_REG_ADDR(DT_NODELABEL(supply));
+static K_SEM_DEFINE(summaryReady, 0, SUMMARIES_MAX);
+static smon_summary_t summaries[SUMMARIES_MAX];
+static int64_t summaryAt[SUMMARIES_MAX];
+static atomic_t summaryCount;
+static atomic_t conversions;                           // emulator conversions since the last before()
+static atomic_t switchIns;                             // monitor thread switched in
+static k_tid_t smonThread;
+
+
+/* Emulated input: a ramp within each batch, stepped up by STEP_MV from batch STEP_BATCH
+ */
+static int supplyInput(const struct device *dev, unsigned int chan, void *data, uint32_t *result)
+{
+    uint32_t k = (uint32_t)atomic_inc(&conversions);
+
+    ARG_UNUSED(dev);
+    ARG_UNUSED(chan);
+    ARG_UNUSED(data);
+
+    *result = RAMP_BASE_MV + (k % BATCH) * RAMP_STEP_MV + ((k >= (STEP_BATCH - 1) * BATCH) ? STEP_MV : 0);
+    return 0;
+}
+
+
+static void onSummary(const smon_summary_t *summary, void *userData)
+{
+    atomic_val_t n = atomic_inc(&summaryCount);
+
+    ARG_UNUSED(userData);
+
+    if (n < SUMMARIES_MAX)
+    {
+        summaries[n] = *summary;
+        summaryAt[n] = k_uptime_get();
+    }
+    k_sem_give(&summaryReady);
+}
+
+
+void sys_trace_thread_switched_in_user(void)
+{
+    if (smonThread != NULL && k_current_get() == smonThread)
+    {
+        atomic_inc(&switchIns);
+    }
+}
+
+
+static void findMonitor(const struct k_thread *thread, void *userData)
+{
+    ARG_UNUSED(userData);
+
+    if (strcmp(k_thread_name_get((k_tid_t)thread), "smon") == 0)
+    {
+        smonThread = (k_tid_t)thread;
+    }
+}
+
+
+/* Wait for summaries, count of them taken from the start of the test
+ */
+static void waitSummaries(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        zassert_ok(k_sem_take(&summaryReady, K_MSEC(WAIT_MS)), "summary %d not delivered", i + 1);
+    }
+}
+
+
+/* Expected summary of the ramp in a batch (1=first), trend from the previous one
+ */
+static void assertBatch(const smon_summary_t *summary, uint32_t batch, int32_t prevTrendMv)
+{
+    int32_t offsetMv = (batch >= STEP_BATCH) ? STEP_MV : 0;
+    int32_t minMv = REPORTED(RAMP_BASE_MV + offsetMv);
+    int32_t maxMv = REPORTED(RAMP_BASE_MV + offsetMv + (BATCH - 1) * RAMP_STEP_MV);
+    int32_t avgMv = REPORTED(RAMP_BASE_MV + offsetMv + (BATCH - 1) * RAMP_STEP_MV / 2);
+    int32_t trendMv = (batch == 1) ? avgMv : prevTrendMv + (avgMv - prevTrendMv) / (1 << CONFIG_SUPPLYMON_FILTER_SHIFT);
+
+    zassert_equal(summary->batch, batch);
+    zassert_equal(summary->samples, BATCH);
+    zassert_equal(summary->minMv, minMv, "batch %u: min %d mV", batch, summary->minMv);
+    zassert_equal(summary->maxMv, maxMv, "batch %u: max %d mV", batch, summary->maxMv);
+    zassert_equal(summary->avgMv, avgMv, "batch %u: avg %d mV", batch, summary->avgMv);
+    zassert_equal(summary->trendMv, trendMv, "batch %u: trend %d mV", batch, summary->trendMv);
+}
+
+
+ZTEST(supply_mon, test_batch_summary)
+{
+    smon_summary_t latest;
+    int32_t trendMv = 0;
+
+    zassert_ok(smon_start());
+    zassert_equal(smon_start(), -EALREADY);
+    waitSummaries(STEP_BATCH + 1);
+    zassert_ok(smon_getSummary(&latest));
+
+    for (uint32_t i = 0; i < STEP_BATCH + 1; i++)
+    {
+        assertBatch(&summaries[i], i + 1, trendMv);
+        trendMv = summaries[i].trendMv;
+    }
+    for (uint32_t i = 1; i < STEP_BATCH + 1; i++)
+    {
+        int64_t periodMs = summaryAt[i] - summaryAt[i - 1];
+
+        zassert_true(periodMs >= BATCH_MS && periodMs <= BATCH_MS + INTERVAL_MS + TICK_MS,
+                     "batch %u: %lld ms after the previous", i + 1, periodMs);
+    }
+    zassert_mem_equal(&latest, &summaries[STEP_BATCH], sizeof(latest), "latest summary not kept");
+    TC_PRINT("Step of %d mV reported: avg %d -> %d mV, trend %d -> %d mV\n", REPORTED(STEP_MV),
+             summaries[STEP_BATCH - 2].avgMv, summaries[STEP_BATCH - 1].avgMv, summaries[STEP_BATCH - 2].trendMv,
+             summaries[STEP_BATCH - 1].trendMv);
+}
+
+
+ZTEST(supply_mon, test_stop_restart)
+{
+    smon_stats_t stats;
+
+    zassert_ok(smon_start());
+    waitSummaries(1);
+    smon_stop();
+    k_msleep(WAIT_MS);
+    smon_getStats(&stats);
+    zassert_true(atomic_get(&summaryCount) <= 2, "%ld summaries after the stop", atomic_get(&summaryCount) - 1);
+    zassert_equal(stats.batches, atomic_get(&summaryCount));
+    zassert_equal(stats.errors, 0);
+
+    k_sem_reset(&summaryReady);
+    atomic_set(&summaryCount, 0);
+    atomic_set(&conversions, 0);
+    zassert_ok(smon_start());
+    waitSummaries(1);
+    assertBatch(&summaries[0], 1, 0);                                       // batch count and trend restarted
+}
+
+
+ZTEST(supply_mon, test_wakeups)
+{
+    smon_stats_t stats;
+    uint32_t switched;
+
+    zassume_not_null(smonThread, "monitor thread not found");
+    atomic_set(&switchIns, 0);
+    zassert_ok(smon_start());
+    waitSummaries(BENCH_BATCHES);
+    smon_getStats(&stats);
+    switched = (uint32_t)atomic_get(&switchIns);
+
+    zassert_equal(stats.batches, BENCH_BATCHES);
+    zassert_equal(stats.samples, BENCH_BATCHES * BATCH);
+    zassert_equal(stats.wakeups, stats.batches * SEQUENCES, "more than one wakeup per sequence");
+    zassert_equal(stats.errors, 0);
+    zassert_true(switched <= 2 * SEQUENCES * BENCH_BATCHES + 1,            // start, then per sequence its end and the resume after
+                 "monitor thread switched in %u times", switched);
+    TC_PRINT("%u samplings in %u batches of %u, %u ms apart, %u sequences per batch\n", stats.samples, stats.batches,
+             BATCH, INTERVAL_MS, SEQUENCES);
+    TC_PRINT("  monitor thread: %u wakeups, %u switch-ins (%u per 100 samplings, one-shot polling: 100)\n",
+             stats.wakeups, switched, switched * 100U / stats.samples);
+}
+
+
+static void *setup(void)
+{
+    k_thread_foreach(findMonitor, NULL);
+    smon_setCallback(onSummary, NULL);
+    return NULL;
+}
+
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    zassume_true(device_is_ready(adc), "ADC emulator not ready");
+    smon_stop();
+    k_msleep(WAIT_MS);                                                      // batch in progress completes
+    zassume_ok(adc_emul_value_func_set(adc, channel, supplyInput, NULL));
+    k_sem_reset(&summaryReady);
+    atomic_set(&summaryCount, 0);
+    atomic_set(&conversions, 0);
+    smon_resetStats();
+}
+
+ZTEST_SUITE(supply_mon, NULL, setup, before, NULL, NULL);
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Trace pin markers on native_sim: pin levels on the emulated GPIO controller and the recorded
+ * edge timeline read back from the host file, edge times against the sleeps between markers.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+
+#include "trace-pins.h"
+#include "timeline_native.h"
+
+#define GAP_MS 10
+#define TICK_NS (NSEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+#define TIMELINE_SIZE CONFIG_TRACEPINS_RECORD_BUFFER
+#define TIMELINE_HEADER "time_ns,pin,level\n"
+#define EDGES_MAX 8
+
+static const struct gpio_dt_spec pinA = GPIO_DT_SPEC_GET(TPIN_POINT(tp_a), gpios);
+static const struct gpio_dt_spec pinB = GPIO_DT_SPEC_GET(TPIN_POINT(tp_b), gpios);
+static char timeline[TIMELINE_SIZE];
+
+typedef struct
+{
+    uint64_t timeNs;
+    char pin[8];
+    int level;
+} edge_t;
+
+
+/* Parse timeline lines (time_ns,pin,level), returns the number of edges
+ */
+static size_t parseEdges(const char *text, edge_t *edges, size_t max)
+{
+    size_t count = 0;
+
+    while (*text != '\0' && count < max)
+    {
+        char *field;
+        const char *comma;
+        size_t nameLen;
+
+        edges[count].timeNs = strtoull(text, &field, 10);
+        comma = strchr(++field, ',');
+        if (comma == NULL)
+        {
+            break;
+        }
+        nameLen = MIN((size_t)(comma - field), sizeof(edges[count].pin) - 1);
+        memcpy(edges[count].pin, field, nameLen);
+        edges[count].pin[nameLen] = '\0';
+        edges[count].level = (int)strtol(comma + 1, &field, 10);
+        count++;
+        text = (*field == '\n') ? field + 1 : field;
+    }
+    return count;
+}
+
+
+ZTEST(trace_pins, test_marker_levels)
+{
+    TPIN_ON(tp_a);
+    zassert_equal(gpio_emul_output_get(pinA.port, pinA.pin), 1);
+    zassert_equal(gpio_emul_output_get(pinB.port, pinB.pin), 0, "marker drove the wrong pin");
+    TPIN_OFF(tp_a);
+    zassert_equal(gpio_emul_output_get(pinA.port, pinA.pin), 0);
+
+    TPIN_TOGGLE(tp_b);
+    zassert_equal(gpio_emul_output_get(pinB.port, pinB.pin), 1);
+    TPIN_TOGGLE(tp_b);
+    zassert_equal(gpio_emul_output_get(pinB.port, pinB.pin), 0);
+
+    zassert_false(TPIN_EXISTS(tp_unassigned));
+    TPIN_ON(tp_unassigned);                                                 // no pin, compiles to nothing
+}
+
+
+ZTEST(trace_pins, test_record_timeline)
+{
+    edge_t edges[EDGES_MAX];
+    int start;
+    int len;
+    size_t count;
+
+    tpin_flush();
+    start = timeline_nativeRead(CONFIG_TRACEPINS_RECORD_FILE, timeline, sizeof(timeline));
+    zassert_true(start >= (int)strlen(TIMELINE_HEADER), "timeline file not created");
+    zassert_mem_equal(timeline, TIMELINE_HEADER, strlen(TIMELINE_HEADER));
+
+    TPIN_ON(tp_a);
+    k_msleep(GAP_MS);
+    TPIN_ON(tp_b);
+    k_msleep(GAP_MS);
+    TPIN_OFF(tp_a);
+    TPIN_OFF(tp_b);
+
+    len = timeline_nativeRead(CONFIG_TRACEPINS_RECORD_FILE, timeline, sizeof(timeline));
+    zassert_equal(len, start, "edges written before the flush");
+    tpin_flush();
+    len = timeline_nativeRead(CONFIG_TRACEPINS_RECORD_FILE, timeline, sizeof(timeline));
+    zassert_true(len > start && len < (int)sizeof(timeline) - 1);
+
+    count = parseEdges(&timeline[start], edges, ARRAY_SIZE(edges));
+    zassert_equal(count, 4, "%zu edges recorded", count);
+    zassert_str_equal(edges[0].pin, "tp-a");
+    zassert_equal(edges[0].level, 1);
+    zassert_str_equal(edges[1].pin, "tp-b");
+    zassert_equal(edges[1].level, 1);
+    zassert_str_equal(edges[2].pin, "tp-a");
+    zassert_equal(edges[2].level, 0);
+    zassert_str_equal(edges[3].pin, "tp-b");
+    zassert_equal(edges[3].level, 0);
+
+    for (size_t i = 1; i < 3; i++)
+    {
+        uint64_t gapNs = edges[i].timeNs - edges[i - 1].timeNs;
+
+        zassert_true(gapNs >= GAP_MS * NSEC_PER_MSEC && gapNs <= GAP_MS * NSEC_PER_MSEC + 2 * TICK_NS,
+                     "edge %zu: %llu ns after the previous", i, (unsigned long long)gapNs);
+    }
+    zassert_equal(edges[3].timeNs, edges[2].timeNs, "simulated time advanced without a sleep");
+}
+
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    TPIN_OFF(tp_a);
+    TPIN_OFF(tp_b);
+    tpin_flush();
+}
+
+ZTEST_SUITE(trace_pins, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "timeline_native.h"
+
+
+int timeline_nativeRead(const char *path, char *buf, size_t size)
+{
+    int fd = (size > 0) ? open(path, O_RDONLY) : -1;
+    size_t len = 0;
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+    while (len < size - 1)
+    {
+        ssize_t got = read(fd, &buf[len], size - 1 - len);
+
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            break;
+        }
+        len += (size_t)got;
+    }
+    buf[len] = '\0';
+    (void)close(fd);
+    return (int)len;
+}
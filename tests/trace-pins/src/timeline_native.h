@@ -0,0 +1,25 @@
+/*
+ * Copyright 2025 LooUQ Incorporated
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TIMELINE_NATIVE_H
+#define TIMELINE_NATIVE_H
+
+#include <stddef.h>
+
+/* Host side of the timeline read back (built into the native_simulator runner, host libc)
+ */
+
+/**
+ * @brief Read a host file from its start
+ *
+ * @param path File path, relative to the working directory of the simulator
+ * @param buf Destination, NUL terminated
+ * @param size Destination size
+ * @return int Bytes read (excluding the NUL), <0 on error
+ */
+int timeline_nativeRead(const char *path, char *buf, size_t size);
+
+#endif  // TIMELINE_NATIVE_H